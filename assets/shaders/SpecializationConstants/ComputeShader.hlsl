@@ -0,0 +1,18 @@
+[[vk::constant_id(0)]] const uint tile_size = 8;
+[[vk::constant_id(1)]] const bool use_scale = false;
+[[vk::constant_id(2)]] const float scale = 2.0;
+// Not settable through SpecializationConstant, reflection skips it.
+[[vk::constant_id(3)]] const double bias = 0.5;
+
+RWStructuredBuffer<float> buffer : register(u0, space0);
+
+[numthreads(64, 1, 1)]
+void main(uint thread_id : SV_DispatchThreadID)
+{
+    float value = buffer[thread_id] + tile_size;
+    if (use_scale) {
+        value *= scale;
+    }
+    value += (float)bias;
+    buffer[thread_id] = value;
+}
@@ -10,6 +10,10 @@ function(compile_shaders base_dir output_subdir shaders output_var)
         set(output_dir "${output_dir_pref}/${output_subdir}/")
     endif()
     set(gen_dir "${PROJECT_BINARY_DIR}/compiled_shaders/${output_subdir}/")
+    set(manifest "${gen_dir}/shaders.manifest")
+    set(depfile "${gen_dir}/shaders.d")
+    unset(manifest_content)
+    unset(copy_commands)
     unset(compiled_shaders)
     foreach(full_shader_path ${shaders})
         cmake_path(RELATIVE_PATH full_shader_path BASE_DIRECTORY "${base_dir}" OUTPUT_VARIABLE shader_name)
@@ -18,22 +22,36 @@ function(compile_shaders base_dir output_subdir shaders output_var)
         get_property(entrypoint SOURCE "${full_shader_path}" PROPERTY SHADER_ENTRYPOINT)
         get_property(type SOURCE "${full_shader_path}" PROPERTY SHADER_TYPE)
         get_property(model SOURCE "${full_shader_path}" PROPERTY SHADER_MODEL)
-        add_custom_command(OUTPUT "${spirv}" "${dxil}"
-            COMMAND ${CMAKE_COMMAND} -E make_directory "${gen_dir}"
-            COMMAND ${CMAKE_COMMAND} -E echo $<TARGET_FILE:ShaderCompilerCLI> ${shader_name} "${full_shader_path}" ${entrypoint} ${type} ${model} "${gen_dir}"
-            COMMAND $<TARGET_FILE:ShaderCompilerCLI> ${shader_name} "${full_shader_path}" ${entrypoint} ${type} ${model} "${gen_dir}"
-            COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
-            COMMAND ${CMAKE_COMMAND} -E copy "${spirv}" "${output_dir}/${shader_name}.spirv"
-            COMMAND ${CMAKE_COMMAND} -E copy "${dxil}" "${output_dir}/${shader_name}.dxil"
-            DEPENDS ShaderCompilerCLI "${full_shader_path}"
-            MAIN_DEPENDENCY "${full_shader_path}"
-        )
-        set_source_files_properties("${spirv}" "${dxil}" PROPERTIES
+        set(shader_blobs "${spirv}" "${dxil}")
+        set(manifest_line "\"${shader_name}\" \"${full_shader_path}\" \"${entrypoint}\" ${type} ${model}")
+        if (APPLE AND NOT USE_METAL_SHADER_CONVERTER AND NOT type STREQUAL "Library")
+            set(msl "${gen_dir}/${shader_name}.msl")
+            list(APPEND shader_blobs "${msl}")
+            string(APPEND manifest_line " targets=dxil,spirv,msl")
+        endif()
+        string(APPEND manifest_content "${manifest_line}\n")
+        foreach(shader_blob ${shader_blobs})
+            get_filename_component(shader_blob_ext "${shader_blob}" LAST_EXT)
+            list(APPEND copy_commands
+                COMMAND ${CMAKE_COMMAND} -E copy "${shader_blob}" "${output_dir}/${shader_name}${shader_blob_ext}"
+            )
+        endforeach()
+        set_source_files_properties(${shader_blobs} PROPERTIES
             MACOSX_PACKAGE_LOCATION "Resources/${output_subdir}"
         )
-        source_group("Shader Blobs" FILES "${spirv}" "${dxil}")
-        list(APPEND compiled_shaders "${spirv}" "${dxil}")
+        source_group("Shader Blobs" FILES ${shader_blobs})
+        list(APPEND compiled_shaders ${shader_blobs})
     endforeach()
+    file(GENERATE OUTPUT "${manifest}" CONTENT "${manifest_content}")
+    add_custom_command(OUTPUT ${compiled_shaders}
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${gen_dir}"
+        COMMAND $<TARGET_FILE:ShaderCompilerCLI> --manifest "${manifest}" --depfile "${depfile}" "${gen_dir}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        ${copy_commands}
+        DEPENDS ShaderCompilerCLI "${manifest}" ${shaders}
+        DEPFILE "${depfile}"
+        COMMENT "Compiling shaders for ${output_subdir}"
+    )
     source_group("Shader Files" FILES ${shaders})
     set(${output_var} ${${output_var}} ${compiled_shaders} PARENT_SCOPE)
 endfunction()
@@ -11,6 +11,10 @@ constexpr uint32_t kPositions = 0;
 constexpr uint32_t kTexcoords = 1;
 constexpr uint32_t kFrameCount = 3;
 
+const InternedName kConstantBufferName("constant_buffer");
+const InternedName kDepthBufferName("depth_buffer");
+const InternedName kStencilBufferName("stencil_buffer");
+
 glm::mat4 GetViewMatrix()
 {
     glm::vec3 eye = glm::vec3(0.0, 0.0, 3.5);
@@ -143,10 +147,10 @@ DepthStencilReadRenderer::DepthStencilReadRenderer(const Settings& settings)
     vertex_shader_ = device_->CreateShader(vertex_blob, blob_type, ShaderType::kVertex);
     pixel_shader_ = device_->CreateShader(pixel_blob, blob_type, ShaderType::kPixel);
 
-    BindKey vertex_constant_buffer_key = vertex_shader_->GetBindKey("constant_buffer");
-    BindKey pixel_constant_buffer_key = pixel_shader_->GetBindKey("constant_buffer");
-    BindKey pixel_depth_buffer_key = pixel_shader_->GetBindKey("depth_buffer");
-    BindKey pixel_stencil_buffer_key = pixel_shader_->GetBindKey("stencil_buffer");
+    BindKey vertex_constant_buffer_key = vertex_shader_->GetBindKey(kConstantBufferName);
+    BindKey pixel_constant_buffer_key = pixel_shader_->GetBindKey(kConstantBufferName);
+    BindKey pixel_depth_buffer_key = pixel_shader_->GetBindKey(kDepthBufferName);
+    BindKey pixel_stencil_buffer_key = pixel_shader_->GetBindKey(kStencilBufferName);
     layout_ = device_->CreateBindingSetLayout({ .bind_keys = { vertex_constant_buffer_key, pixel_constant_buffer_key,
                                                                pixel_depth_buffer_key, pixel_stencil_buffer_key } });
 
@@ -246,10 +250,10 @@ void DepthStencilReadRenderer::Init(const NativeSurface& surface, uint32_t width
     };
     pipeline_ = device_->CreateGraphicsPipeline(pipeline_desc);
 
-    BindKey vertex_constant_buffer_key = vertex_shader_->GetBindKey("constant_buffer");
-    BindKey pixel_constant_buffer_key = pixel_shader_->GetBindKey("constant_buffer");
-    BindKey pixel_depth_buffer_key = pixel_shader_->GetBindKey("depth_buffer");
-    BindKey pixel_stencil_buffer_key = pixel_shader_->GetBindKey("stencil_buffer");
+    BindKey vertex_constant_buffer_key = vertex_shader_->GetBindKey(kConstantBufferName);
+    BindKey pixel_constant_buffer_key = pixel_shader_->GetBindKey(kConstantBufferName);
+    BindKey pixel_depth_buffer_key = pixel_shader_->GetBindKey(kDepthBufferName);
+    BindKey pixel_stencil_buffer_key = pixel_shader_->GetBindKey(kStencilBufferName);
 
     binding_set_ = device_->CreateBindingSet(layout_);
     binding_set_->WriteBindings({ .bindings = { { vertex_constant_buffer_key, vertex_constant_buffer_view_ },
@@ -11,6 +11,9 @@ namespace {
 constexpr uint32_t kFrameCount = 3;
 constexpr uint32_t kNumThreads = 8;
 
+const InternedName kConstantBufferName("constant_buffer");
+const InternedName kResultTextureName("result_texture");
+
 } // namespace
 
 class DispatchIndirectRenderer : public AppRenderer {
@@ -79,8 +82,8 @@ DispatchIndirectRenderer::DispatchIndirectRenderer(const Settings& settings)
     std::vector<uint8_t> compute_blob = AssetLoadShaderBlob("assets/DispatchIndirect/ComputeShader.hlsl", blob_type);
     compute_shader_ = device_->CreateShader(compute_blob, blob_type, ShaderType::kCompute);
 
-    BindKey constant_buffer_key = compute_shader_->GetBindKey("constant_buffer");
-    BindKey result_texture_key = compute_shader_->GetBindKey("result_texture");
+    BindKey constant_buffer_key = compute_shader_->GetBindKey(kConstantBufferName);
+    BindKey result_texture_key = compute_shader_->GetBindKey(kResultTextureName);
     layout_ = device_->CreateBindingSetLayout({ .bind_keys = { constant_buffer_key, result_texture_key } });
 
     ComputePipelineDesc pipeline_desc = {
@@ -123,8 +126,8 @@ void DispatchIndirectRenderer::Init(const NativeSurface& surface, uint32_t width
                                               (result_texture_size_.y + kNumThreads - 1) / kNumThreads, 1 };
     buffer_->UpdateUploadBuffer(constant_buffer_stride_ * kFrameCount, &argument_data, sizeof(argument_data));
 
-    BindKey constant_buffer_key = compute_shader_->GetBindKey("constant_buffer");
-    BindKey result_texture_key = compute_shader_->GetBindKey("result_texture");
+    BindKey constant_buffer_key = compute_shader_->GetBindKey(kConstantBufferName);
+    BindKey result_texture_key = compute_shader_->GetBindKey(kResultTextureName);
     for (uint32_t i = 0; i < kFrameCount; ++i) {
         binding_set_[i] = device_->CreateBindingSet(layout_);
         binding_set_[i]->WriteBindings({ .bindings = { { constant_buffer_key, constant_buffer_views_[i] },
@@ -14,6 +14,9 @@ namespace {
 constexpr uint32_t kFrameCount = 3;
 constexpr uint32_t kNumRayQueryThreads = 8;
 
+const InternedName kGeometryName("geometry");
+const InternedName kResultTextureName("result_texture");
+
 enum class RayTracingMode {
     kAuto,
     kForceRayTracing,
@@ -309,16 +312,16 @@ void RayTracingTriangleRenderer::InitAccelerationStructures()
 void RayTracingTriangleRenderer::InitBindingSetLayout()
 {
     const auto& shader = use_ray_tracing_ ? library_ : compute_shader_;
-    BindKey geometry_key = shader->GetBindKey("geometry");
-    BindKey result_texture_key = shader->GetBindKey("result_texture");
+    BindKey geometry_key = shader->GetBindKey(kGeometryName);
+    BindKey result_texture_key = shader->GetBindKey(kResultTextureName);
     layout_ = device_->CreateBindingSetLayout({ .bind_keys = { geometry_key, result_texture_key } });
 }
 
 void RayTracingTriangleRenderer::InitBindingSet()
 {
     const auto& shader = use_ray_tracing_ ? library_ : compute_shader_;
-    BindKey geometry_key = shader->GetBindKey("geometry");
-    BindKey result_texture_key = shader->GetBindKey("result_texture");
+    BindKey geometry_key = shader->GetBindKey(kGeometryName);
+    BindKey result_texture_key = shader->GetBindKey(kResultTextureName);
     binding_set_ = device_->CreateBindingSet(layout_);
     binding_set_->WriteBindings(
         { .bindings = { { geometry_key, tlas_view_ }, { result_texture_key, result_texture_view_ } } });
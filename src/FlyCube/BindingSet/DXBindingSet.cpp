@@ -4,6 +4,7 @@
 #include "Device/DXDevice.h"
 #include "GPUDescriptorPool/DXGPUDescriptorPoolRange.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Trace.h"
 #include "View/DXView.h"
 
 namespace {
@@ -59,6 +60,7 @@ DXBindingSet::DXBindingSet(DXDevice& device, const std::shared_ptr<DXBindingSetL
 
 void DXBindingSet::WriteBindings(const WriteBindingsDesc& desc)
 {
+    TRACE_SCOPE("DXBindingSet::WriteBindings");
     for (const auto& binding : desc.bindings) {
         WriteDescriptor(binding);
     }
@@ -7,6 +7,7 @@
 #include "Utilities/Cast.h"
 #include "Utilities/Check.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/Trace.h"
 #include "View/MTView.h"
 
 #if defined(USE_METAL_SHADER_CONVERTER)
@@ -52,6 +53,7 @@ MTBindingSet::MTBindingSet(MTDevice& device, const std::shared_ptr<MTBindingSetL
 
 void MTBindingSet::WriteBindings(const WriteBindingsDesc& desc)
 {
+    TRACE_SCOPE("MTBindingSet::WriteBindings");
 #if defined(USE_METAL_SHADER_CONVERTER)
     uint8_t* argument_buffer_data = static_cast<uint8_t*>(argument_buffer_.contents);
     for (const auto& [bind_key, view] : desc.bindings) {
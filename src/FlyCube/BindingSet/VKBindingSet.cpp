@@ -3,6 +3,7 @@
 #include "BindingSetLayout/VKBindingSetLayout.h"
 #include "Device/VKDevice.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Trace.h"
 #include "View/VKView.h"
 
 #include <deque>
@@ -19,7 +20,7 @@ VKBindingSet::VKBindingSet(VKDevice& device, const std::shared_ptr<VKBindingSetL
             descriptor_sets_.emplace_back(device_.GetGPUBindlessDescriptorPool(bindless_type.at(i)).GetDescriptorSet());
         } else {
             descriptors_.emplace_back(device_.GetGPUDescriptorPool().AllocateDescriptorSet(
-                descriptor_set_layouts[i].get(), allocate_descriptor_set_descs[i]));
+                descriptor_set_layouts[i], allocate_descriptor_set_descs[i]));
             descriptor_sets_.emplace_back(descriptors_.back().set);
         }
     }
@@ -37,6 +38,7 @@ VKBindingSet::VKBindingSet(VKDevice& device, const std::shared_ptr<VKBindingSetL
 
 void VKBindingSet::WriteBindings(const WriteBindingsDesc& desc)
 {
+    TRACE_SCOPE("VKBindingSet::WriteBindings");
     std::vector<vk::WriteDescriptorSet> descriptors;
     for (const auto& binding : desc.bindings) {
         WriteDescriptor(descriptors, binding);
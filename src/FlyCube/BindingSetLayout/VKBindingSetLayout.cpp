@@ -119,23 +119,15 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
         bindings_flags_by_set[bind_key.space].emplace_back();
     }
 
+    VKLayoutCache& layout_cache = device.GetLayoutCache();
     for (const auto& [set, bindings] : bindings_by_set) {
-        vk::DescriptorSetLayoutCreateInfo layout_info = {};
-        layout_info.bindingCount = bindings.size();
-        layout_info.pBindings = bindings.data();
-
-        vk::DescriptorSetLayoutBindingFlagsCreateInfo layout_flags_info = {};
-        layout_flags_info.bindingCount = bindings_flags_by_set[set].size();
-        layout_flags_info.pBindingFlags = bindings_flags_by_set[set].data();
-        layout_info.pNext = &layout_flags_info;
-
         if (descriptor_set_layouts_.size() <= set) {
             descriptor_set_layouts_.resize(set + 1);
             allocate_descriptor_set_descs_.resize(set + 1);
         }
 
-        auto& descriptor_set_layout = descriptor_set_layouts_[set];
-        descriptor_set_layout = device.GetDevice().createDescriptorSetLayoutUnique(layout_info);
+        descriptor_set_layouts_[set] =
+            layout_cache.GetOrCreateDescriptorSetLayout(bindings, bindings_flags_by_set[set]);
 
         auto& allocate_descriptor_set_desc = allocate_descriptor_set_descs_[set];
         for (const auto& binding : bindings) {
@@ -146,21 +138,13 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
         }
     }
 
-    std::vector<vk::DescriptorSetLayout> descriptor_set_layouts;
     for (auto& descriptor_set_layout : descriptor_set_layouts_) {
         if (!descriptor_set_layout) {
-            vk::DescriptorSetLayoutCreateInfo layout_info = {};
-            descriptor_set_layout = device.GetDevice().createDescriptorSetLayoutUnique(layout_info);
+            descriptor_set_layout = layout_cache.GetOrCreateDescriptorSetLayout({}, {});
         }
-
-        descriptor_set_layouts.emplace_back(descriptor_set_layout.get());
     }
 
-    vk::PipelineLayoutCreateInfo pipeline_layout_info = {};
-    pipeline_layout_info.setLayoutCount = descriptor_set_layouts.size();
-    pipeline_layout_info.pSetLayouts = descriptor_set_layouts.data();
-
-    pipeline_layout_ = device.GetDevice().createPipelineLayoutUnique(pipeline_layout_info);
+    pipeline_layout_ = layout_cache.GetOrCreatePipelineLayout(descriptor_set_layouts_);
 }
 
 const std::map<uint32_t, vk::DescriptorType>& VKBindingSetLayout::GetBindlessType() const
@@ -168,7 +152,7 @@ const std::map<uint32_t, vk::DescriptorType>& VKBindingSetLayout::GetBindlessTyp
     return bindless_type_;
 }
 
-const std::vector<vk::UniqueDescriptorSetLayout>& VKBindingSetLayout::GetDescriptorSetLayouts() const
+const std::vector<vk::DescriptorSetLayout>& VKBindingSetLayout::GetDescriptorSetLayouts() const
 {
     return descriptor_set_layouts_;
 }
@@ -190,5 +174,5 @@ const std::vector<BindingConstants>& VKBindingSetLayout::GetFallbackConstants()
 
 vk::PipelineLayout VKBindingSetLayout::GetPipelineLayout() const
 {
-    return pipeline_layout_.get();
+    return pipeline_layout_;
 }
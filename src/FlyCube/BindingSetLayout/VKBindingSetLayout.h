@@ -19,7 +19,7 @@ public:
     VKBindingSetLayout(VKDevice& device, const BindingSetLayoutDesc& desc);
 
     const std::map<uint32_t, vk::DescriptorType>& GetBindlessType() const;
-    const std::vector<vk::UniqueDescriptorSetLayout>& GetDescriptorSetLayouts() const;
+    const std::vector<vk::DescriptorSetLayout>& GetDescriptorSetLayouts() const;
     const std::vector<AllocateDescriptorSetDesc>& GetAllocateDescriptorSetDescs() const;
     const std::set<BindKey>& GetInlineUniformBlocks() const;
     const std::vector<BindingConstants>& GetFallbackConstants() const;
@@ -27,11 +27,12 @@ public:
 
 private:
     std::map<uint32_t, vk::DescriptorType> bindless_type_;
-    std::vector<vk::UniqueDescriptorSetLayout> descriptor_set_layouts_;
+    // Owned by the layout cache of the device.
+    std::vector<vk::DescriptorSetLayout> descriptor_set_layouts_;
     std::vector<AllocateDescriptorSetDesc> allocate_descriptor_set_descs_;
     std::set<BindKey> inline_uniform_blocks_;
     std::vector<BindingConstants> fallback_constants_;
-    vk::UniquePipelineLayout pipeline_layout_;
+    vk::PipelineLayout pipeline_layout_;
 };
 
 vk::DescriptorType GetDescriptorType(ViewType view_type);
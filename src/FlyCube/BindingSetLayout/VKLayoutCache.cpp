@@ -0,0 +1,73 @@
+#include "BindingSetLayout/VKLayoutCache.h"
+
+#include "Device/VKDevice.h"
+#include "Utilities/BinaryStream.h"
+
+#include <cassert>
+
+namespace {
+
+std::string GetKey(const BinaryWriter& writer)
+{
+    decltype(auto) data = writer.GetData();
+    return std::string(data.begin(), data.end());
+}
+
+} // namespace
+
+VKLayoutCache::VKLayoutCache(VKDevice& device)
+    : device_(device)
+{
+}
+
+vk::DescriptorSetLayout VKLayoutCache::GetOrCreateDescriptorSetLayout(
+    std::span<const vk::DescriptorSetLayoutBinding> bindings,
+    std::span<const vk::DescriptorBindingFlags> binding_flags)
+{
+    assert(bindings.size() == binding_flags.size());
+    BinaryWriter writer;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        assert(!bindings[i].pImmutableSamplers);
+        writer.Write(bindings[i].binding);
+        writer.Write(bindings[i].descriptorType);
+        writer.Write(bindings[i].descriptorCount);
+        writer.Write(static_cast<VkShaderStageFlags>(bindings[i].stageFlags));
+        writer.Write(static_cast<VkDescriptorBindingFlags>(binding_flags[i]));
+    }
+
+    std::lock_guard lock(mutex_);
+    auto& descriptor_set_layout = descriptor_set_layouts_[GetKey(writer)];
+    if (!descriptor_set_layout) {
+        vk::DescriptorSetLayoutCreateInfo layout_info = {};
+        layout_info.bindingCount = bindings.size();
+        layout_info.pBindings = bindings.data();
+
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo layout_flags_info = {};
+        layout_flags_info.bindingCount = binding_flags.size();
+        layout_flags_info.pBindingFlags = binding_flags.data();
+        layout_info.pNext = &layout_flags_info;
+
+        descriptor_set_layout = device_.GetDevice().createDescriptorSetLayoutUnique(layout_info);
+    }
+    return descriptor_set_layout.get();
+}
+
+vk::PipelineLayout VKLayoutCache::GetOrCreatePipelineLayout(
+    std::span<const vk::DescriptorSetLayout> descriptor_set_layouts)
+{
+    // Descriptor set layouts are interned as well, so their handles identify the content.
+    BinaryWriter writer;
+    for (const auto& descriptor_set_layout : descriptor_set_layouts) {
+        writer.Write(static_cast<VkDescriptorSetLayout>(descriptor_set_layout));
+    }
+
+    std::lock_guard lock(mutex_);
+    auto& pipeline_layout = pipeline_layouts_[GetKey(writer)];
+    if (!pipeline_layout) {
+        vk::PipelineLayoutCreateInfo pipeline_layout_info = {};
+        pipeline_layout_info.setLayoutCount = descriptor_set_layouts.size();
+        pipeline_layout_info.pSetLayouts = descriptor_set_layouts.data();
+        pipeline_layout = device_.GetDevice().createPipelineLayoutUnique(pipeline_layout_info);
+    }
+    return pipeline_layout.get();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+class VKDevice;
+
+// Interns descriptor set layouts and pipeline layouts by content for the lifetime of the device. Equal binding set
+// layouts therefore share Vulkan objects and stay compatible across pipelines.
+class VKLayoutCache {
+public:
+    explicit VKLayoutCache(VKDevice& device);
+
+    vk::DescriptorSetLayout GetOrCreateDescriptorSetLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings,
+                                                           std::span<const vk::DescriptorBindingFlags> binding_flags);
+    vk::PipelineLayout GetOrCreatePipelineLayout(std::span<const vk::DescriptorSetLayout> descriptor_set_layouts);
+
+private:
+    VKDevice& device_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, vk::UniqueDescriptorSetLayout> descriptor_set_layouts_;
+    std::unordered_map<std::string, vk::UniquePipelineLayout> pipeline_layouts_;
+};
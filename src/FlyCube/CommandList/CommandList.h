@@ -1,6 +1,7 @@
 #pragma once
 #include "BindingSet/BindingSet.h"
 #include "Instance/BaseTypes.h"
+#include "Pipeline/AsyncPipeline.h"
 #include "Pipeline/Pipeline.h"
 #include "QueryHeap/QueryHeap.h"
 #include "Resource/Resource.h"
@@ -11,12 +12,15 @@
 #include <array>
 #include <memory>
 
+class GPUProfiler;
+
 class CommandList {
 public:
     virtual ~CommandList() = default;
     virtual void Reset() = 0;
     virtual void Close() = 0;
     virtual void BindPipeline(const std::shared_ptr<Pipeline>& pipeline) = 0;
+    virtual bool BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode) = 0;
     virtual void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) = 0;
     virtual void BeginRenderPass(const RenderPassDesc& render_pass_desc) = 0;
     virtual void EndRenderPass() = 0;
@@ -68,6 +72,11 @@ public:
     virtual void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) = 0;
     virtual void SetStencilReference(uint32_t stencil_reference) = 0;
     virtual void SetBlendConstants(float red, float green, float blue, float alpha) = 0;
+    virtual void SetPrimitiveTopology(PrimitiveTopology topology) = 0;
+    virtual void SetCullMode(CullMode cull_mode) = 0;
+    virtual void SetFrontFace(FrontFace front_face) = 0;
+    virtual void SetDepthStencilState(const DepthStencilDesc& desc) = 0;
+    virtual void SetBlendState(const BlendDesc& desc) = 0;
     virtual void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                     const std::shared_ptr<Resource>& dst,
                                     const std::shared_ptr<Resource>& scratch,
@@ -106,5 +115,11 @@ public:
                                   uint32_t query_count,
                                   const std::shared_ptr<Resource>& dst_buffer,
                                   uint64_t dst_offset) = 0;
+    virtual void WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) = 0;
+    virtual void BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) = 0;
+    virtual void EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) = 0;
+    virtual void BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset) = 0;
+    virtual void EndConditionalRendering() = 0;
+    virtual void SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler) = 0;
     virtual void SetName(const std::string& name) = 0;
 };
@@ -5,9 +5,12 @@
 #include "Pipeline/DXComputePipeline.h"
 #include "Pipeline/DXGraphicsPipeline.h"
 #include "Pipeline/DXRayTracingPipeline.h"
+#include "Profiler/GPUProfiler.h"
+#include "QueryHeap/DXQueryHeap.h"
 #include "QueryHeap/DXRayTracingQueryHeap.h"
 #include "Resource/DXResource.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/DXUtility.h"
 #include "Utilities/NotReached.h"
 #include "View/DXView.h"
@@ -109,6 +112,7 @@ void DXCommandList::Close()
 
 void DXCommandList::BindPipeline(const std::shared_ptr<Pipeline>& pipeline)
 {
+    state_->pipeline_pending = false;
     if (pipeline == state_->pipeline) {
         return;
     }
@@ -117,7 +121,16 @@ void DXCommandList::BindPipeline(const std::shared_ptr<Pipeline>& pipeline)
     auto type = state_->pipeline->GetPipelineType();
     if (type == PipelineType::kGraphics) {
         auto* dx_pipeline = CastToImpl<DXGraphicsPipeline>(state_->pipeline);
-        command_list_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        decltype(auto) desc = dx_pipeline->GetDesc();
+        PrimitiveTopology topology = desc.topology;
+        if (desc.dynamic_states & DynamicStateFlags::kPrimitiveTopology) {
+            // The pipeline may be shared by descs with other topologies of the same class, see PipelineDescCache.
+            topology =
+                state_->primitive_topology.value_or(GetDefaultPrimitiveTopology(GetPrimitiveTopologyClass(topology)));
+            CHECK(GetPrimitiveTopologyClass(topology) == GetPrimitiveTopologyClass(desc.topology),
+                  "Topology {} does not match the topology class of the pipeline", static_cast<int>(topology));
+        }
+        command_list_->IASetPrimitiveTopology(ConvertPrimitiveTopology(topology));
         command_list_->SetGraphicsRootSignature(dx_pipeline->GetRootSignature().Get());
         command_list_->SetPipelineState(dx_pipeline->GetPipeline().Get());
         for (const auto& [slot, stride] : dx_pipeline->GetStrideMap()) {
@@ -138,6 +151,21 @@ void DXCommandList::BindPipeline(const std::shared_ptr<Pipeline>& pipeline)
     }
 }
 
+bool DXCommandList::BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode)
+{
+    if (mode == AsyncPipelineBindMode::kSkipIfNotReady && !pipeline->IsReady()) {
+        SetPipelinePending();
+        return false;
+    }
+    BindPipeline(pipeline->Wait());
+    return true;
+}
+
+void DXCommandList::SetPipelinePending()
+{
+    state_->pipeline_pending = true;
+}
+
 void DXCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_set)
 {
     if (binding_set == state_->binding_set) {
@@ -218,10 +246,16 @@ void DXCommandList::BeginEvent(const std::string& name)
         PIXBeginEvent(command_list_.Get(), 0, nowide::widen(name).c_str());
     }
 #endif
+    if (profiler_) {
+        profiler_->OnBeginEvent(*this, name);
+    }
 }
 
 void DXCommandList::EndEvent()
 {
+    if (profiler_) {
+        profiler_->OnEndEvent(*this);
+    }
 #if defined(_WIN32)
     if (device_.IsUnderGraphicsDebugger()) {
         PIXEndEvent(command_list_.Get());
@@ -231,6 +265,9 @@ void DXCommandList::EndEvent()
 
 void DXCommandList::Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->DrawInstanced(vertex_count, instance_count, first_vertex, first_instance);
 }
 
@@ -240,6 +277,9 @@ void DXCommandList::DrawIndexed(uint32_t index_count,
                                 int32_t vertex_offset,
                                 uint32_t first_instance)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->DrawIndexedInstanced(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
@@ -281,6 +321,9 @@ void DXCommandList::DrawIndirectCount(const std::shared_ptr<Resource>& argument_
                                       uint32_t max_draw_count,
                                       uint32_t stride)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, argument_buffer, argument_buffer_offset, count_buffer,
                     count_buffer_offset, max_draw_count, stride);
 }
@@ -292,6 +335,9 @@ void DXCommandList::DrawIndexedIndirectCount(const std::shared_ptr<Resource>& ar
                                              uint32_t max_draw_count,
                                              uint32_t stride)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, argument_buffer, argument_buffer_offset, count_buffer,
                     count_buffer_offset, max_draw_count, stride);
 }
@@ -300,11 +346,17 @@ void DXCommandList::Dispatch(uint32_t thread_group_count_x,
                              uint32_t thread_group_count_y,
                              uint32_t thread_group_count_z)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->Dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
 void DXCommandList::DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH, argument_buffer, argument_buffer_offset, {}, 0, 1,
                     sizeof(DispatchIndirectCommand));
 }
@@ -313,6 +365,9 @@ void DXCommandList::DispatchMesh(uint32_t thread_group_count_x,
                                  uint32_t thread_group_count_y,
                                  uint32_t thread_group_count_z)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list6_->DispatchMesh(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
@@ -488,6 +543,29 @@ void DXCommandList::SetBlendConstants(float red, float green, float blue, float
     command_list_->OMSetBlendFactor(blend_constants.data());
 }
 
+void DXCommandList::SetPrimitiveTopology(PrimitiveTopology topology)
+{
+    state_->primitive_topology = topology;
+    if (!state_->pipeline || state_->pipeline->GetPipelineType() != PipelineType::kGraphics) {
+        return;
+    }
+    decltype(auto) desc = CastToImpl<DXGraphicsPipeline>(state_->pipeline)->GetDesc();
+    if (desc.dynamic_states & DynamicStateFlags::kPrimitiveTopology) {
+        CHECK(GetPrimitiveTopologyClass(topology) == GetPrimitiveTopologyClass(desc.topology),
+              "Topology {} does not match the topology class of the pipeline", static_cast<int>(topology));
+        command_list_->IASetPrimitiveTopology(ConvertPrimitiveTopology(topology));
+    }
+}
+
+// The remaining states are baked into the pipeline state object, see DXDevice::GetSupportedDynamicStates().
+void DXCommandList::SetCullMode(CullMode cull_mode) {}
+
+void DXCommandList::SetFrontFace(FrontFace front_face) {}
+
+void DXCommandList::SetDepthStencilState(const DepthStencilDesc& desc) {}
+
+void DXCommandList::SetBlendState(const BlendDesc& desc) {}
+
 void DXCommandList::BuildAccelerationStructure(D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS& inputs,
                                                const std::shared_ptr<Resource>& src,
                                                const std::shared_ptr<Resource>& dst,
@@ -697,7 +775,14 @@ void DXCommandList::ResolveQueryData(const std::shared_ptr<QueryHeap>& query_hea
                                      const std::shared_ptr<Resource>& dst_buffer,
                                      uint64_t dst_offset)
 {
-    assert(query_heap->GetType() == QueryHeapType::kAccelerationStructureCompactedSize);
+    if (query_heap->GetType() != QueryHeapType::kAccelerationStructureCompactedSize) {
+        auto* dx_query_heap = CastToImpl<DXQueryHeap>(query_heap);
+        command_list_->ResolveQueryData(dx_query_heap->GetQueryHeap().Get(), dx_query_heap->GetQueryType(),
+                                        first_query, query_count, CastToImpl<DXResource>(dst_buffer)->GetResource(),
+                                        dst_offset);
+        return;
+    }
+
     auto* dx_query_heap = CastToImpl<DXRayTracingQueryHeap>(query_heap);
     auto* dx_dst_buffer = CastToImpl<DXResource>(dst_buffer);
     auto common_to_copy_barrier = CD3DX12_RESOURCE_BARRIER::Transition(
@@ -710,6 +795,41 @@ void DXCommandList::ResolveQueryData(const std::shared_ptr<QueryHeap>& query_hea
     command_list_->ResourceBarrier(1, &copy_to_common_barrier);
 }
 
+void DXCommandList::WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    assert(query_heap->GetType() == QueryHeapType::kTimestamp);
+    auto* dx_query_heap = CastToImpl<DXQueryHeap>(query_heap);
+    command_list_->EndQuery(dx_query_heap->GetQueryHeap().Get(), D3D12_QUERY_TYPE_TIMESTAMP, index);
+}
+
+void DXCommandList::BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    auto* dx_query_heap = CastToImpl<DXQueryHeap>(query_heap);
+    command_list_->BeginQuery(dx_query_heap->GetQueryHeap().Get(), dx_query_heap->GetQueryType(), index);
+}
+
+void DXCommandList::EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    auto* dx_query_heap = CastToImpl<DXQueryHeap>(query_heap);
+    command_list_->EndQuery(dx_query_heap->GetQueryHeap().Get(), dx_query_heap->GetQueryType(), index);
+}
+
+void DXCommandList::BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset)
+{
+    command_list_->SetPredication(CastToImpl<DXResource>(predicate_buffer)->GetResource(), offset,
+                                  D3D12_PREDICATION_OP_EQUAL_ZERO);
+}
+
+void DXCommandList::EndConditionalRendering()
+{
+    command_list_->SetPredication(nullptr, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+}
+
+void DXCommandList::SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler)
+{
+    profiler_ = profiler;
+}
+
 ComPtr<ID3D12GraphicsCommandList> DXCommandList::GetCommandList()
 {
     return command_list_;
@@ -9,6 +9,8 @@
 
 #include <directx/d3d12.h>
 
+#include <optional>
+
 using Microsoft::WRL::ComPtr;
 
 class DXDevice;
@@ -21,6 +23,9 @@ public:
     void Reset() override;
     void Close() override;
     void BindPipeline(const std::shared_ptr<Pipeline>& pipeline) override;
+    bool BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode) override;
+    // Skips draws and dispatches until the next pipeline bind, as a not ready kSkipIfNotReady bind does.
+    void SetPipelinePending();
     void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override;
     void BeginRenderPass(const RenderPassDesc& render_pass_desc) override;
     void EndRenderPass() override;
@@ -66,6 +71,11 @@ public:
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override;
     void SetStencilReference(uint32_t stencil_reference) override;
     void SetBlendConstants(float red, float green, float blue, float alpha) override;
+    void SetPrimitiveTopology(PrimitiveTopology topology) override;
+    void SetCullMode(CullMode cull_mode) override;
+    void SetFrontFace(FrontFace front_face) override;
+    void SetDepthStencilState(const DepthStencilDesc& desc) override;
+    void SetBlendState(const BlendDesc& desc) override;
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -103,7 +113,12 @@ public:
                           uint32_t query_count,
                           const std::shared_ptr<Resource>& dst_buffer,
                           uint64_t dst_offset) override;
-
+    void WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset) override;
+    void EndConditionalRendering() override;
+    void SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler) override;
     void SetName(const std::string& name) override;
 
     ComPtr<ID3D12GraphicsCommandList> GetCommandList();
@@ -138,12 +153,16 @@ private:
     ComPtr<ID3D12GraphicsCommandList5> command_list5_;
     ComPtr<ID3D12GraphicsCommandList6> command_list6_;
     std::vector<ComPtr<ID3D12DescriptorHeap>> heaps_;
+    std::shared_ptr<GPUProfiler> profiler_;
 
     struct State {
         std::shared_ptr<DXPipeline> pipeline;
         std::shared_ptr<BindingSet> binding_set;
         std::map<uint32_t, std::pair<std::shared_ptr<Resource>, uint64_t>> lazy_vertex;
         std::shared_ptr<View> shading_rate_image_view;
+        std::optional<PrimitiveTopology> primitive_topology;
+
+        bool pipeline_pending = false;
     };
 
     std::unique_ptr<State> state_;
@@ -17,6 +17,9 @@ public:
     void Reset() override;
     void Close() override;
     void BindPipeline(const std::shared_ptr<Pipeline>& pipeline) override;
+    bool BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode) override;
+    // Skips draws and dispatches until the next pipeline bind, as a not ready kSkipIfNotReady bind does.
+    void SetPipelinePending();
     void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override;
     void BeginRenderPass(const RenderPassDesc& render_pass_desc) override;
     void EndRenderPass() override;
@@ -62,6 +65,11 @@ public:
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override;
     void SetStencilReference(uint32_t stencil_reference) override;
     void SetBlendConstants(float red, float green, float blue, float alpha) override;
+    void SetPrimitiveTopology(PrimitiveTopology topology) override;
+    void SetCullMode(CullMode cull_mode) override;
+    void SetFrontFace(FrontFace front_face) override;
+    void SetDepthStencilState(const DepthStencilDesc& desc) override;
+    void SetBlendState(const BlendDesc& desc) override;
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -99,6 +107,12 @@ public:
                           uint32_t query_count,
                           const std::shared_ptr<Resource>& dst_buffer,
                           uint64_t dst_offset) override;
+    void WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset) override;
+    void EndConditionalRendering() override;
+    void SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler) override;
     void SetName(const std::string& name) override;
 
     id<MTL4CommandBuffer> GetCommandBuffer();
@@ -113,6 +127,7 @@ private:
                                     uint32_t instance_count);
     void ApplyComputeState();
     void ApplyGraphicsState();
+    MTLPrimitiveType GetPrimitiveType() const;
     void AddGraphicsBarriers();
     void AddComputeBarriers();
     void CreateArgumentTables();
@@ -124,6 +139,7 @@ private:
     id<MTL4CommandAllocator> allocator_ = nullptr;
     id<MTL4CommandBuffer> command_buffer_ = nullptr;
     std::vector<id<MTLBuffer>> patch_buffers_;
+    std::shared_ptr<GPUProfiler> profiler_;
 
     static constexpr MTLStages kRenderStages = MTLStageVertex | MTLStageObject | MTLStageMesh | MTLStageFragment;
     static constexpr MTLStages kComputeStages = MTLStageDispatch | MTLStageBlit | MTLStageAccelerationStructure;
@@ -140,12 +156,16 @@ private:
         float max_depth_bounds = 1.0;
         uint32_t stencil_reference = 0;
         std::optional<std::array<float, 4>> blend_constants;
+        std::optional<PrimitiveTopology> primitive_topology;
+        std::optional<CullMode> cull_mode;
+        std::optional<FrontFace> front_face;
         std::shared_ptr<Pipeline> pipeline;
         std::shared_ptr<MTBindingSet> binding_set;
         std::map<ShaderType, id<MTL4ArgumentTable>> argument_tables;
         id<MTLResidencySet> residency_set = nullptr;
         bool need_apply_pipeline = false;
         bool need_apply_binding_set = false;
+        bool pipeline_pending = false;
         MTLStages render_barrier_after_stages = MTLStageAll;
         MTLStages render_barrier_before_stages = kRenderStages;
         MTLStages compute_barrier_after_stages = MTLStageAll;
@@ -4,9 +4,11 @@
 #include "Device/MTDevice.h"
 #include "Pipeline/MTComputePipeline.h"
 #include "Pipeline/MTGraphicsPipeline.h"
+#include "Profiler/GPUProfiler.h"
 #include "QueryHeap/MTQueryHeap.h"
 #include "Resource/MTResource.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 #include "View/MTView.h"
@@ -187,11 +189,27 @@ void MTCommandList::Close()
 
 void MTCommandList::BindPipeline(const std::shared_ptr<Pipeline>& pipeline)
 {
+    state_->pipeline_pending = false;
     state_->pipeline = pipeline;
     state_->need_apply_pipeline = true;
     state_->need_apply_binding_set = true;
 }
 
+bool MTCommandList::BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode)
+{
+    if (mode == AsyncPipelineBindMode::kSkipIfNotReady && !pipeline->IsReady()) {
+        SetPipelinePending();
+        return false;
+    }
+    BindPipeline(pipeline->Wait());
+    return true;
+}
+
+void MTCommandList::SetPipelinePending()
+{
+    state_->pipeline_pending = true;
+}
+
 void MTCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_set)
 {
     state_->binding_set = std::static_pointer_cast<MTBindingSet>(binding_set);
@@ -290,14 +308,27 @@ void MTCommandList::EndRenderPass()
     state_->render_encoder = nullptr;
 }
 
-void MTCommandList::BeginEvent(const std::string& name) {}
+void MTCommandList::BeginEvent(const std::string& name)
+{
+    if (profiler_) {
+        profiler_->OnBeginEvent(*this, name);
+    }
+}
 
-void MTCommandList::EndEvent() {}
+void MTCommandList::EndEvent()
+{
+    if (profiler_) {
+        profiler_->OnEndEvent(*this);
+    }
+}
 
 void MTCommandList::Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ApplyGraphicsState();
-    [state_->render_encoder drawPrimitives:MTLPrimitiveTypeTriangle
+    [state_->render_encoder drawPrimitives:GetPrimitiveType()
                                vertexStart:first_vertex
                                vertexCount:vertex_count
                              instanceCount:instance_count
@@ -310,11 +341,14 @@ void MTCommandList::DrawIndexed(uint32_t index_count,
                                 int32_t vertex_offset,
                                 uint32_t first_instance)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ApplyGraphicsState();
     MTLIndexType index_format = ConvertIndexType(state_->index_format);
     const uint32_t index_stride = index_format == MTLIndexTypeUInt32 ? 4 : 2;
     [state_->render_encoder
-        drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+        drawIndexedPrimitives:GetPrimitiveType()
                    indexCount:index_count
                     indexType:index_format
                   indexBuffer:state_->index_buffer.gpuAddress + state_->index_buffer_offset + index_stride * first_index
@@ -326,21 +360,27 @@ void MTCommandList::DrawIndexed(uint32_t index_count,
 
 void MTCommandList::DrawIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ApplyGraphicsState();
     id<MTLBuffer> mt_argument_buffer = CastToImpl<MTResource>(argument_buffer)->GetBuffer();
     AddAllocation(mt_argument_buffer);
-    [state_->render_encoder drawPrimitives:MTLPrimitiveTypeTriangle
+    [state_->render_encoder drawPrimitives:GetPrimitiveType()
                             indirectBuffer:mt_argument_buffer.gpuAddress + argument_buffer_offset];
 }
 
 void MTCommandList::DrawIndexedIndirect(const std::shared_ptr<Resource>& argument_buffer,
                                         uint64_t argument_buffer_offset)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ApplyGraphicsState();
     id<MTLBuffer> mt_argument_buffer = CastToImpl<MTResource>(argument_buffer)->GetBuffer();
     AddAllocation(mt_argument_buffer);
     MTLIndexType index_format = ConvertIndexType(state_->index_format);
-    [state_->render_encoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+    [state_->render_encoder drawIndexedPrimitives:GetPrimitiveType()
                                         indexType:index_format
                                       indexBuffer:state_->index_buffer.gpuAddress + state_->index_buffer_offset
                                 indexBufferLength:state_->index_buffer.length - state_->index_buffer_offset
@@ -371,6 +411,9 @@ void MTCommandList::Dispatch(uint32_t thread_group_count_x,
                              uint32_t thread_group_count_y,
                              uint32_t thread_group_count_z)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     auto* mt_pipeline = CastToImpl<MTComputePipeline>(state_->pipeline);
     MTLSize threadgroups_per_grid = { thread_group_count_x, thread_group_count_y, thread_group_count_z };
 
@@ -383,6 +426,9 @@ void MTCommandList::Dispatch(uint32_t thread_group_count_x,
 
 void MTCommandList::DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     id<MTLBuffer> mt_argument_buffer = CastToImpl<MTResource>(argument_buffer)->GetBuffer();
     auto* mt_pipeline = CastToImpl<MTComputePipeline>(state_->pipeline);
     AddAllocation(mt_argument_buffer);
@@ -399,6 +445,9 @@ void MTCommandList::DispatchMesh(uint32_t thread_group_count_x,
                                  uint32_t thread_group_count_y,
                                  uint32_t thread_group_count_z)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     ApplyGraphicsState();
     auto* mt_pipeline = CastToImpl<MTGraphicsPipeline>(state_->pipeline);
     [state_->render_encoder
@@ -528,6 +577,28 @@ void MTCommandList::SetBlendConstants(float red, float green, float blue, float
                                        alpha:state_->blend_constants.value()[3]];
 }
 
+void MTCommandList::SetPrimitiveTopology(PrimitiveTopology topology)
+{
+    state_->primitive_topology = topology;
+}
+
+void MTCommandList::SetCullMode(CullMode cull_mode)
+{
+    state_->cull_mode = cull_mode;
+    state_->need_apply_pipeline = true;
+}
+
+void MTCommandList::SetFrontFace(FrontFace front_face)
+{
+    state_->front_face = front_face;
+    state_->need_apply_pipeline = true;
+}
+
+// Depth stencil and blend states are baked into the pipeline, see MTDevice::GetSupportedDynamicStates().
+void MTCommandList::SetDepthStencilState(const DepthStencilDesc& desc) {}
+
+void MTCommandList::SetBlendState(const BlendDesc& desc) {}
+
 void MTCommandList::BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                        const std::shared_ptr<Resource>& dst,
                                        const std::shared_ptr<Resource>& scratch,
@@ -803,6 +874,36 @@ void MTCommandList::ResolveQueryData(const std::shared_ptr<QueryHeap>& query_hea
                                        size:sizeof(uint64_t) * query_count];
 }
 
+void MTCommandList::WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    NOTREACHED();
+}
+
+void MTCommandList::BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    NOTREACHED();
+}
+
+void MTCommandList::EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    NOTREACHED();
+}
+
+void MTCommandList::BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset)
+{
+    NOTREACHED();
+}
+
+void MTCommandList::EndConditionalRendering()
+{
+    NOTREACHED();
+}
+
+void MTCommandList::SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler)
+{
+    profiler_ = profiler;
+}
+
 void MTCommandList::SetName(const std::string& name)
 {
     command_buffer_.label = [NSString stringWithUTF8String:name.c_str()];
@@ -837,11 +938,21 @@ void MTCommandList::ApplyGraphicsState()
     if (state_->need_apply_pipeline) {
         assert(state_->pipeline->GetPipelineType() == PipelineType::kGraphics);
         auto* mt_pipeline = CastToImpl<MTGraphicsPipeline>(state_->pipeline);
-        decltype(auto) rasterizer_desc = mt_pipeline->GetDesc().rasterizer_desc;
+        decltype(auto) desc = mt_pipeline->GetDesc();
+        decltype(auto) rasterizer_desc = desc.rasterizer_desc;
+        // Unset dynamic states use the type defaults, the pipeline may be shared by descs that differ in them.
+        CullMode cull_mode = rasterizer_desc.cull_mode;
+        if (desc.dynamic_states & DynamicStateFlags::kCullMode) {
+            cull_mode = state_->cull_mode.value_or(RasterizerDesc{}.cull_mode);
+        }
+        FrontFace front_face = rasterizer_desc.front_face;
+        if (desc.dynamic_states & DynamicStateFlags::kFrontFace) {
+            front_face = state_->front_face.value_or(RasterizerDesc{}.front_face);
+        }
         [state_->render_encoder setRenderPipelineState:mt_pipeline->GetPipeline()];
         [state_->render_encoder setTriangleFillMode:ConvertFillMode(rasterizer_desc.fill_mode)];
-        [state_->render_encoder setCullMode:ConvertCullMode(rasterizer_desc.cull_mode)];
-        [state_->render_encoder setFrontFacingWinding:ConvertFrontFace(rasterizer_desc.front_face)];
+        [state_->render_encoder setCullMode:ConvertCullMode(cull_mode)];
+        [state_->render_encoder setFrontFacingWinding:ConvertFrontFace(front_face)];
         [state_->render_encoder setDepthBias:rasterizer_desc.depth_bias
                                   slopeScale:rasterizer_desc.slope_scaled_depth_bias
                                        clamp:rasterizer_desc.depth_bias_clamp];
@@ -854,6 +965,19 @@ void MTCommandList::ApplyGraphicsState()
     AddGraphicsBarriers();
 }
 
+MTLPrimitiveType MTCommandList::GetPrimitiveType() const
+{
+    decltype(auto) desc = CastToImpl<MTGraphicsPipeline>(state_->pipeline)->GetDesc();
+    if (desc.dynamic_states & DynamicStateFlags::kPrimitiveTopology) {
+        PrimitiveTopology topology = state_->primitive_topology.value_or(
+            GetDefaultPrimitiveTopology(GetPrimitiveTopologyClass(desc.topology)));
+        CHECK(GetPrimitiveTopologyClass(topology) == GetPrimitiveTopologyClass(desc.topology),
+              "Topology {} does not match the topology class of the pipeline", static_cast<int>(topology));
+        return ConvertPrimitiveTopology(topology);
+    }
+    return ConvertPrimitiveTopology(desc.topology);
+}
+
 void MTCommandList::AddGraphicsBarriers()
 {
     if (state_->render_barrier_after_stages && state_->render_barrier_before_stages) {
@@ -30,6 +30,20 @@ public:
         ApplyAndRecord(&T::BindPipeline, pipeline);
     }
 
+    bool BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode) override
+    {
+        bool bound = command_list_->BindAsyncPipeline(pipeline, mode);
+        // Replay must repeat the live result, even if the pipeline became ready in between.
+        if (bound) {
+            recorded_cmds_.push_back([pipeline = pipeline->Get()](T* command_list) {
+                command_list->BindPipeline(pipeline);
+            });
+        } else {
+            recorded_cmds_.push_back([](T* command_list) { command_list->SetPipelinePending(); });
+        }
+        return bound;
+    }
+
     void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override
     {
         ApplyAndRecord(&T::BindBindingSet, binding_set);
@@ -176,6 +190,31 @@ public:
         ApplyAndRecord(&T::SetBlendConstants, red, green, blue, alpha);
     }
 
+    void SetPrimitiveTopology(PrimitiveTopology topology) override
+    {
+        ApplyAndRecord(&T::SetPrimitiveTopology, topology);
+    }
+
+    void SetCullMode(CullMode cull_mode) override
+    {
+        ApplyAndRecord(&T::SetCullMode, cull_mode);
+    }
+
+    void SetFrontFace(FrontFace front_face) override
+    {
+        ApplyAndRecord(&T::SetFrontFace, front_face);
+    }
+
+    void SetDepthStencilState(const DepthStencilDesc& desc) override
+    {
+        ApplyAndRecord(&T::SetDepthStencilState, desc);
+    }
+
+    void SetBlendState(const BlendDesc& desc) override
+    {
+        ApplyAndRecord(&T::SetBlendState, desc);
+    }
+
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -250,6 +289,36 @@ public:
         ApplyAndRecord(&T::ResolveQueryData, query_heap, first_query, query_count, dst_buffer, dst_offset);
     }
 
+    void WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override
+    {
+        ApplyAndRecord(&T::WriteTimestamp, query_heap, index);
+    }
+
+    void BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override
+    {
+        ApplyAndRecord(&T::BeginQuery, query_heap, index);
+    }
+
+    void EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override
+    {
+        ApplyAndRecord(&T::EndQuery, query_heap, index);
+    }
+
+    void BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset) override
+    {
+        ApplyAndRecord(&T::BeginConditionalRendering, predicate_buffer, offset);
+    }
+
+    void EndConditionalRendering() override
+    {
+        ApplyAndRecord(&T::EndConditionalRendering);
+    }
+
+    void SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler) override
+    {
+        command_list_->SetGPUProfiler(profiler);
+    }
+
     void SetName(const std::string& name) override
     {
         ApplyAndRecord(&T::SetName, name);
@@ -7,9 +7,12 @@
 #include "Pipeline/VKComputePipeline.h"
 #include "Pipeline/VKGraphicsPipeline.h"
 #include "Pipeline/VKRayTracingPipeline.h"
+#include "Profiler/GPUProfiler.h"
+#include "QueryHeap/QueryData.h"
 #include "QueryHeap/VKQueryHeap.h"
 #include "Resource/VKResource.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/NotReached.h"
 #include "View/VKView.h"
 
@@ -115,12 +118,99 @@ vk::PipelineBindPoint GetPipelineBindPoint(PipelineType type)
 
 void VKCommandList::BindPipeline(const std::shared_ptr<Pipeline>& pipeline)
 {
+    state_->pipeline_pending = false;
     if (pipeline == state_->pipeline) {
         return;
     }
-    state_->pipeline = std::static_pointer_cast<VKPipeline>(pipeline);
+    auto vk_pipeline = std::static_pointer_cast<VKPipeline>(pipeline);
+    // Layouts are interned by the device, so bound descriptor sets stay valid for pipelines with the same layout and
+    // bind point.
+    if (state_->pipeline && (state_->pipeline->GetPipelineLayout() != vk_pipeline->GetPipelineLayout() ||
+                             state_->pipeline->GetPipelineType() != vk_pipeline->GetPipelineType())) {
+        state_->binding_set.reset();
+    }
+    state_->pipeline = vk_pipeline;
     command_list_->bindPipeline(GetPipelineBindPoint(state_->pipeline->GetPipelineType()),
                                 state_->pipeline->GetPipeline());
+    ApplyDynamicState(DynamicStateFlags::kPrimitiveTopology | DynamicStateFlags::kCullMode |
+                      DynamicStateFlags::kFrontFace | DynamicStateFlags::kDepthStencil | DynamicStateFlags::kBlend);
+}
+
+void VKCommandList::ApplyDynamicState(DynamicStateFlags flags)
+{
+    if (!state_->pipeline || state_->pipeline->GetPipelineType() != PipelineType::kGraphics) {
+        return;
+    }
+
+    // States that were never set use the type defaults rather than the desc values, the pipeline may be shared by
+    // descs that differ in them.
+    decltype(auto) desc = CastToImpl<VKGraphicsPipeline>(state_->pipeline)->GetDesc();
+    flags = flags & desc.dynamic_states;
+    if (flags & DynamicStateFlags::kPrimitiveTopology) {
+        PrimitiveTopology topology = state_->primitive_topology.value_or(
+            GetDefaultPrimitiveTopology(GetPrimitiveTopologyClass(desc.topology)));
+        CHECK(GetPrimitiveTopologyClass(topology) == GetPrimitiveTopologyClass(desc.topology),
+              "Topology {} does not match the topology class of the pipeline", static_cast<int>(topology));
+        command_list_->setPrimitiveTopology(ConvertPrimitiveTopology(topology));
+    }
+    if (flags & DynamicStateFlags::kCullMode) {
+        command_list_->setCullMode(ConvertCullMode(state_->cull_mode.value_or(RasterizerDesc{}.cull_mode)));
+    }
+    if (flags & DynamicStateFlags::kFrontFace) {
+        command_list_->setFrontFace(ConvertFrontFace(state_->front_face.value_or(RasterizerDesc{}.front_face)));
+    }
+    if (flags & DynamicStateFlags::kDepthStencil) {
+        DepthStencilDesc depth_stencil_desc = state_->depth_stencil_desc.value_or(DepthStencilDesc{});
+        command_list_->setDepthTestEnable(depth_stencil_desc.depth_test_enable);
+        command_list_->setDepthWriteEnable(depth_stencil_desc.depth_write_enable);
+        command_list_->setDepthCompareOp(ConvertToCompareOp(depth_stencil_desc.depth_func));
+        command_list_->setDepthBoundsTestEnable(depth_stencil_desc.depth_bounds_test_enable);
+        command_list_->setStencilTestEnable(depth_stencil_desc.stencil_enable);
+        auto set_stencil_op = [&](vk::StencilFaceFlags face, const StencilOpDesc& stencil_op_desc) {
+            vk::StencilOpState stencil_op = ConvertStencilOpDesc(stencil_op_desc, depth_stencil_desc.stencil_read_mask,
+                                                                 depth_stencil_desc.stencil_write_mask);
+            command_list_->setStencilOp(face, stencil_op.failOp, stencil_op.passOp, stencil_op.depthFailOp,
+                                        stencil_op.compareOp);
+        };
+        set_stencil_op(vk::StencilFaceFlagBits::eFront, depth_stencil_desc.front_face);
+        set_stencil_op(vk::StencilFaceFlagBits::eBack, depth_stencil_desc.back_face);
+        command_list_->setStencilCompareMask(vk::StencilFaceFlagBits::eFrontAndBack,
+                                             depth_stencil_desc.stencil_read_mask);
+        command_list_->setStencilWriteMask(vk::StencilFaceFlagBits::eFrontAndBack,
+                                           depth_stencil_desc.stencil_write_mask);
+    }
+    if ((flags & DynamicStateFlags::kBlend) && !desc.color_formats.empty()) {
+        vk::PipelineColorBlendAttachmentState attachment =
+            ConvertBlendDesc(state_->blend_desc.value_or(BlendDesc{}));
+        vk::ColorBlendEquationEXT equation = {};
+        equation.srcColorBlendFactor = attachment.srcColorBlendFactor;
+        equation.dstColorBlendFactor = attachment.dstColorBlendFactor;
+        equation.colorBlendOp = attachment.colorBlendOp;
+        equation.srcAlphaBlendFactor = attachment.srcAlphaBlendFactor;
+        equation.dstAlphaBlendFactor = attachment.dstAlphaBlendFactor;
+        equation.alphaBlendOp = attachment.alphaBlendOp;
+
+        size_t attachment_count = desc.color_formats.size();
+        command_list_->setColorBlendEnableEXT(0, std::vector<vk::Bool32>(attachment_count, attachment.blendEnable));
+        command_list_->setColorBlendEquationEXT(0, std::vector<vk::ColorBlendEquationEXT>(attachment_count, equation));
+        command_list_->setColorWriteMaskEXT(
+            0, std::vector<vk::ColorComponentFlags>(attachment_count, attachment.colorWriteMask));
+    }
+}
+
+bool VKCommandList::BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode)
+{
+    if (mode == AsyncPipelineBindMode::kSkipIfNotReady && !pipeline->IsReady()) {
+        SetPipelinePending();
+        return false;
+    }
+    BindPipeline(pipeline->Wait());
+    return true;
+}
+
+void VKCommandList::SetPipelinePending()
+{
+    state_->pipeline_pending = true;
 }
 
 void VKCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_set)
@@ -217,10 +307,16 @@ void VKCommandList::BeginEvent(const std::string& name)
         label.pLabelName = name.c_str();
         command_list_->beginDebugUtilsLabelEXT(&label);
     }
+    if (profiler_) {
+        profiler_->OnBeginEvent(*this, name);
+    }
 }
 
 void VKCommandList::EndEvent()
 {
+    if (profiler_) {
+        profiler_->OnEndEvent(*this);
+    }
     if (device_.GetAdapter().GetInstance().IsDebugUtilsSupported()) {
         command_list_->endDebugUtilsLabelEXT();
     }
@@ -228,6 +324,9 @@ void VKCommandList::EndEvent()
 
 void VKCommandList::Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->draw(vertex_count, instance_count, first_vertex, first_instance);
 }
 
@@ -237,6 +336,9 @@ void VKCommandList::DrawIndexed(uint32_t index_count,
                                 int32_t vertex_offset,
                                 uint32_t first_instance)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->drawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
@@ -258,6 +360,9 @@ void VKCommandList::DrawIndirectCount(const std::shared_ptr<Resource>& argument_
                                       uint32_t max_draw_count,
                                       uint32_t stride)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     auto* vk_argument_buffer = CastToImpl<VKResource>(argument_buffer);
     if (count_buffer) {
         auto* vk_count_buffer = CastToImpl<VKResource>(count_buffer);
@@ -276,6 +381,9 @@ void VKCommandList::DrawIndexedIndirectCount(const std::shared_ptr<Resource>& ar
                                              uint32_t max_draw_count,
                                              uint32_t stride)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     auto* vk_argument_buffer = CastToImpl<VKResource>(argument_buffer);
     if (count_buffer) {
         auto* vk_count_buffer = CastToImpl<VKResource>(count_buffer);
@@ -293,11 +401,17 @@ void VKCommandList::Dispatch(uint32_t thread_group_count_x,
                              uint32_t thread_group_count_y,
                              uint32_t thread_group_count_z)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
 void VKCommandList::DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     auto* vk_argument_buffer = CastToImpl<VKResource>(argument_buffer);
     command_list_->dispatchIndirect(vk_argument_buffer->GetBuffer(), argument_buffer_offset);
 }
@@ -306,6 +420,9 @@ void VKCommandList::DispatchMesh(uint32_t thread_group_count_x,
                                  uint32_t thread_group_count_y,
                                  uint32_t thread_group_count_z)
 {
+    if (state_->pipeline_pending) {
+        return;
+    }
     command_list_->drawMeshTasksEXT(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
@@ -323,6 +440,7 @@ void VKCommandList::DispatchRays(const RayTracingShaderTables& shader_tables,
 void VKCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers)
 {
     std::vector<vk::ImageMemoryBarrier> image_memory_barriers;
+    bool has_indirect_argument_barrier = false;
     for (const auto& barrier : barriers) {
         if (!barrier.resource) {
             assert(false);
@@ -332,6 +450,9 @@ void VKCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barr
         auto* vk_resource = CastToImpl<VKResource>(barrier.resource);
         const vk::Image& image = vk_resource->GetImage();
         if (!image) {
+            if (barrier.state_after & ResourceState::kIndirectArgument) {
+                has_indirect_argument_barrier = true;
+            }
             continue;
         }
 
@@ -455,6 +576,19 @@ void VKCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barr
                                        vk::DependencyFlagBits::eByRegion, 0, nullptr, 0, nullptr,
                                        image_memory_barriers.size(), image_memory_barriers.data());
     }
+
+    if (has_indirect_argument_barrier) {
+        vk::MemoryBarrier memory_barrier = {};
+        memory_barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eShaderWrite;
+        memory_barrier.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead;
+        vk::PipelineStageFlags dst_stage_mask = vk::PipelineStageFlagBits::eDrawIndirect;
+        if (device_.IsConditionalRenderingSupported()) {
+            memory_barrier.dstAccessMask |= vk::AccessFlagBits::eConditionalRenderingReadEXT;
+            dst_stage_mask |= vk::PipelineStageFlagBits::eConditionalRenderingEXT;
+        }
+        command_list_->pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, dst_stage_mask, {}, 1,
+                                       &memory_barrier, 0, nullptr, 0, nullptr);
+    }
 }
 
 void VKCommandList::UAVResourceBarrier(const std::shared_ptr<Resource>& /*resource*/)
@@ -528,6 +662,36 @@ void VKCommandList::SetBlendConstants(float red, float green, float blue, float
     command_list_->setBlendConstants(blend_constants.data());
 }
 
+void VKCommandList::SetPrimitiveTopology(PrimitiveTopology topology)
+{
+    state_->primitive_topology = topology;
+    ApplyDynamicState(DynamicStateFlags::kPrimitiveTopology);
+}
+
+void VKCommandList::SetCullMode(CullMode cull_mode)
+{
+    state_->cull_mode = cull_mode;
+    ApplyDynamicState(DynamicStateFlags::kCullMode);
+}
+
+void VKCommandList::SetFrontFace(FrontFace front_face)
+{
+    state_->front_face = front_face;
+    ApplyDynamicState(DynamicStateFlags::kFrontFace);
+}
+
+void VKCommandList::SetDepthStencilState(const DepthStencilDesc& desc)
+{
+    state_->depth_stencil_desc = desc;
+    ApplyDynamicState(DynamicStateFlags::kDepthStencil);
+}
+
+void VKCommandList::SetBlendState(const BlendDesc& desc)
+{
+    state_->blend_desc = desc;
+    ApplyDynamicState(DynamicStateFlags::kBlend);
+}
+
 void VKCommandList::BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                        const std::shared_ptr<Resource>& dst,
                                        const std::shared_ptr<Resource>& scratch,
@@ -780,10 +944,69 @@ void VKCommandList::ResolveQueryData(const std::shared_ptr<QueryHeap>& query_hea
 {
     auto* vk_query_heap = CastToImpl<VKQueryHeap>(query_heap);
     auto query_type = vk_query_heap->GetQueryType();
-    assert(query_type == vk::QueryType::eAccelerationStructureCompactedSizeKHR);
-    command_list_->copyQueryPoolResults(vk_query_heap->GetQueryPool(), first_query, query_count,
-                                        CastToImpl<VKResource>(dst_buffer)->GetBuffer(), dst_offset, sizeof(uint64_t),
-                                        vk::QueryResultFlagBits::eWait);
+    switch (query_type) {
+    case vk::QueryType::eAccelerationStructureCompactedSizeKHR:
+        command_list_->copyQueryPoolResults(vk_query_heap->GetQueryPool(), first_query, query_count,
+                                            CastToImpl<VKResource>(dst_buffer)->GetBuffer(), dst_offset,
+                                            sizeof(uint64_t), vk::QueryResultFlagBits::eWait);
+        break;
+    case vk::QueryType::eTimestamp:
+    case vk::QueryType::ePipelineStatistics:
+    case vk::QueryType::eOcclusion:
+        command_list_->copyQueryPoolResults(vk_query_heap->GetQueryPool(), first_query, query_count,
+                                            CastToImpl<VKResource>(dst_buffer)->GetBuffer(), dst_offset,
+                                            GetQueryDataStride(query_heap->GetType()),
+                                            vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+        // The copy reads the query results in the transfer stage, the reset must not start before it is done.
+        command_list_->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
+                                       0, nullptr, 0, nullptr, 0, nullptr);
+        command_list_->resetQueryPool(vk_query_heap->GetQueryPool(), first_query, query_count);
+        break;
+    default:
+        NOTREACHED();
+    }
+}
+
+void VKCommandList::WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    auto* vk_query_heap = CastToImpl<VKQueryHeap>(query_heap);
+    assert(vk_query_heap->GetQueryType() == vk::QueryType::eTimestamp);
+    command_list_->writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, vk_query_heap->GetQueryPool(), index);
+}
+
+void VKCommandList::BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    auto* vk_query_heap = CastToImpl<VKQueryHeap>(query_heap);
+    vk::QueryControlFlags flags = {};
+    if (query_heap->GetType() == QueryHeapType::kOcclusion) {
+        flags = vk::QueryControlFlagBits::ePrecise;
+    }
+    command_list_->beginQuery(vk_query_heap->GetQueryPool(), index, flags);
+}
+
+void VKCommandList::EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index)
+{
+    auto* vk_query_heap = CastToImpl<VKQueryHeap>(query_heap);
+    command_list_->endQuery(vk_query_heap->GetQueryPool(), index);
+}
+
+void VKCommandList::BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset)
+{
+    assert(device_.IsConditionalRenderingSupported());
+    vk::ConditionalRenderingBeginInfoEXT begin_info = {};
+    begin_info.buffer = CastToImpl<VKResource>(predicate_buffer)->GetBuffer();
+    begin_info.offset = offset;
+    command_list_->beginConditionalRenderingEXT(begin_info);
+}
+
+void VKCommandList::EndConditionalRendering()
+{
+    command_list_->endConditionalRenderingEXT();
+}
+
+void VKCommandList::SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler)
+{
+    profiler_ = profiler;
 }
 
 void VKCommandList::SetName(const std::string& name)
@@ -3,6 +3,8 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <optional>
+
 class VKDevice;
 class VKPipeline;
 
@@ -12,6 +14,9 @@ public:
     void Reset() override;
     void Close() override;
     void BindPipeline(const std::shared_ptr<Pipeline>& pipeline) override;
+    bool BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode) override;
+    // Skips draws and dispatches until the next pipeline bind, as a not ready kSkipIfNotReady bind does.
+    void SetPipelinePending();
     void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override;
     void BeginRenderPass(const RenderPassDesc& render_pass_desc) override;
     void EndRenderPass() override;
@@ -57,6 +62,11 @@ public:
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override;
     void SetStencilReference(uint32_t stencil_reference) override;
     void SetBlendConstants(float red, float green, float blue, float alpha) override;
+    void SetPrimitiveTopology(PrimitiveTopology topology) override;
+    void SetCullMode(CullMode cull_mode) override;
+    void SetFrontFace(FrontFace front_face) override;
+    void SetDepthStencilState(const DepthStencilDesc& desc) override;
+    void SetBlendState(const BlendDesc& desc) override;
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -94,6 +104,12 @@ public:
                           uint32_t query_count,
                           const std::shared_ptr<Resource>& dst_buffer,
                           uint64_t dst_offset) override;
+    void WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override;
+    void BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset) override;
+    void EndConditionalRendering() override;
+    void SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler) override;
     void SetName(const std::string& name) override;
 
     vk::CommandBuffer GetCommandList();
@@ -110,13 +126,22 @@ private:
                                     const std::shared_ptr<Resource>& dst,
                                     const std::shared_ptr<Resource>& scratch,
                                     uint64_t scratch_offset);
+    void ApplyDynamicState(DynamicStateFlags flags);
 
     VKDevice& device_;
     vk::UniqueCommandBuffer command_list_;
+    std::shared_ptr<GPUProfiler> profiler_;
 
     struct State {
         std::shared_ptr<VKPipeline> pipeline;
         std::shared_ptr<BindingSet> binding_set;
+        std::optional<PrimitiveTopology> primitive_topology;
+        std::optional<CullMode> cull_mode;
+        std::optional<FrontFace> front_face;
+        std::optional<DepthStencilDesc> depth_stencil_desc;
+        std::optional<BlendDesc> blend_desc;
+
+        bool pipeline_pending = false;
     };
 
     std::unique_ptr<State> state_;
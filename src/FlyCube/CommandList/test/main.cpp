@@ -0,0 +1,251 @@
+#include "CommandList/RecordCommandList.h"
+#include "Pipeline/AsyncPipeline.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <future>
+#include <thread>
+
+namespace {
+
+class TestPipeline : public Pipeline {
+public:
+    PipelineType GetPipelineType() const override
+    {
+        return PipelineType::kCompute;
+    }
+
+    std::vector<uint8_t> GetRayTracingShaderGroupHandles(uint32_t first_group, uint32_t group_count) const override
+    {
+        return {};
+    }
+};
+
+enum class CommandType {
+    kReset,
+    kClose,
+    kBindPipeline,
+    kSetPipelinePending,
+    kDispatch,
+};
+
+struct Command {
+    CommandType type;
+    std::shared_ptr<Pipeline> pipeline;
+
+    bool operator==(const Command&) const = default;
+};
+
+// Records what RecordCommandList forwards to the backend, with the pending semantics of the real backends.
+class FakeCommandList : public CommandList {
+public:
+    void Reset() override
+    {
+        commands.push_back({ CommandType::kReset });
+    }
+
+    void Close() override
+    {
+        commands.push_back({ CommandType::kClose });
+    }
+
+    void BindPipeline(const std::shared_ptr<Pipeline>& pipeline) override
+    {
+        commands.push_back({ CommandType::kBindPipeline, pipeline });
+    }
+
+    bool BindAsyncPipeline(const std::shared_ptr<AsyncPipeline>& pipeline, AsyncPipelineBindMode mode) override
+    {
+        if (mode == AsyncPipelineBindMode::kSkipIfNotReady && !pipeline->IsReady()) {
+            SetPipelinePending();
+            return false;
+        }
+        BindPipeline(pipeline->Wait());
+        return true;
+    }
+
+    void SetPipelinePending()
+    {
+        commands.push_back({ CommandType::kSetPipelinePending });
+    }
+
+    void Dispatch(uint32_t thread_group_count_x, uint32_t thread_group_count_y, uint32_t thread_group_count_z) override
+    {
+        commands.push_back({ CommandType::kDispatch });
+    }
+
+    void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override {}
+    void BeginRenderPass(const RenderPassDesc& render_pass_desc) override {}
+    void EndRenderPass() override {}
+    void BeginEvent(const std::string& name) override {}
+    void EndEvent() override {}
+    void Draw(uint32_t vertex_count,
+              uint32_t instance_count,
+              uint32_t first_vertex,
+              uint32_t first_instance) override {}
+    void DrawIndexed(uint32_t index_count,
+                     uint32_t instance_count,
+                     uint32_t first_index,
+                     int32_t vertex_offset,
+                     uint32_t first_instance) override {}
+    void DrawIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DrawIndexedIndirect(const std::shared_ptr<Resource>& argument_buffer,
+                             uint64_t argument_buffer_offset) override {}
+    void DrawIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                           uint64_t argument_buffer_offset,
+                           const std::shared_ptr<Resource>& count_buffer,
+                           uint64_t count_buffer_offset,
+                           uint32_t max_draw_count,
+                           uint32_t stride) override {}
+    void DrawIndexedIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                                  uint64_t argument_buffer_offset,
+                                  const std::shared_ptr<Resource>& count_buffer,
+                                  uint64_t count_buffer_offset,
+                                  uint32_t max_draw_count,
+                                  uint32_t stride) override {}
+    void DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DispatchMesh(uint32_t thread_group_count_x,
+                      uint32_t thread_group_count_y,
+                      uint32_t thread_group_count_z) override {}
+    void DispatchRays(const RayTracingShaderTables& shader_tables,
+                      uint32_t width,
+                      uint32_t height,
+                      uint32_t depth) override {}
+    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override {}
+    void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override {}
+    void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override {}
+    void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override {}
+    void IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format) override {}
+    void IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset) override {}
+    void RSSetShadingRate(ShadingRate shading_rate, const std::array<ShadingRateCombiner, 2>& combiners) override {}
+    void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override {}
+    void SetStencilReference(uint32_t stencil_reference) override {}
+    void SetBlendConstants(float red, float green, float blue, float alpha) override {}
+    void SetPrimitiveTopology(PrimitiveTopology topology) override {}
+    void SetCullMode(CullMode cull_mode) override {}
+    void SetFrontFace(FrontFace front_face) override {}
+    void SetDepthStencilState(const DepthStencilDesc& desc) override {}
+    void SetBlendState(const BlendDesc& desc) override {}
+    void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
+                            const std::shared_ptr<Resource>& dst,
+                            const std::shared_ptr<Resource>& scratch,
+                            uint64_t scratch_offset,
+                            const std::vector<RaytracingGeometryDesc>& descs,
+                            BuildAccelerationStructureFlags flags) override {}
+    void BuildTopLevelAS(const std::shared_ptr<Resource>& src,
+                         const std::shared_ptr<Resource>& dst,
+                         const std::shared_ptr<Resource>& scratch,
+                         uint64_t scratch_offset,
+                         const std::shared_ptr<Resource>& instance_data,
+                         uint64_t instance_offset,
+                         uint32_t instance_count,
+                         BuildAccelerationStructureFlags flags) override {}
+    void CopyAccelerationStructure(const std::shared_ptr<Resource>& src,
+                                   const std::shared_ptr<Resource>& dst,
+                                   CopyAccelerationStructureMode mode) override {}
+    void CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
+                    const std::shared_ptr<Resource>& dst_buffer,
+                    const std::vector<BufferCopyRegion>& regions) override {}
+    void CopyBufferToTexture(const std::shared_ptr<Resource>& src_buffer,
+                             const std::shared_ptr<Resource>& dst_texture,
+                             const std::vector<BufferTextureCopyRegion>& regions) override {}
+    void CopyTextureToBuffer(const std::shared_ptr<Resource>& src_texture,
+                             const std::shared_ptr<Resource>& dst_buffer,
+                             const std::vector<BufferTextureCopyRegion>& regions) override {}
+    void CopyTexture(const std::shared_ptr<Resource>& src_texture,
+                     const std::shared_ptr<Resource>& dst_texture,
+                     const std::vector<TextureCopyRegion>& regions) override {}
+    void WriteAccelerationStructuresProperties(const std::vector<std::shared_ptr<Resource>>& acceleration_structures,
+                                               const std::shared_ptr<QueryHeap>& query_heap,
+                                               uint32_t first_query) override {}
+    void ResolveQueryData(const std::shared_ptr<QueryHeap>& query_heap,
+                          uint32_t first_query,
+                          uint32_t query_count,
+                          const std::shared_ptr<Resource>& dst_buffer,
+                          uint64_t dst_offset) override {}
+    void WriteTimestamp(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override {}
+    void BeginQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override {}
+    void EndQuery(const std::shared_ptr<QueryHeap>& query_heap, uint32_t index) override {}
+    void BeginConditionalRendering(const std::shared_ptr<Resource>& predicate_buffer, uint64_t offset) override {}
+    void EndConditionalRendering() override {}
+    void SetGPUProfiler(const std::shared_ptr<GPUProfiler>& profiler) override {}
+    void SetName(const std::string& name) override {}
+
+    std::vector<Command> commands;
+};
+
+struct TestCommandList {
+    TestCommandList()
+    {
+        auto fake_command_list = std::make_unique<FakeCommandList>();
+        fake = fake_command_list.get();
+        command_list = std::make_unique<RecordCommandList<FakeCommandList>>(std::move(fake_command_list));
+    }
+
+    FakeCommandList* fake = nullptr;
+    std::unique_ptr<RecordCommandList<FakeCommandList>> command_list;
+};
+
+} // namespace
+
+TEST_CASE("AsyncPipeline is not ready until its pipeline is created")
+{
+    std::promise<std::shared_ptr<Pipeline>> promise;
+    AsyncPipeline async_pipeline(promise.get_future().share());
+    CHECK(!async_pipeline.IsReady());
+    CHECK(!async_pipeline.Get());
+
+    auto pipeline = std::make_shared<TestPipeline>();
+    std::thread thread([&] { promise.set_value(pipeline); });
+    CHECK(async_pipeline.Wait() == pipeline);
+    thread.join();
+    CHECK(async_pipeline.IsReady());
+    CHECK(async_pipeline.Get() == pipeline);
+}
+
+TEST_CASE("RecordCommandList replays a skipped async bind as pending")
+{
+    std::promise<std::shared_ptr<Pipeline>> promise;
+    auto async_pipeline = std::make_shared<AsyncPipeline>(promise.get_future().share());
+    TestCommandList test;
+    CHECK(!test.command_list->BindAsyncPipeline(async_pipeline, AsyncPipelineBindMode::kSkipIfNotReady));
+    test.command_list->Dispatch(1, 1, 1);
+    test.command_list->Close();
+    std::vector<Command> recorded = {
+        { CommandType::kSetPipelinePending },
+        { CommandType::kDispatch },
+        { CommandType::kClose },
+    };
+    CHECK(test.fake->commands == recorded);
+    test.command_list->OnSubmit();
+    CHECK(test.fake->commands == recorded);
+
+    // The frame was recorded without the pipeline, so the replay must not bind it even though it is ready now.
+    promise.set_value(std::make_shared<TestPipeline>());
+    REQUIRE(async_pipeline->IsReady());
+    test.fake->commands.clear();
+    test.command_list->OnSubmit();
+    recorded.insert(recorded.begin(), Command{ CommandType::kReset });
+    CHECK(test.fake->commands == recorded);
+}
+
+TEST_CASE("RecordCommandList replays a ready async bind with its pipeline")
+{
+    auto pipeline = std::make_shared<TestPipeline>();
+    std::promise<std::shared_ptr<Pipeline>> promise;
+    promise.set_value(pipeline);
+    auto async_pipeline = std::make_shared<AsyncPipeline>(promise.get_future().share());
+    TestCommandList test;
+    CHECK(test.command_list->BindAsyncPipeline(async_pipeline, AsyncPipelineBindMode::kSkipIfNotReady));
+    test.command_list->Close();
+    test.command_list->OnSubmit();
+
+    test.fake->commands.clear();
+    test.command_list->OnSubmit();
+    std::vector<Command> replayed = {
+        { CommandType::kReset },
+        { CommandType::kBindPipeline, pipeline },
+        { CommandType::kClose },
+    };
+    CHECK(test.fake->commands == replayed);
+}
@@ -7,6 +7,7 @@
 #include "Utilities/Cast.h"
 #include "Utilities/DXUtility.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/Trace.h"
 
 DXCommandQueue::DXCommandQueue(DXDevice& device, CommandListType type)
     : device_(device)
@@ -45,6 +46,7 @@ void DXCommandQueue::Signal(const std::shared_ptr<Fence>& fence, uint64_t value)
 
 void DXCommandQueue::ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists)
 {
+    TRACE_SCOPE("DXCommandQueue::ExecuteCommandLists");
     std::vector<ID3D12CommandList*> dx_command_lists;
     for (auto& command_list : command_lists) {
         if (!command_list) {
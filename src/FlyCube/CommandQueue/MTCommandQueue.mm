@@ -6,6 +6,7 @@
 #include "Fence/MTFence.h"
 #include "Instance/MTInstance.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Trace.h"
 
 MTCommandQueue::MTCommandQueue(MTDevice& device)
     : device_(device)
@@ -28,6 +29,7 @@ void MTCommandQueue::Signal(const std::shared_ptr<Fence>& fence, uint64_t value)
 
 void MTCommandQueue::ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists)
 {
+    TRACE_SCOPE("MTCommandQueue::ExecuteCommandLists");
     std::vector<id<MTL4CommandBuffer>> command_buffers;
     for (auto& command_list : command_lists) {
         if (!command_list) {
@@ -0,0 +1,91 @@
+#include "CommandQueue/QueueScheduler.h"
+
+#include "Utilities/Check.h"
+
+#include <algorithm>
+
+QueueScheduler::QueueScheduler(const std::shared_ptr<Device>& device)
+    : QueueScheduler(
+          {
+              { CommandListType::kGraphics, device->GetCommandQueue(CommandListType::kGraphics) },
+              { CommandListType::kCompute, device->GetCommandQueue(CommandListType::kCompute) },
+              { CommandListType::kCopy, device->GetCommandQueue(CommandListType::kCopy) },
+          },
+          [&] { return device->CreateFence(0); })
+{
+    device_ = device;
+}
+
+QueueScheduler::QueueScheduler(const std::map<CommandListType, std::shared_ptr<CommandQueue>>& command_queues,
+                               const std::function<std::shared_ptr<Fence>()>& create_fence)
+{
+    for (const auto& [type, command_queue] : command_queues) {
+        auto it = std::find_if(queues_.begin(), queues_.end(), [&](const QueueState& queue) {
+            return queue.command_queue == command_queue;
+        });
+        if (it != queues_.end()) {
+            queue_indices_[type] = std::distance(queues_.begin(), it);
+            continue;
+        }
+        queue_indices_[type] = queues_.size();
+        queues_.push_back({ command_queue, create_fence() });
+    }
+    planner_ = std::make_unique<SubmissionPlanner>(queues_.size());
+}
+
+SubmissionId QueueScheduler::Submit(const SubmissionDesc& desc)
+{
+    uint32_t queue_index = GetQueueIndex(desc.queue_type);
+    SubmissionId id = planner_->Add(queue_index, desc.dependencies, desc.flush_priority);
+    queues_[queue_index].command_lists[id.value] = desc.command_lists;
+    return id;
+}
+
+void QueueScheduler::Flush()
+{
+    UpdateCompletedValues();
+    for (const auto& submission : planner_->Flush()) {
+        auto& queue = queues_[submission.id.queue_index];
+        for (const auto& wait : submission.waits) {
+            queue.command_queue->Wait(queues_[wait.queue_index].fence, wait.value);
+        }
+        auto node = queue.command_lists.extract(submission.id.value);
+        queue.command_queue->ExecuteCommandLists(node.mapped());
+        queue.command_queue->Signal(queue.fence, submission.id.value);
+    }
+}
+
+bool QueueScheduler::IsCompleted(const SubmissionId& id)
+{
+    return queues_.at(id.queue_index).fence->GetCompletedValue() >= id.value;
+}
+
+void QueueScheduler::Wait(const SubmissionId& id)
+{
+    auto& queue = queues_.at(id.queue_index);
+    CHECK(!queue.command_lists.contains(id.value), "Submission must be flushed before waiting on it");
+    queue.fence->Wait(id.value);
+    planner_->SetCompletedValue(id.queue_index, id.value);
+}
+
+void QueueScheduler::WaitIdle()
+{
+    Flush();
+    for (uint32_t i = 0; i < queues_.size(); ++i) {
+        uint64_t value = planner_->GetLastValue(i);
+        queues_[i].fence->Wait(value);
+        planner_->SetCompletedValue(i, value);
+    }
+}
+
+uint32_t QueueScheduler::GetQueueIndex(CommandListType type)
+{
+    return queue_indices_.at(type);
+}
+
+void QueueScheduler::UpdateCompletedValues()
+{
+    for (uint32_t i = 0; i < queues_.size(); ++i) {
+        planner_->SetCompletedValue(i, queues_[i].fence->GetCompletedValue());
+    }
+}
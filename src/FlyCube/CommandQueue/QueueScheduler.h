@@ -0,0 +1,44 @@
+#pragma once
+#include "CommandQueue/CommandQueue.h"
+#include "CommandQueue/SubmissionPlanner.h"
+#include "Device/Device.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+struct SubmissionDesc {
+    CommandListType queue_type = CommandListType::kGraphics;
+    std::vector<std::shared_ptr<CommandList>> command_lists;
+    std::vector<SubmissionId> dependencies;
+    FlushPriority flush_priority = FlushPriority::kNormal;
+};
+
+class QueueScheduler {
+public:
+    explicit QueueScheduler(const std::shared_ptr<Device>& device);
+    QueueScheduler(const std::map<CommandListType, std::shared_ptr<CommandQueue>>& command_queues,
+                   const std::function<std::shared_ptr<Fence>()>& create_fence);
+
+    SubmissionId Submit(const SubmissionDesc& desc);
+    void Flush();
+    bool IsCompleted(const SubmissionId& id);
+    void Wait(const SubmissionId& id);
+    void WaitIdle();
+
+private:
+    struct QueueState {
+        std::shared_ptr<CommandQueue> command_queue;
+        std::shared_ptr<Fence> fence;
+        std::map<uint64_t, std::vector<std::shared_ptr<CommandList>>> command_lists;
+    };
+
+    uint32_t GetQueueIndex(CommandListType type);
+    void UpdateCompletedValues();
+
+    std::shared_ptr<Device> device_;
+    std::vector<QueueState> queues_;
+    std::map<CommandListType, uint32_t> queue_indices_;
+    std::unique_ptr<SubmissionPlanner> planner_;
+};
@@ -0,0 +1,140 @@
+#include "CommandQueue/SubmissionPlanner.h"
+
+#include "Utilities/Check.h"
+
+#include <algorithm>
+
+SubmissionPlanner::SubmissionPlanner(uint32_t queue_count)
+    : queue_count_(queue_count)
+    , last_values_(queue_count)
+    , issued_values_(queue_count)
+    , completed_values_(queue_count)
+    , known_values_(queue_count, std::vector<uint64_t>(queue_count))
+    , clocks_(queue_count)
+    , pending_(queue_count)
+{
+}
+
+SubmissionId SubmissionPlanner::Add(uint32_t queue_index,
+                                    const std::vector<SubmissionId>& dependencies,
+                                    FlushPriority flush_priority)
+{
+    CHECK(queue_index < queue_count_);
+    for (const auto& dependency : dependencies) {
+        CHECK(dependency.queue_index < queue_count_);
+        CHECK(dependency.value != 0 && dependency.value <= last_values_[dependency.queue_index],
+              "Dependencies must refer to previously added submissions");
+    }
+    SubmissionId id = { queue_index, ++last_values_[queue_index] };
+    pending_[queue_index].push_back({ id, dependencies, flush_priority, order_++ });
+    return id;
+}
+
+std::vector<PlannedSubmission> SubmissionPlanner::Flush()
+{
+    std::vector<size_t> heads(queue_count_);
+    auto is_ready = [&](const PendingSubmission& submission) {
+        return std::ranges::all_of(submission.dependencies, [&](const SubmissionId& dependency) {
+            return dependency.value <= issued_values_[dependency.queue_index];
+        });
+    };
+
+    std::vector<PlannedSubmission> planned;
+    while (true) {
+        const PendingSubmission* next = nullptr;
+        for (uint32_t i = 0; i < queue_count_; ++i) {
+            if (heads[i] == pending_[i].size()) {
+                continue;
+            }
+            const auto& head = pending_[i][heads[i]];
+            if (!is_ready(head)) {
+                continue;
+            }
+            if (!next || head.flush_priority > next->flush_priority ||
+                (head.flush_priority == next->flush_priority && head.order < next->order)) {
+                next = &head;
+            }
+        }
+        if (!next) {
+            break;
+        }
+        planned.push_back(Plan(*next));
+        ++heads[next->id.queue_index];
+    }
+
+    for (uint32_t i = 0; i < queue_count_; ++i) {
+        DCHECK(heads[i] == pending_[i].size());
+        pending_[i].clear();
+    }
+    return planned;
+}
+
+void SubmissionPlanner::SetCompletedValue(uint32_t queue_index, uint64_t value)
+{
+    auto& completed_value = completed_values_.at(queue_index);
+    completed_value = std::max(completed_value, value);
+    auto& clocks = clocks_[queue_index];
+    clocks.erase(clocks.begin(), clocks.upper_bound(completed_value));
+}
+
+uint64_t SubmissionPlanner::GetCompletedValue(uint32_t queue_index) const
+{
+    return completed_values_.at(queue_index);
+}
+
+uint64_t SubmissionPlanner::GetLastValue(uint32_t queue_index) const
+{
+    return last_values_.at(queue_index);
+}
+
+PlannedSubmission SubmissionPlanner::Plan(const PendingSubmission& submission)
+{
+    uint32_t queue_index = submission.id.queue_index;
+    auto& known_values = known_values_[queue_index];
+
+    std::vector<uint64_t> required_values(queue_count_);
+    for (const auto& dependency : submission.dependencies) {
+        if (dependency.queue_index == queue_index) {
+            continue;
+        }
+        uint64_t& required_value = required_values[dependency.queue_index];
+        required_value = std::max(required_value, dependency.value);
+    }
+
+    std::vector<PlannedWait> candidates;
+    for (uint32_t i = 0; i < queue_count_; ++i) {
+        if (required_values[i] > std::max(known_values[i], completed_values_[i])) {
+            candidates.push_back({ i, required_values[i] });
+        }
+    }
+
+    PlannedSubmission planned = { submission.id };
+    for (const auto& candidate : candidates) {
+        bool implied = std::ranges::any_of(candidates, [&](const PlannedWait& other) {
+            if (other.queue_index == candidate.queue_index) {
+                return false;
+            }
+            const auto& clock = GetClock({ other.queue_index, other.value });
+            return clock[candidate.queue_index] >= candidate.value;
+        });
+        if (!implied) {
+            planned.waits.push_back(candidate);
+        }
+    }
+
+    for (const auto& wait : planned.waits) {
+        const auto& clock = GetClock({ wait.queue_index, wait.value });
+        for (uint32_t i = 0; i < queue_count_; ++i) {
+            known_values[i] = std::max(known_values[i], clock[i]);
+        }
+    }
+    known_values[queue_index] = submission.id.value;
+    issued_values_[queue_index] = submission.id.value;
+    clocks_[queue_index][submission.id.value] = known_values;
+    return planned;
+}
+
+const std::vector<uint64_t>& SubmissionPlanner::GetClock(const SubmissionId& id) const
+{
+    return clocks_[id.queue_index].at(id.value);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <vector>
+
+struct SubmissionId {
+    uint32_t queue_index = 0;
+    uint64_t value = 0;
+};
+
+// Only decides which ready submission is handed to its queue first during Flush().
+// It does not change the priority the GPU assigns to the underlying queue.
+enum class FlushPriority {
+    kLow,
+    kNormal,
+    kHigh,
+};
+
+struct PlannedWait {
+    uint32_t queue_index;
+    uint64_t value;
+};
+
+struct PlannedSubmission {
+    SubmissionId id;
+    std::vector<PlannedWait> waits;
+};
+
+class SubmissionPlanner {
+public:
+    explicit SubmissionPlanner(uint32_t queue_count);
+
+    SubmissionId Add(uint32_t queue_index,
+                     const std::vector<SubmissionId>& dependencies,
+                     FlushPriority flush_priority = FlushPriority::kNormal);
+    std::vector<PlannedSubmission> Flush();
+    void SetCompletedValue(uint32_t queue_index, uint64_t value);
+    uint64_t GetCompletedValue(uint32_t queue_index) const;
+    uint64_t GetLastValue(uint32_t queue_index) const;
+
+private:
+    struct PendingSubmission {
+        SubmissionId id;
+        std::vector<SubmissionId> dependencies;
+        FlushPriority flush_priority;
+        uint64_t order;
+    };
+
+    PlannedSubmission Plan(const PendingSubmission& submission);
+    const std::vector<uint64_t>& GetClock(const SubmissionId& id) const;
+
+    uint32_t queue_count_;
+    uint64_t order_ = 0;
+    std::vector<uint64_t> last_values_;
+    std::vector<uint64_t> issued_values_;
+    std::vector<uint64_t> completed_values_;
+    std::vector<std::vector<uint64_t>> known_values_;
+    std::vector<std::map<uint64_t, std::vector<uint64_t>>> clocks_;
+    std::vector<std::vector<PendingSubmission>> pending_;
+};
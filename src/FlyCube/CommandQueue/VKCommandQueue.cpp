@@ -4,6 +4,7 @@
 #include "Device/VKDevice.h"
 #include "Fence/VKTimelineSemaphore.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Trace.h"
 
 VKCommandQueue::VKCommandQueue(VKDevice& device, CommandListType type, uint32_t queue_family_index)
     : device_(device)
@@ -44,6 +45,7 @@ void VKCommandQueue::Signal(const std::shared_ptr<Fence>& fence, uint64_t value)
 
 void VKCommandQueue::ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists)
 {
+    TRACE_SCOPE("VKCommandQueue::ExecuteCommandLists");
     std::vector<vk::CommandBuffer> vk_command_lists;
     for (auto& command_list : command_lists) {
         if (!command_list) {
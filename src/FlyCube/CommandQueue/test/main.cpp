@@ -0,0 +1,288 @@
+#include "CommandQueue/QueueScheduler.h"
+#include "CommandQueue/SubmissionPlanner.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace {
+
+constexpr uint32_t kGraphicsQueue = 0;
+constexpr uint32_t kComputeQueue = 1;
+constexpr uint32_t kCopyQueue = 2;
+
+struct Dependency {
+    SubmissionId consumer;
+    SubmissionId producer;
+};
+
+// Replays the plan and checks that every producer is ordered before its consumer,
+// either by queue order or by a chain of waits.
+void CheckNoRaces(const std::vector<PlannedSubmission>& plan, const std::vector<Dependency>& dependencies)
+{
+    std::vector<std::vector<uint64_t>> known(3, std::vector<uint64_t>(3));
+    std::map<std::pair<uint32_t, uint64_t>, std::vector<uint64_t>> clocks;
+    for (const auto& submission : plan) {
+        auto& clock = known[submission.id.queue_index];
+        for (const auto& wait : submission.waits) {
+            const auto& other = clocks.at({ wait.queue_index, wait.value });
+            for (size_t i = 0; i < clock.size(); ++i) {
+                clock[i] = std::max(clock[i], other[i]);
+            }
+        }
+        clock[submission.id.queue_index] = submission.id.value;
+        clocks[{ submission.id.queue_index, submission.id.value }] = clock;
+    }
+    for (const auto& dependency : dependencies) {
+        const auto& clock = clocks.at({ dependency.consumer.queue_index, dependency.consumer.value });
+        CHECK(clock[dependency.producer.queue_index] >= dependency.producer.value);
+    }
+}
+
+size_t CountWaits(const std::vector<PlannedSubmission>& plan)
+{
+    size_t count = 0;
+    for (const auto& submission : plan) {
+        count += submission.waits.size();
+    }
+    return count;
+}
+
+// Timeline fence that only advances when a test or a queue signals it.
+class FakeFence : public Fence {
+public:
+    uint64_t GetCompletedValue() override
+    {
+        return completed_value;
+    }
+
+    void Wait(uint64_t value) override
+    {
+        completed_value = std::max(completed_value, value);
+    }
+
+    void Signal(uint64_t value) override
+    {
+        completed_value = std::max(completed_value, value);
+    }
+
+    uint64_t completed_value = 0;
+};
+
+struct QueueEvent {
+    enum Type {
+        kWait,
+        kExecute,
+        kSignal,
+    };
+
+    Type type;
+    std::shared_ptr<Fence> fence;
+    uint64_t value = 0;
+};
+
+// Records the commands the scheduler issues without executing or signaling anything.
+class FakeCommandQueue : public CommandQueue {
+public:
+    void Wait(const std::shared_ptr<Fence>& fence, uint64_t value) override
+    {
+        events.push_back({ QueueEvent::kWait, fence, value });
+    }
+
+    void Signal(const std::shared_ptr<Fence>& fence, uint64_t value) override
+    {
+        events.push_back({ QueueEvent::kSignal, fence, value });
+    }
+
+    void ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists) override
+    {
+        events.push_back({ QueueEvent::kExecute });
+    }
+
+    std::vector<QueueEvent> events;
+};
+
+struct FakeQueues {
+    std::shared_ptr<FakeCommandQueue> graphics = std::make_shared<FakeCommandQueue>();
+    std::shared_ptr<FakeCommandQueue> compute = std::make_shared<FakeCommandQueue>();
+    std::shared_ptr<FakeCommandQueue> copy = std::make_shared<FakeCommandQueue>();
+    std::vector<std::shared_ptr<FakeFence>> fences;
+
+    QueueScheduler CreateScheduler()
+    {
+        return QueueScheduler(
+            {
+                { CommandListType::kGraphics, graphics },
+                { CommandListType::kCompute, compute },
+                { CommandListType::kCopy, copy },
+            },
+            [this] { return fences.emplace_back(std::make_shared<FakeFence>()); });
+    }
+};
+
+} // namespace
+
+TEST_CASE("Independent graphics and compute overlap")
+{
+    SubmissionPlanner planner(3);
+    auto graphics = planner.Add(kGraphicsQueue, {});
+    auto compute = planner.Add(kComputeQueue, {});
+    auto plan = planner.Flush();
+    REQUIRE(plan.size() == 2);
+    CHECK(graphics.value == 1);
+    CHECK(compute.value == 1);
+    CHECK(CountWaits(plan) == 0);
+}
+
+TEST_CASE("Async compute feeding graphics")
+{
+    SubmissionPlanner planner(3);
+    std::vector<Dependency> dependencies;
+    auto shadow = planner.Add(kGraphicsQueue, {});
+    auto culling = planner.Add(kComputeQueue, {});
+    auto geometry = planner.Add(kGraphicsQueue, { culling });
+    dependencies.push_back({ geometry, culling });
+    auto lighting = planner.Add(kComputeQueue, { shadow, geometry });
+    dependencies.push_back({ lighting, shadow });
+    dependencies.push_back({ lighting, geometry });
+    auto post = planner.Add(kGraphicsQueue, { lighting, culling });
+    dependencies.push_back({ post, lighting });
+    dependencies.push_back({ post, culling });
+
+    auto plan = planner.Flush();
+    REQUIRE(plan.size() == 5);
+    CheckNoRaces(plan, dependencies);
+    // shadow and culling run concurrently, each later consumer needs exactly one wait.
+    CHECK(plan[0].waits.empty());
+    CHECK(plan[1].waits.empty());
+    CHECK(CountWaits(plan) == 3);
+}
+
+TEST_CASE("Redundant waits are elided")
+{
+    SubmissionPlanner planner(3);
+    auto compute = planner.Add(kComputeQueue, {});
+    auto first = planner.Add(kGraphicsQueue, { compute });
+    auto second = planner.Add(kGraphicsQueue, { compute, first });
+    auto plan = planner.Flush();
+    REQUIRE(plan.size() == 3);
+    CheckNoRaces(plan, { { first, compute }, { second, compute }, { second, first } });
+    CHECK(CountWaits(plan) == 1);
+}
+
+TEST_CASE("Transitive waits are elided")
+{
+    SubmissionPlanner planner(3);
+    auto upload = planner.Add(kCopyQueue, {});
+    auto compute = planner.Add(kComputeQueue, { upload });
+    auto graphics = planner.Add(kGraphicsQueue, { upload, compute });
+    auto plan = planner.Flush();
+    REQUIRE(plan.size() == 3);
+    CheckNoRaces(plan, { { compute, upload }, { graphics, upload }, { graphics, compute } });
+    REQUIRE(plan[2].waits.size() == 1);
+    CHECK(plan[2].waits[0].queue_index == kComputeQueue);
+}
+
+TEST_CASE("Completed submissions need no waits")
+{
+    SubmissionPlanner planner(3);
+    auto compute = planner.Add(kComputeQueue, {});
+    planner.Flush();
+    planner.SetCompletedValue(kComputeQueue, compute.value);
+    planner.Add(kGraphicsQueue, { compute });
+    auto plan = planner.Flush();
+    REQUIRE(plan.size() == 1);
+    CHECK(plan[0].waits.empty());
+}
+
+TEST_CASE("Higher priority queues are submitted first")
+{
+    SubmissionPlanner planner(3);
+    planner.Add(kGraphicsQueue, {}, FlushPriority::kNormal);
+    auto compute = planner.Add(kComputeQueue, {}, FlushPriority::kHigh);
+    auto plan = planner.Flush();
+    REQUIRE(plan.size() == 2);
+    CHECK(plan[0].id.queue_index == compute.queue_index);
+}
+
+TEST_CASE("QueueScheduler signals the queue timeline with submission values")
+{
+    FakeQueues queues;
+    QueueScheduler scheduler = queues.CreateScheduler();
+    REQUIRE(queues.fences.size() == 3);
+    auto first = scheduler.Submit({ CommandListType::kGraphics });
+    auto second = scheduler.Submit({ CommandListType::kGraphics });
+    scheduler.Flush();
+
+    const auto& events = queues.graphics->events;
+    REQUIRE(events.size() == 4);
+    CHECK(events[0].type == QueueEvent::kExecute);
+    CHECK(events[1].type == QueueEvent::kSignal);
+    CHECK(events[1].fence == queues.fences[0]);
+    CHECK(events[1].value == first.value);
+    CHECK(events[2].type == QueueEvent::kExecute);
+    CHECK(events[3].type == QueueEvent::kSignal);
+    CHECK(events[3].fence == queues.fences[0]);
+    CHECK(events[3].value == second.value);
+    CHECK(queues.compute->events.empty());
+    CHECK(queues.copy->events.empty());
+}
+
+TEST_CASE("QueueScheduler waits on the producer timeline before executing")
+{
+    FakeQueues queues;
+    QueueScheduler scheduler = queues.CreateScheduler();
+    auto compute = scheduler.Submit({ CommandListType::kCompute });
+    auto graphics = scheduler.Submit({ CommandListType::kGraphics, {}, { compute } });
+    scheduler.Flush();
+
+    const auto& events = queues.graphics->events;
+    REQUIRE(events.size() == 3);
+    CHECK(events[0].type == QueueEvent::kWait);
+    CHECK(events[0].fence == queues.fences[1]);
+    CHECK(events[0].value == compute.value);
+    CHECK(events[1].type == QueueEvent::kExecute);
+    CHECK(events[2].type == QueueEvent::kSignal);
+    CHECK(events[2].fence == queues.fences[0]);
+    CHECK(events[2].value == graphics.value);
+}
+
+TEST_CASE("QueueScheduler skips waits on completed timeline values")
+{
+    FakeQueues queues;
+    QueueScheduler scheduler = queues.CreateScheduler();
+    auto compute = scheduler.Submit({ CommandListType::kCompute });
+    scheduler.Flush();
+    CHECK(!scheduler.IsCompleted(compute));
+    queues.fences[1]->completed_value = compute.value;
+    CHECK(scheduler.IsCompleted(compute));
+
+    scheduler.Submit({ CommandListType::kGraphics, {}, { compute } });
+    scheduler.Flush();
+    const auto& events = queues.graphics->events;
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].type == QueueEvent::kExecute);
+    CHECK(events[1].type == QueueEvent::kSignal);
+}
+
+TEST_CASE("QueueScheduler shares one timeline between aliased queues")
+{
+    auto queue = std::make_shared<FakeCommandQueue>();
+    std::vector<std::shared_ptr<FakeFence>> fences;
+    QueueScheduler scheduler(
+        {
+            { CommandListType::kGraphics, queue },
+            { CommandListType::kCompute, queue },
+            { CommandListType::kCopy, queue },
+        },
+        [&] { return fences.emplace_back(std::make_shared<FakeFence>()); });
+    REQUIRE(fences.size() == 1);
+
+    auto compute = scheduler.Submit({ CommandListType::kCompute });
+    auto graphics = scheduler.Submit({ CommandListType::kGraphics, {}, { compute } });
+    CHECK(graphics.value == compute.value + 1);
+    scheduler.Flush();
+    CHECK(std::none_of(queue->events.begin(), queue->events.end(),
+                       [](const QueueEvent& event) { return event.type == QueueEvent::kWait; }));
+}
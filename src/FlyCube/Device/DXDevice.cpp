@@ -11,12 +11,14 @@
 #include "Pipeline/DXComputePipeline.h"
 #include "Pipeline/DXGraphicsPipeline.h"
 #include "Pipeline/DXRayTracingPipeline.h"
+#include "QueryHeap/DXQueryHeap.h"
 #include "QueryHeap/DXRayTracingQueryHeap.h"
 #include "Resource/DXAccelerationStructure.h"
 #include "Resource/DXBuffer.h"
 #include "Resource/DXSampler.h"
 #include "Resource/DXTexture.h"
 #include "Shader/ShaderBase.h"
+#include "Utilities/Check.h"
 #include "Utilities/Common.h"
 #include "Utilities/DXUtility.h"
 #include "Utilities/NotReached.h"
@@ -189,6 +191,13 @@ DXDevice::DXDevice(DXAdapter& adapter)
         is_under_graphics_debugger_ |= !!gpa;
     }
 
+    D3D12_FEATURE_DATA_D3D12_OPTIONS1 feature_support1 = {};
+    if (SUCCEEDED(
+            device_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS1, &feature_support1, sizeof(feature_support1)))) {
+        min_subgroup_size_ = feature_support1.WaveLaneCountMin;
+        max_subgroup_size_ = feature_support1.WaveLaneCountMax;
+    }
+
     D3D12_FEATURE_DATA_D3D12_OPTIONS5 feature_support5 = {};
     if (SUCCEEDED(
             device_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS5, &feature_support5, sizeof(feature_support5)))) {
@@ -222,6 +231,13 @@ DXDevice::DXDevice(DXAdapter& adapter)
     command_queues_[CommandListType::kCompute] = std::make_shared<DXCommandQueue>(*this, CommandListType::kCompute);
     command_queues_[CommandListType::kCopy] = std::make_shared<DXCommandQueue>(*this, CommandListType::kCopy);
 
+    uint64_t timestamp_frequency = 0;
+    if (SUCCEEDED(command_queues_.at(CommandListType::kGraphics)->GetQueue()->GetTimestampFrequency(
+            &timestamp_frequency)) &&
+        timestamp_frequency != 0) {
+        timestamp_period_ = 1e9 / timestamp_frequency;
+    }
+
     if (IsValidationEnabled()) {
         ComPtr<ID3D12InfoQueue> info_queue;
         if (SUCCEEDED(device_.As(&info_queue))) {
@@ -375,6 +391,13 @@ std::shared_ptr<Shader> DXDevice::CreateShader(const std::vector<uint8_t>& blob,
     return std::make_shared<ShaderBase>(blob, blob_type, shader_type);
 }
 
+std::shared_ptr<Shader> DXDevice::CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name)
+{
+    auto shader = bundle.GetShader(name, ShaderBlobType::kDXIL);
+    CHECK(shader, "Shader {} is missing in the bundle", name);
+    return std::make_shared<ShaderBase>(*shader);
+}
+
 std::shared_ptr<Shader> DXDevice::CompileShader(const ShaderDesc& desc)
 {
     return std::make_shared<ShaderBase>(Compile(desc, ShaderBlobType::kDXIL), ShaderBlobType::kDXIL, desc.type);
@@ -382,12 +405,12 @@ std::shared_ptr<Shader> DXDevice::CompileShader(const ShaderDesc& desc)
 
 std::shared_ptr<Pipeline> DXDevice::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
 {
-    return std::make_shared<DXGraphicsPipeline>(*this, desc);
+    return pipeline_desc_cache_.GetOrCreate(desc, [&] { return std::make_shared<DXGraphicsPipeline>(*this, desc); });
 }
 
 std::shared_ptr<Pipeline> DXDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
 {
-    return std::make_shared<DXComputePipeline>(*this, desc);
+    return pipeline_desc_cache_.GetOrCreate(desc, [&] { return std::make_shared<DXComputePipeline>(*this, desc); });
 }
 
 std::shared_ptr<Pipeline> DXDevice::CreateRayTracingPipeline(const RayTracingPipelineDesc& desc)
@@ -402,10 +425,17 @@ std::shared_ptr<Resource> DXDevice::CreateAccelerationStructure(const Accelerati
 
 std::shared_ptr<QueryHeap> DXDevice::CreateQueryHeap(QueryHeapType type, uint32_t count)
 {
-    if (type == QueryHeapType::kAccelerationStructureCompactedSize) {
+    switch (type) {
+    case QueryHeapType::kAccelerationStructureCompactedSize:
         return std::make_shared<DXRayTracingQueryHeap>(*this, type, count);
+    case QueryHeapType::kTimestamp:
+    case QueryHeapType::kPipelineStatistics:
+    case QueryHeapType::kOcclusion:
+    case QueryHeapType::kBinaryOcclusion:
+        return std::make_shared<DXQueryHeap>(*this, type, count);
+    default:
+        return nullptr;
     }
-    return nullptr;
 }
 
 RaytracingASPrebuildInfo DXDevice::GetAccelerationStructurePrebuildInfo(
@@ -460,11 +490,32 @@ bool DXDevice::IsSamplerFilterMinmaxSupported() const
     return true;
 }
 
+bool DXDevice::IsConditionalRenderingSupported() const
+{
+    return true;
+}
+
+// Everything else is baked into the pipeline state object.
+DynamicStateFlags DXDevice::GetSupportedDynamicStates() const
+{
+    return DynamicStateFlags::kPrimitiveTopology;
+}
+
 uint32_t DXDevice::GetShadingRateImageTileSize() const
 {
     return shading_rate_image_tile_size_;
 }
 
+uint32_t DXDevice::GetMinSubgroupSize() const
+{
+    return min_subgroup_size_;
+}
+
+uint32_t DXDevice::GetMaxSubgroupSize() const
+{
+    return max_subgroup_size_;
+}
+
 MemoryBudget DXDevice::GetMemoryBudget() const
 {
 #if defined(_WIN32)
@@ -533,6 +584,16 @@ uint64_t DXDevice::GetConstantBufferOffsetAlignment() const
     return D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
 }
 
+double DXDevice::GetTimestampPeriod() const
+{
+    return timestamp_period_;
+}
+
+PipelineDescCacheStats DXDevice::GetPipelineDescCacheStats() const
+{
+    return pipeline_desc_cache_.GetStats();
+}
+
 DXAdapter& DXDevice::GetAdapter()
 {
     return adapter_;
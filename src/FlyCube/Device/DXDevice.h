@@ -57,6 +57,7 @@ public:
     std::shared_ptr<Shader> CreateShader(const std::vector<uint8_t>& blob,
                                          ShaderBlobType blob_type,
                                          ShaderType shader_type) override;
+    std::shared_ptr<Shader> CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name) override;
     std::shared_ptr<Shader> CompileShader(const ShaderDesc& desc) override;
     std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override;
@@ -71,7 +72,11 @@ public:
     bool IsGeometryShaderSupported() const override;
     bool IsBindlessSupported() const override;
     bool IsSamplerFilterMinmaxSupported() const override;
+    bool IsConditionalRenderingSupported() const override;
+    DynamicStateFlags GetSupportedDynamicStates() const override;
     uint32_t GetShadingRateImageTileSize() const override;
+    uint32_t GetMinSubgroupSize() const override;
+    uint32_t GetMaxSubgroupSize() const override;
     MemoryBudget GetMemoryBudget() const override;
     uint32_t GetShaderGroupHandleSize() const override;
     uint32_t GetShaderRecordAlignment() const override;
@@ -82,6 +87,8 @@ public:
                                                  BuildAccelerationStructureFlags flags) const override;
     ShaderBlobType GetSupportedShaderBlobType() const override;
     uint64_t GetConstantBufferOffsetAlignment() const override;
+    double GetTimestampPeriod() const override;
+    PipelineDescCacheStats GetPipelineDescCacheStats() const override;
 
     DXAdapter& GetAdapter();
     ComPtr<ID3D12Device> GetDevice();
@@ -107,9 +114,13 @@ private:
     bool is_variable_rate_shading_supported_ = false;
     bool is_mesh_shading_supported_ = false;
     uint32_t shading_rate_image_tile_size_ = 0;
+    uint32_t min_subgroup_size_ = 0;
+    uint32_t max_subgroup_size_ = 0;
     bool is_under_graphics_debugger_ = false;
     bool is_create_not_zeroed_available_ = false;
     bool is_aniso_filter_with_point_mip_supported_ = false;
+    double timestamp_period_ = 0;
     std::map<std::pair<D3D12_INDIRECT_ARGUMENT_TYPE, uint32_t>, ComPtr<ID3D12CommandSignature>>
         command_signature_cache_;
+    PipelineDescCache pipeline_desc_cache_;
 };
@@ -7,8 +7,10 @@
 #include "Instance/BaseTypes.h"
 #include "Memory/Memory.h"
 #include "Pipeline/Pipeline.h"
+#include "Pipeline/PipelineDescCache.h"
 #include "QueryHeap/QueryHeap.h"
 #include "Shader/Shader.h"
+#include "Shader/ShaderBundle.h"
 #include "Swapchain/Swapchain.h"
 
 #include <gli/format.hpp>
@@ -55,6 +57,7 @@ public:
     virtual std::shared_ptr<Shader> CreateShader(const std::vector<uint8_t>& blob,
                                                  ShaderBlobType blob_type,
                                                  ShaderType shader_type) = 0;
+    virtual std::shared_ptr<Shader> CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name) = 0;
     virtual std::shared_ptr<Shader> CompileShader(const ShaderDesc& desc) = 0;
     virtual std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) = 0;
     virtual std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) = 0;
@@ -69,7 +72,11 @@ public:
     virtual bool IsGeometryShaderSupported() const = 0;
     virtual bool IsBindlessSupported() const = 0;
     virtual bool IsSamplerFilterMinmaxSupported() const = 0;
+    virtual bool IsConditionalRenderingSupported() const = 0;
+    virtual DynamicStateFlags GetSupportedDynamicStates() const = 0;
     virtual uint32_t GetShadingRateImageTileSize() const = 0;
+    virtual uint32_t GetMinSubgroupSize() const = 0;
+    virtual uint32_t GetMaxSubgroupSize() const = 0;
     virtual MemoryBudget GetMemoryBudget() const = 0;
     virtual uint32_t GetShaderGroupHandleSize() const = 0;
     virtual uint32_t GetShaderRecordAlignment() const = 0;
@@ -80,4 +87,6 @@ public:
                                                          BuildAccelerationStructureFlags flags) const = 0;
     virtual ShaderBlobType GetSupportedShaderBlobType() const = 0;
     virtual uint64_t GetConstantBufferOffsetAlignment() const = 0;
+    virtual double GetTimestampPeriod() const = 0;
+    virtual PipelineDescCacheStats GetPipelineDescCacheStats() const = 0;
 };
@@ -44,6 +44,7 @@ public:
     std::shared_ptr<Shader> CreateShader(const std::vector<uint8_t>& blob,
                                          ShaderBlobType blob_type,
                                          ShaderType shader_type) override;
+    std::shared_ptr<Shader> CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name) override;
     std::shared_ptr<Shader> CompileShader(const ShaderDesc& desc) override;
     std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override;
@@ -58,7 +59,11 @@ public:
     bool IsGeometryShaderSupported() const override;
     bool IsBindlessSupported() const override;
     bool IsSamplerFilterMinmaxSupported() const override;
+    bool IsConditionalRenderingSupported() const override;
+    DynamicStateFlags GetSupportedDynamicStates() const override;
     uint32_t GetShadingRateImageTileSize() const override;
+    uint32_t GetMinSubgroupSize() const override;
+    uint32_t GetMaxSubgroupSize() const override;
     MemoryBudget GetMemoryBudget() const override;
     uint32_t GetShaderGroupHandleSize() const override;
     uint32_t GetShaderRecordAlignment() const override;
@@ -69,6 +74,8 @@ public:
                                                  BuildAccelerationStructureFlags flags) const override;
     ShaderBlobType GetSupportedShaderBlobType() const override;
     uint64_t GetConstantBufferOffsetAlignment() const override;
+    double GetTimestampPeriod() const override;
+    PipelineDescCacheStats GetPipelineDescCacheStats() const override;
 
     id<MTLDevice> GetDevice() const;
     MTLPixelFormat GetMTLPixelFormat(gli::format format);
@@ -97,6 +104,7 @@ private:
     std::shared_ptr<MTCommandQueue> command_queue_;
     MTGPUBindlessArgumentBuffer bindless_argument_buffer_;
     id<MTL4Compiler> compiler_ = nullptr;
+    PipelineDescCache pipeline_desc_cache_;
 };
 
 MTL4AccelerationStructureTriangleGeometryDescriptor* FillRaytracingGeometryDesc(
@@ -19,6 +19,7 @@
 #include "Resource/MTTexture.h"
 #include "Shader/MTShader.h"
 #include "Swapchain/MTSwapchain.h"
+#include "Utilities/Check.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 #include "View/MTView.h"
@@ -191,6 +192,13 @@ std::shared_ptr<Shader> MTDevice::CreateShader(const std::vector<uint8_t>& blob,
     return std::make_shared<MTShader>(*this, blob, blob_type, shader_type);
 }
 
+std::shared_ptr<Shader> MTDevice::CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name)
+{
+    auto shader = bundle.GetShader(name, kShaderBlobType);
+    CHECK(shader, "Shader {} is missing in the bundle", name);
+    return std::make_shared<MTShader>(*this, *shader);
+}
+
 std::shared_ptr<Shader> MTDevice::CompileShader(const ShaderDesc& desc)
 {
     return std::make_shared<MTShader>(*this, Compile(desc, kShaderBlobType), kShaderBlobType, desc.type);
@@ -198,12 +206,12 @@ std::shared_ptr<Shader> MTDevice::CompileShader(const ShaderDesc& desc)
 
 std::shared_ptr<Pipeline> MTDevice::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
 {
-    return std::make_shared<MTGraphicsPipeline>(*this, desc);
+    return pipeline_desc_cache_.GetOrCreate(desc, [&] { return std::make_shared<MTGraphicsPipeline>(*this, desc); });
 }
 
 std::shared_ptr<Pipeline> MTDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
 {
-    return std::make_shared<MTComputePipeline>(*this, desc);
+    return pipeline_desc_cache_.GetOrCreate(desc, [&] { return std::make_shared<MTComputePipeline>(*this, desc); });
 }
 
 std::shared_ptr<Pipeline> MTDevice::CreateRayTracingPipeline(const RayTracingPipelineDesc& desc)
@@ -264,11 +272,32 @@ bool MTDevice::IsSamplerFilterMinmaxSupported() const
     return true;
 }
 
+bool MTDevice::IsConditionalRenderingSupported() const
+{
+    return false;
+}
+
+DynamicStateFlags MTDevice::GetSupportedDynamicStates() const
+{
+    return DynamicStateFlags::kPrimitiveTopology | DynamicStateFlags::kCullMode | DynamicStateFlags::kFrontFace;
+}
+
 uint32_t MTDevice::GetShadingRateImageTileSize() const
 {
     NOTREACHED();
 }
 
+// Apple GPUs execute SIMD-groups of 32 threads.
+uint32_t MTDevice::GetMinSubgroupSize() const
+{
+    return 32;
+}
+
+uint32_t MTDevice::GetMaxSubgroupSize() const
+{
+    return 32;
+}
+
 MemoryBudget MTDevice::GetMemoryBudget() const
 {
     NOTREACHED();
@@ -369,6 +398,16 @@ uint64_t MTDevice::GetConstantBufferOffsetAlignment() const
     return 16;
 }
 
+double MTDevice::GetTimestampPeriod() const
+{
+    return 0;
+}
+
+PipelineDescCacheStats MTDevice::GetPipelineDescCacheStats() const
+{
+    return pipeline_desc_cache_.GetStats();
+}
+
 id<MTLDevice> MTDevice::GetDevice() const
 {
     return device_;
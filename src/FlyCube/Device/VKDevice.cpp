@@ -17,12 +17,20 @@
 #include "Resource/VKBuffer.h"
 #include "Resource/VKSampler.h"
 #include "Resource/VKTexture.h"
-#include "Shader/ShaderBase.h"
+#include "Shader/VKShader.h"
 #include "Swapchain/VKSwapchain.h"
+#include "Utilities/Check.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/SystemUtils.h"
+#include "Utilities/Trace.h"
 #include "View/VKView.h"
 
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <set>
 #include <string_view>
 #include <type_traits>
@@ -48,6 +56,18 @@ std::pair<uint32_t, uint32_t> ConvertShadingRateToPair(ShadingRate shading_rate)
     return { size.width, size.height };
 }
 
+bool IsPipelineCacheCompatible(const std::vector<uint8_t>& data, const vk::PhysicalDeviceProperties& properties)
+{
+    VkPipelineCacheHeaderVersionOne header = {};
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    return header.headerSize >= sizeof(header) && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
 } // namespace
 
 vk::ImageLayout ConvertState(ResourceState state)
@@ -189,7 +209,9 @@ VKDevice::VKDevice(VKAdapter& adapter)
     : adapter_(adapter)
     , physical_device_(adapter.GetPhysicalDevice())
     , gpu_descriptor_pool_(*this)
+    , layout_cache_(*this)
 {
+    TRACE_SCOPE("VKDevice::VKDevice");
     device_properties_ = physical_device_.getProperties();
     Logging::Println("{}: Vulkan {}.{}.{}", device_properties_.deviceName.data(),
                      VK_VERSION_MAJOR(device_properties_.apiVersion), VK_VERSION_MINOR(device_properties_.apiVersion),
@@ -220,11 +242,15 @@ VKDevice::VKDevice(VKAdapter& adapter)
     auto extensions = physical_device_.enumerateDeviceExtensionProperties();
     std::set<std::string_view> requested_extensions = {
         // clang-format off
+        VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME,
+        VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
+        VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
         VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
         VK_EXT_MESH_SHADER_EXTENSION_NAME,
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
         VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME,
+        VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
         VK_KHR_RAY_QUERY_EXTENSION_NAME,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -232,7 +258,10 @@ VKDevice::VKDevice(VKAdapter& adapter)
     };
 
     if (device_properties_.apiVersion < VK_API_VERSION_1_3) {
+        requested_extensions.insert(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
         requested_extensions.insert(VK_EXT_INLINE_UNIFORM_BLOCK_EXTENSION_NAME);
+        requested_extensions.insert(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+        requested_extensions.insert(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
         requested_extensions.insert(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
     }
 
@@ -270,8 +299,12 @@ VKDevice::VKDevice(VKAdapter& adapter)
     device_features.shaderImageGatherExtended = query_device_features.shaderImageGatherExtended;
     device_features.textureCompressionBC = query_device_features.textureCompressionBC;
     device_features.vertexPipelineStoresAndAtomics = query_device_features.vertexPipelineStoresAndAtomics;
+    device_features.pipelineStatisticsQuery = query_device_features.pipelineStatisticsQuery;
+    device_features.occlusionQueryPrecise = query_device_features.occlusionQueryPrecise;
 
     geometry_shader_supported_ = device_features.geometryShader;
+    pipeline_statistics_query_supported_ = device_features.pipelineStatisticsQuery;
+    occlusion_query_precise_supported_ = device_features.occlusionQueryPrecise;
 
     vk::PhysicalDeviceVulkan12Features device_vulkan12_features = {};
     auto query_device_vulkan12_features = GetFeatures2<vk::PhysicalDeviceVulkan12Features>();
@@ -290,6 +323,8 @@ VKDevice::VKDevice(VKAdapter& adapter)
     assert(query_device_vulkan12_features.samplerMirrorClampToEdge);
     device_vulkan12_features.samplerMirrorClampToEdge = true;
     device_vulkan12_features.samplerFilterMinmax = query_device_vulkan12_features.samplerFilterMinmax;
+    assert(query_device_vulkan12_features.hostQueryReset);
+    device_vulkan12_features.hostQueryReset = true;
 
     has_buffer_device_address_ = device_vulkan12_features.bufferDeviceAddress;
     draw_indirect_count_supported_ = device_vulkan12_features.drawIndirectCount;
@@ -346,6 +381,104 @@ VKDevice::VKDevice(VKAdapter& adapter)
         }
     }
 
+    // Without subgroup size control every pipeline runs with the default subgroup size.
+    auto subgroup_properties = GetProperties2<vk::PhysicalDeviceSubgroupProperties>();
+    default_subgroup_size_ = subgroup_properties.subgroupSize;
+    min_subgroup_size_ = default_subgroup_size_;
+    max_subgroup_size_ = default_subgroup_size_;
+    vk::PhysicalDeviceSubgroupSizeControlFeatures subgroup_size_control_features = {};
+    if (device_properties_.apiVersion >= VK_API_VERSION_1_3 ||
+        enabled_extension_set.contains(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME)) {
+        auto query_subgroup_size_control_features = GetFeatures2<vk::PhysicalDeviceSubgroupSizeControlFeatures>();
+        subgroup_size_control_features.subgroupSizeControl = query_subgroup_size_control_features.subgroupSizeControl;
+        subgroup_size_control_features.computeFullSubgroups =
+            query_subgroup_size_control_features.computeFullSubgroups;
+
+        auto subgroup_size_control_properties = GetProperties2<vk::PhysicalDeviceSubgroupSizeControlProperties>();
+        if (subgroup_size_control_features.subgroupSizeControl) {
+            min_subgroup_size_ = subgroup_size_control_properties.minSubgroupSize;
+            max_subgroup_size_ = subgroup_size_control_properties.maxSubgroupSize;
+            subgroup_size_control_supported_ = !!(subgroup_size_control_properties.requiredSubgroupSizeStages &
+                                                  vk::ShaderStageFlagBits::eCompute);
+        }
+        compute_full_subgroups_supported_ = subgroup_size_control_features.computeFullSubgroups;
+        max_compute_workgroup_subgroups_ = subgroup_size_control_properties.maxComputeWorkgroupSubgroups;
+
+        // The core features can not be chained next to PhysicalDeviceVulkan13Features.
+        if (device_properties_.apiVersion >= VK_API_VERSION_1_3) {
+            device_vulkan13_features.subgroupSizeControl = subgroup_size_control_features.subgroupSizeControl;
+            device_vulkan13_features.computeFullSubgroups = subgroup_size_control_features.computeFullSubgroups;
+        } else {
+            add_extension(subgroup_size_control_features);
+        }
+    }
+
+    pipeline_creation_feedback_supported_ =
+        device_properties_.apiVersion >= VK_API_VERSION_1_3 ||
+        enabled_extension_set.contains(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+    vk::PhysicalDeviceConditionalRenderingFeaturesEXT conditional_rendering_features = {};
+    if (enabled_extension_set.contains(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME)) {
+        auto query_conditional_rendering_features = GetFeatures2<vk::PhysicalDeviceConditionalRenderingFeaturesEXT>();
+        conditional_rendering_features.conditionalRendering = query_conditional_rendering_features.conditionalRendering;
+
+        conditional_rendering_supported_ = conditional_rendering_features.conditionalRendering;
+        add_extension(conditional_rendering_features);
+    }
+
+    const DynamicStateFlags extended_dynamic_states = DynamicStateFlags::kPrimitiveTopology |
+                                                      DynamicStateFlags::kCullMode | DynamicStateFlags::kFrontFace |
+                                                      DynamicStateFlags::kDepthStencil;
+    vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT extended_dynamic_state_features = {};
+    if (device_properties_.apiVersion >= VK_API_VERSION_1_3) {
+        supported_dynamic_states_ |= extended_dynamic_states;
+    } else if (enabled_extension_set.contains(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+        auto query_extended_dynamic_state_features = GetFeatures2<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+        extended_dynamic_state_features.extendedDynamicState =
+            query_extended_dynamic_state_features.extendedDynamicState;
+
+        if (extended_dynamic_state_features.extendedDynamicState) {
+            supported_dynamic_states_ |= extended_dynamic_states;
+        }
+        add_extension(extended_dynamic_state_features);
+    }
+
+    vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT extended_dynamic_state3_features = {};
+    if (enabled_extension_set.contains(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+        auto query_extended_dynamic_state3_features =
+            GetFeatures2<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
+        extended_dynamic_state3_features.extendedDynamicState3ColorBlendEnable =
+            query_extended_dynamic_state3_features.extendedDynamicState3ColorBlendEnable;
+        extended_dynamic_state3_features.extendedDynamicState3ColorBlendEquation =
+            query_extended_dynamic_state3_features.extendedDynamicState3ColorBlendEquation;
+        extended_dynamic_state3_features.extendedDynamicState3ColorWriteMask =
+            query_extended_dynamic_state3_features.extendedDynamicState3ColorWriteMask;
+
+        if (extended_dynamic_state3_features.extendedDynamicState3ColorBlendEnable &&
+            extended_dynamic_state3_features.extendedDynamicState3ColorBlendEquation &&
+            extended_dynamic_state3_features.extendedDynamicState3ColorWriteMask) {
+            supported_dynamic_states_ |= DynamicStateFlags::kBlend;
+        }
+        add_extension(extended_dynamic_state3_features);
+    }
+
+    vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_features = {};
+    if (enabled_extension_set.contains(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        enabled_extension_set.contains(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        GetEnvironmentVar("FLYCUBE_PIPELINE_LIBRARY") != "0") {
+        auto query_graphics_pipeline_library_features =
+            GetFeatures2<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+        graphics_pipeline_library_features.graphicsPipelineLibrary =
+            query_graphics_pipeline_library_features.graphicsPipelineLibrary;
+
+        auto graphics_pipeline_library_properties =
+            GetProperties2<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
+        graphics_pipeline_library_supported_ = graphics_pipeline_library_features.graphicsPipelineLibrary;
+        graphics_pipeline_library_fast_linking_ =
+            graphics_pipeline_library_properties.graphicsPipelineLibraryFastLinking;
+        add_extension(graphics_pipeline_library_features);
+    }
+
     vk::PhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features = {};
     if (enabled_extension_set.contains(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
         auto query_mesh_shader_features = GetFeatures2<vk::PhysicalDeviceMeshShaderFeaturesEXT>();
@@ -472,10 +605,57 @@ VKDevice::VKDevice(VKAdapter& adapter)
         command_queues_[queue_info.first] =
             std::make_shared<VKCommandQueue>(*this, queue_info.first, queue_info.second.queue_family_index);
     }
+
+    CreatePipelineCache();
+
+    // FLYCUBE_SHARE_SHADER_MODULES=0 creates a module per pipeline again, e.g. to compare creation times.
+    shader_module_sharing_enabled_ = GetEnvironmentVar("FLYCUBE_SHARE_SHADER_MODULES") != "0";
+
+    // Fast-linked pipelines are replaced by link-time optimized ones once they are ready.
+    if (graphics_pipeline_library_supported_ && graphics_pipeline_library_fast_linking_ &&
+        GetEnvironmentVar("FLYCUBE_PIPELINE_LIBRARY_OPTIMIZE") != "0") {
+        pipeline_link_thread_pool_ = std::make_unique<ThreadPool>(1);
+    }
+}
+
+VKDevice::~VKDevice()
+{
+    if (pipeline_link_thread_pool_) {
+        pipeline_link_thread_pool_->WaitIdle();
+    }
+    SavePipelineCache();
+}
+
+void VKDevice::CreatePipelineCache()
+{
+    TRACE_SCOPE("VKDevice::CreatePipelineCache");
+    pipeline_cache_path_ = GetEnvironmentVar("FLYCUBE_PIPELINE_CACHE");
+    if (pipeline_cache_path_.empty()) {
+        pipeline_cache_path_ = GetExecutableDir() + "/VKPipelineCache.bin";
+    }
+
+    std::vector<uint8_t> data;
+    std::ifstream file(pipeline_cache_path_, std::ios::binary);
+    if (file) {
+        file.unsetf(std::ios::skipws);
+        data.insert(data.begin(), std::istream_iterator<uint8_t>(file), std::istream_iterator<uint8_t>());
+    }
+
+    if (!data.empty() && !IsPipelineCacheCompatible(data, device_properties_)) {
+        Logging::Println("Pipeline cache {} was created for another device or driver, ignoring it",
+                         pipeline_cache_path_);
+        data.clear();
+    }
+
+    vk::PipelineCacheCreateInfo pipeline_cache_info = {};
+    pipeline_cache_info.initialDataSize = data.size();
+    pipeline_cache_info.pInitialData = data.data();
+    pipeline_cache_ = device_->createPipelineCacheUnique(pipeline_cache_info);
 }
 
 std::shared_ptr<Memory> VKDevice::AllocateMemory(uint64_t size, MemoryType memory_type, uint32_t memory_type_bits)
 {
+    TRACE_SCOPE("VKDevice::AllocateMemory");
     return std::make_shared<VKMemory>(*this, size, memory_type, memory_type_bits, nullptr);
 }
 
@@ -495,17 +675,20 @@ std::shared_ptr<Swapchain> VKDevice::CreateSwapchain(const NativeSurface& surfac
                                                      uint32_t frame_count,
                                                      bool vsync)
 {
+    TRACE_SCOPE("VKDevice::CreateSwapchain");
     return std::make_shared<VKSwapchain>(*command_queues_.at(CommandListType::kGraphics), surface, width, height,
                                          frame_count, vsync);
 }
 
 std::shared_ptr<CommandList> VKDevice::CreateCommandList(CommandListType type)
 {
+    TRACE_SCOPE("VKDevice::CreateCommandList");
     return std::make_shared<VKCommandList>(*this, type);
 }
 
 std::shared_ptr<Fence> VKDevice::CreateFence(uint64_t initial_value)
 {
+    TRACE_SCOPE("VKDevice::CreateFence");
     return std::make_shared<VKTimelineSemaphore>(*this, initial_value);
 }
 
@@ -523,6 +706,7 @@ std::shared_ptr<Resource> VKDevice::CreatePlacedTexture(const std::shared_ptr<Me
                                                         uint64_t offset,
                                                         const TextureDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreatePlacedTexture");
     auto texture = VKTexture::CreateImage(*this, desc);
     if (texture) {
         texture->BindMemory(memory, offset);
@@ -534,6 +718,7 @@ std::shared_ptr<Resource> VKDevice::CreatePlacedBuffer(const std::shared_ptr<Mem
                                                        uint64_t offset,
                                                        const BufferDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreatePlacedBuffer");
     auto buffer = VKBuffer::CreateBuffer(*this, desc);
     if (buffer) {
         buffer->BindMemory(memory, offset);
@@ -543,6 +728,7 @@ std::shared_ptr<Resource> VKDevice::CreatePlacedBuffer(const std::shared_ptr<Mem
 
 std::shared_ptr<Resource> VKDevice::CreateTexture(MemoryType memory_type, const TextureDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreateTexture");
     auto texture = VKTexture::CreateImage(*this, desc);
     if (texture) {
         texture->CommitMemory(memory_type);
@@ -552,6 +738,7 @@ std::shared_ptr<Resource> VKDevice::CreateTexture(MemoryType memory_type, const
 
 std::shared_ptr<Resource> VKDevice::CreateBuffer(MemoryType memory_type, const BufferDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreateBuffer");
     auto buffer = VKBuffer::CreateBuffer(*this, desc);
     if (buffer) {
         buffer->CommitMemory(memory_type);
@@ -561,26 +748,31 @@ std::shared_ptr<Resource> VKDevice::CreateBuffer(MemoryType memory_type, const B
 
 std::shared_ptr<Resource> VKDevice::CreateSampler(const SamplerDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreateSampler");
     return VKSampler::CreateSampler(*this, desc);
 }
 
 std::shared_ptr<View> VKDevice::CreateView(const std::shared_ptr<Resource>& resource, const ViewDesc& view_desc)
 {
+    TRACE_SCOPE("VKDevice::CreateView");
     return std::make_shared<VKView>(*this, std::static_pointer_cast<VKResource>(resource), view_desc);
 }
 
 std::shared_ptr<BindlessTypedViewPool> VKDevice::CreateBindlessTypedViewPool(ViewType view_type, uint32_t view_count)
 {
+    TRACE_SCOPE("VKDevice::CreateBindlessTypedViewPool");
     return std::make_shared<VKBindlessTypedViewPool>(*this, view_type, view_count);
 }
 
 std::shared_ptr<BindingSetLayout> VKDevice::CreateBindingSetLayout(const BindingSetLayoutDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreateBindingSetLayout");
     return std::make_shared<VKBindingSetLayout>(*this, desc);
 }
 
 std::shared_ptr<BindingSet> VKDevice::CreateBindingSet(const std::shared_ptr<BindingSetLayout>& layout)
 {
+    TRACE_SCOPE("VKDevice::CreateBindingSet");
     return std::make_shared<VKBindingSet>(*this, std::static_pointer_cast<VKBindingSetLayout>(layout));
 }
 
@@ -588,26 +780,39 @@ std::shared_ptr<Shader> VKDevice::CreateShader(const std::vector<uint8_t>& blob,
                                                ShaderBlobType blob_type,
                                                ShaderType shader_type)
 {
-    return std::make_shared<ShaderBase>(blob, blob_type, shader_type);
+    TRACE_SCOPE("VKDevice::CreateShader");
+    return std::make_shared<VKShader>(*this, blob, blob_type, shader_type);
+}
+
+std::shared_ptr<Shader> VKDevice::CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name)
+{
+    TRACE_SCOPE("VKDevice::CreateShaderFromBundle");
+    auto shader = bundle.GetShader(name, ShaderBlobType::kSPIRV);
+    CHECK(shader, "Shader {} is missing in the bundle", name);
+    return std::make_shared<VKShader>(*this, *shader);
 }
 
 std::shared_ptr<Shader> VKDevice::CompileShader(const ShaderDesc& desc)
 {
-    return std::make_shared<ShaderBase>(Compile(desc, ShaderBlobType::kSPIRV), ShaderBlobType::kSPIRV, desc.type);
+    TRACE_SCOPE("VKDevice::CompileShader");
+    return std::make_shared<VKShader>(*this, Compile(desc, ShaderBlobType::kSPIRV), ShaderBlobType::kSPIRV, desc.type);
 }
 
 std::shared_ptr<Pipeline> VKDevice::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
 {
-    return std::make_shared<VKGraphicsPipeline>(*this, desc);
+    TRACE_SCOPE("VKDevice::CreateGraphicsPipeline");
+    return pipeline_desc_cache_.GetOrCreate(desc, [&] { return std::make_shared<VKGraphicsPipeline>(*this, desc); });
 }
 
 std::shared_ptr<Pipeline> VKDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
 {
-    return std::make_shared<VKComputePipeline>(*this, desc);
+    TRACE_SCOPE("VKDevice::CreateComputePipeline");
+    return pipeline_desc_cache_.GetOrCreate(desc, [&] { return std::make_shared<VKComputePipeline>(*this, desc); });
 }
 
 std::shared_ptr<Pipeline> VKDevice::CreateRayTracingPipeline(const RayTracingPipelineDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreateRayTracingPipeline");
     return std::make_shared<VKRayTracingPipeline>(*this, desc);
 }
 
@@ -659,15 +864,32 @@ RaytracingASPrebuildInfo VKDevice::GetAccelerationStructurePrebuildInfo(
 
 std::shared_ptr<Resource> VKDevice::CreateAccelerationStructure(const AccelerationStructureDesc& desc)
 {
+    TRACE_SCOPE("VKDevice::CreateAccelerationStructure");
     return VKAccelerationStructure::CreateAccelerationStructure(*this, desc);
 }
 
 std::shared_ptr<QueryHeap> VKDevice::CreateQueryHeap(QueryHeapType type, uint32_t count)
 {
-    if (type == QueryHeapType::kAccelerationStructureCompactedSize) {
+    TRACE_SCOPE("VKDevice::CreateQueryHeap");
+    switch (type) {
+    case QueryHeapType::kAccelerationStructureCompactedSize:
+    case QueryHeapType::kTimestamp:
+        return std::make_shared<VKQueryHeap>(*this, type, count);
+    case QueryHeapType::kPipelineStatistics:
+        if (!pipeline_statistics_query_supported_) {
+            return nullptr;
+        }
+        return std::make_shared<VKQueryHeap>(*this, type, count);
+    case QueryHeapType::kOcclusion:
+        if (!occlusion_query_precise_supported_) {
+            return nullptr;
+        }
+        return std::make_shared<VKQueryHeap>(*this, type, count);
+    case QueryHeapType::kBinaryOcclusion:
         return std::make_shared<VKQueryHeap>(*this, type, count);
+    default:
+        return nullptr;
     }
-    return nullptr;
 }
 
 bool VKDevice::IsDxrSupported() const
@@ -710,11 +932,31 @@ bool VKDevice::IsSamplerFilterMinmaxSupported() const
     return sampler_filter_minmax_supported_;
 }
 
+bool VKDevice::IsConditionalRenderingSupported() const
+{
+    return conditional_rendering_supported_;
+}
+
+DynamicStateFlags VKDevice::GetSupportedDynamicStates() const
+{
+    return supported_dynamic_states_;
+}
+
 uint32_t VKDevice::GetShadingRateImageTileSize() const
 {
     return shading_rate_image_tile_size_;
 }
 
+uint32_t VKDevice::GetMinSubgroupSize() const
+{
+    return min_subgroup_size_;
+}
+
+uint32_t VKDevice::GetMaxSubgroupSize() const
+{
+    return max_subgroup_size_;
+}
+
 MemoryBudget VKDevice::GetMemoryBudget() const
 {
     auto memory_budget = GetMemoryProperties2<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
@@ -787,6 +1029,19 @@ uint64_t VKDevice::GetConstantBufferOffsetAlignment() const
     return device_properties_.limits.minUniformBufferOffsetAlignment;
 }
 
+double VKDevice::GetTimestampPeriod() const
+{
+    if (!device_properties_.limits.timestampComputeAndGraphics) {
+        return 0;
+    }
+    return device_properties_.limits.timestampPeriod;
+}
+
+PipelineDescCacheStats VKDevice::GetPipelineDescCacheStats() const
+{
+    return pipeline_desc_cache_.GetStats();
+}
+
 VKAdapter& VKDevice::GetAdapter()
 {
     return adapter_;
@@ -892,3 +1147,141 @@ const InlineUniformBlockProperties& VKDevice::GetInlineUniformBlockProperties()
 {
     return inline_uniform_block_properties_;
 }
+
+vk::PipelineCache VKDevice::GetPipelineCache() const
+{
+    return pipeline_cache_.get();
+}
+
+bool VKDevice::SavePipelineCache()
+{
+    TRACE_SCOPE("VKDevice::SavePipelineCache");
+    if (!pipeline_cache_) {
+        return false;
+    }
+
+    std::vector<uint8_t> data = device_->getPipelineCacheData(pipeline_cache_.get());
+    std::string tmp_path = GetTempFilePath(pipeline_cache_path_);
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file) {
+            Logging::Println("Failed to write pipeline cache {}", tmp_path);
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, pipeline_cache_path_, ec);
+    if (ec) {
+        Logging::Println("Failed to save pipeline cache {}: {}", pipeline_cache_path_, ec.message());
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+
+    PipelineCacheStats stats = GetPipelineCacheStats();
+    if (stats.hits + stats.misses > 0) {
+        Logging::Println("Pipeline cache: {} hits, {} misses, {:.2f} ms total creation time", stats.hits,
+                         stats.misses, stats.creation_time_ns / 1e6);
+    }
+    if (stats.shader_modules_created > 0) {
+        Logging::Println("Shader modules: {} created{}, {:.2f} ms total creation time", stats.shader_modules_created,
+                         shader_module_sharing_enabled_ ? "" : " (sharing disabled)",
+                         stats.shader_module_creation_time_ns / 1e6);
+    }
+    return true;
+}
+
+bool VKDevice::IsPipelineCreationFeedbackSupported() const
+{
+    return pipeline_creation_feedback_supported_;
+}
+
+void VKDevice::OnPipelineCreated(const vk::PipelineCreationFeedback& feedback)
+{
+    if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit) {
+        ++pipeline_cache_hits_;
+    } else {
+        ++pipeline_cache_misses_;
+    }
+    pipeline_creation_time_ns_ += feedback.duration;
+}
+
+vk::UniqueShaderModule VKDevice::CreateShaderModule(std::span<const uint8_t> blob)
+{
+    TRACE_SCOPE("VKDevice::CreateShaderModule");
+    vk::ShaderModuleCreateInfo shader_module_info = {};
+    shader_module_info.codeSize = blob.size();
+    shader_module_info.pCode = reinterpret_cast<const uint32_t*>(blob.data());
+
+    auto start = std::chrono::steady_clock::now();
+    vk::UniqueShaderModule shader_module = device_->createShaderModuleUnique(shader_module_info);
+    auto duration = std::chrono::steady_clock::now() - start;
+    ++shader_modules_created_;
+    shader_module_creation_time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    return shader_module;
+}
+
+bool VKDevice::IsShaderModuleSharingEnabled() const
+{
+    return shader_module_sharing_enabled_;
+}
+
+bool VKDevice::IsSubgroupSizeControlSupported() const
+{
+    return subgroup_size_control_supported_;
+}
+
+bool VKDevice::IsComputeFullSubgroupsSupported() const
+{
+    return compute_full_subgroups_supported_;
+}
+
+uint32_t VKDevice::GetMaxComputeWorkgroupSubgroups() const
+{
+    return max_compute_workgroup_subgroups_;
+}
+
+uint32_t VKDevice::GetDefaultSubgroupSize() const
+{
+    return default_subgroup_size_;
+}
+
+bool VKDevice::IsGraphicsPipelineLibrarySupported() const
+{
+    return graphics_pipeline_library_supported_;
+}
+
+bool VKDevice::HasGraphicsPipelineLibraryFastLinking() const
+{
+    return graphics_pipeline_library_fast_linking_;
+}
+
+VKLayoutCache& VKDevice::GetLayoutCache()
+{
+    return layout_cache_;
+}
+
+VKGraphicsPipelineLibraryCache& VKDevice::GetGraphicsPipelineLibraryCache()
+{
+    return graphics_pipeline_library_cache_;
+}
+
+ThreadPool* VKDevice::GetPipelineLinkThreadPool()
+{
+    return pipeline_link_thread_pool_.get();
+}
+
+PipelineCacheStats VKDevice::GetPipelineCacheStats() const
+{
+    return {
+        pipeline_cache_hits_.load(),
+        pipeline_cache_misses_.load(),
+        pipeline_creation_time_ns_.load(),
+        shader_modules_created_.load(),
+        shader_module_creation_time_ns_.load(),
+    };
+}
@@ -1,10 +1,17 @@
 #pragma once
+#include "BindingSetLayout/VKLayoutCache.h"
 #include "Device/Device.h"
 #include "GPUDescriptorPool/VKGPUBindlessDescriptorPoolTyped.h"
 #include "GPUDescriptorPool/VKGPUDescriptorPool.h"
+#include "Pipeline/VKGraphicsPipelineLibrary.h"
+#include "Utilities/ThreadPool.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <memory>
+#include <span>
+
 class VKAdapter;
 class VKCommandQueue;
 
@@ -15,6 +22,14 @@ struct InlineUniformBlockProperties {
     uint32_t max_blocks;
 };
 
+struct PipelineCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t creation_time_ns;
+    uint64_t shader_modules_created;
+    uint64_t shader_module_creation_time_ns;
+};
+
 vk::ImageLayout ConvertState(ResourceState state);
 vk::BuildAccelerationStructureFlagsKHR Convert(BuildAccelerationStructureFlags flags);
 vk::Extent2D ConvertShadingRate(ShadingRate shading_rate);
@@ -26,6 +41,7 @@ vk::CompareOp ConvertToCompareOp(ComparisonFunc func);
 class VKDevice : public Device {
 public:
     explicit VKDevice(VKAdapter& adapter);
+    ~VKDevice() override;
     std::shared_ptr<Memory> AllocateMemory(uint64_t size, MemoryType memory_type, uint32_t memory_type_bits) override;
     std::shared_ptr<CommandQueue> GetCommandQueue(CommandListType type) override;
     uint32_t GetTextureDataPitchAlignment() const override;
@@ -55,6 +71,7 @@ public:
     std::shared_ptr<Shader> CreateShader(const std::vector<uint8_t>& blob,
                                          ShaderBlobType blob_type,
                                          ShaderType shader_type) override;
+    std::shared_ptr<Shader> CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name) override;
     std::shared_ptr<Shader> CompileShader(const ShaderDesc& desc) override;
     std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override;
@@ -69,7 +86,11 @@ public:
     bool IsGeometryShaderSupported() const override;
     bool IsBindlessSupported() const override;
     bool IsSamplerFilterMinmaxSupported() const override;
+    bool IsConditionalRenderingSupported() const override;
+    DynamicStateFlags GetSupportedDynamicStates() const override;
     uint32_t GetShadingRateImageTileSize() const override;
+    uint32_t GetMinSubgroupSize() const override;
+    uint32_t GetMaxSubgroupSize() const override;
     MemoryBudget GetMemoryBudget() const override;
     uint32_t GetShaderGroupHandleSize() const override;
     uint32_t GetShaderRecordAlignment() const override;
@@ -80,6 +101,8 @@ public:
                                                  BuildAccelerationStructureFlags flags) const override;
     ShaderBlobType GetSupportedShaderBlobType() const override;
     uint64_t GetConstantBufferOffsetAlignment() const override;
+    double GetTimestampPeriod() const override;
+    PipelineDescCacheStats GetPipelineDescCacheStats() const override;
 
     VKAdapter& GetAdapter();
     vk::Device GetDevice();
@@ -97,6 +120,23 @@ public:
     bool HasBufferDeviceAddress() const;
     bool IsInlineUniformBlockSupported() const;
     const InlineUniformBlockProperties& GetInlineUniformBlockProperties() const;
+    vk::PipelineCache GetPipelineCache() const;
+    bool SavePipelineCache();
+    bool IsPipelineCreationFeedbackSupported() const;
+    void OnPipelineCreated(const vk::PipelineCreationFeedback& feedback);
+    PipelineCacheStats GetPipelineCacheStats() const;
+    vk::UniqueShaderModule CreateShaderModule(std::span<const uint8_t> blob);
+    bool IsShaderModuleSharingEnabled() const;
+    bool IsSubgroupSizeControlSupported() const;
+    bool IsComputeFullSubgroupsSupported() const;
+    uint32_t GetMaxComputeWorkgroupSubgroups() const;
+    uint32_t GetDefaultSubgroupSize() const;
+    bool IsGraphicsPipelineLibrarySupported() const;
+    bool HasGraphicsPipelineLibraryFastLinking() const;
+    VKLayoutCache& GetLayoutCache();
+    VKGraphicsPipelineLibraryCache& GetGraphicsPipelineLibraryCache();
+    // Null when optimized re-linking in the background is disabled.
+    ThreadPool* GetPipelineLinkThreadPool();
 
     template <typename Features>
     Features GetFeatures2() const
@@ -123,6 +163,7 @@ private:
     RaytracingASPrebuildInfo GetAccelerationStructurePrebuildInfo(
         const vk::AccelerationStructureBuildGeometryInfoKHR& acceleration_structure_info,
         const std::vector<uint32_t>& max_primitive_counts) const;
+    void CreatePipelineCache();
 
     VKAdapter& adapter_;
     const vk::PhysicalDevice& physical_device_;
@@ -138,6 +179,12 @@ private:
     VKGPUDescriptorPool gpu_descriptor_pool_;
     bool is_variable_rate_shading_supported_ = false;
     uint32_t shading_rate_image_tile_size_ = 0;
+    uint32_t min_subgroup_size_ = 0;
+    uint32_t max_subgroup_size_ = 0;
+    uint32_t default_subgroup_size_ = 0;
+    bool subgroup_size_control_supported_ = false;
+    bool compute_full_subgroups_supported_ = false;
+    uint32_t max_compute_workgroup_subgroups_ = 0;
     bool is_dxr_supported_ = false;
     bool is_ray_query_supported_ = false;
     bool is_mesh_shading_supported_ = false;
@@ -145,6 +192,10 @@ private:
     uint32_t shader_record_alignment_ = 0;
     uint32_t shader_table_alignment_ = 0;
     bool geometry_shader_supported_ = false;
+    bool pipeline_statistics_query_supported_ = false;
+    bool occlusion_query_precise_supported_ = false;
+    bool conditional_rendering_supported_ = false;
+    DynamicStateFlags supported_dynamic_states_ = DynamicStateFlags::kNone;
     bool bindless_supported_ = false;
     bool sampler_filter_minmax_supported_ = false;
     bool draw_indirect_count_supported_ = false;
@@ -152,4 +203,19 @@ private:
     bool inline_uniform_block_supported_ = false;
     InlineUniformBlockProperties inline_uniform_block_properties_;
     vk::PhysicalDeviceProperties device_properties_ = {};
+    bool pipeline_creation_feedback_supported_ = false;
+    std::string pipeline_cache_path_;
+    vk::UniquePipelineCache pipeline_cache_;
+    std::atomic<uint64_t> pipeline_cache_hits_ = 0;
+    std::atomic<uint64_t> pipeline_cache_misses_ = 0;
+    std::atomic<uint64_t> pipeline_creation_time_ns_ = 0;
+    bool shader_module_sharing_enabled_ = true;
+    std::atomic<uint64_t> shader_modules_created_ = 0;
+    std::atomic<uint64_t> shader_module_creation_time_ns_ = 0;
+    PipelineDescCache pipeline_desc_cache_;
+    VKLayoutCache layout_cache_;
+    bool graphics_pipeline_library_supported_ = false;
+    bool graphics_pipeline_library_fast_linking_ = false;
+    VKGraphicsPipelineLibraryCache graphics_pipeline_library_cache_;
+    std::unique_ptr<ThreadPool> pipeline_link_thread_pool_;
 };
@@ -3,6 +3,7 @@
 #include "Device/DXDevice.h"
 #include "Utilities/DXUtility.h"
 #include "Utilities/SystemUtils.h"
+#include "Utilities/Trace.h"
 
 DXFence::DXFence(DXDevice& device, uint64_t initial_value)
     : device_(device)
@@ -20,6 +21,7 @@ uint64_t DXFence::GetCompletedValue()
 
 void DXFence::Wait(uint64_t value)
 {
+    TRACE_SCOPE("DXFence::Wait");
     if (GetCompletedValue() < value) {
         CHECK_HRESULT(fence_->SetEventOnCompletion(value, fence_event_));
 #if defined(_WIN32)
@@ -1,6 +1,7 @@
 #include "Fence/MTFence.h"
 
 #include "Device/MTDevice.h"
+#include "Utilities/Trace.h"
 
 MTFence::MTFence(MTDevice& device, uint64_t initial_value)
     : device_(device)
@@ -16,6 +17,7 @@ uint64_t MTFence::GetCompletedValue()
 
 void MTFence::Wait(uint64_t value)
 {
+    TRACE_SCOPE("MTFence::Wait");
     while (GetCompletedValue() < value) {
         [shared_event_ waitUntilSignaledValue:value timeoutMS:10];
     }
@@ -1,6 +1,7 @@
 #include "Fence/VKTimelineSemaphore.h"
 
 #include "Device/VKDevice.h"
+#include "Utilities/Trace.h"
 
 VKTimelineSemaphore::VKTimelineSemaphore(VKDevice& device, uint64_t initial_value)
     : device_(device)
@@ -20,6 +21,7 @@ uint64_t VKTimelineSemaphore::GetCompletedValue()
 
 void VKTimelineSemaphore::Wait(uint64_t value)
 {
+    TRACE_SCOPE("VKTimelineSemaphore::Wait");
     vk::SemaphoreWaitInfo wait_info = {};
     wait_info.semaphoreCount = 1;
     wait_info.pSemaphores = &timeline_semaphore_.get();
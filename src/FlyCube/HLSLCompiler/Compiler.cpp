@@ -1,14 +1,21 @@
 #include "HLSLCompiler/Compiler.h"
 
 #include "HLSLCompiler/DXCLoader.h"
+#include "HLSLCompiler/ShaderCache.h"
+#include "HLSLCompiler/ShaderServer.h"
+#include "HLSLCompiler/SourceFileCache.h"
+#include "Utilities/Check.h"
 #include "Utilities/DXUtility.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 #include "Utilities/SystemUtils.h"
+#include "Utilities/Trace.h"
 
 #include <nowide/convert.hpp>
 
 #include <deque>
+#include <format>
+#include <map>
 #include <vector>
 
 namespace {
@@ -35,6 +42,137 @@ std::string GetShaderTarget(ShaderType type, const std::string& model)
     }
 }
 
+std::string GetCompilerVersion(IDxcCompiler* compiler)
+{
+    std::string version;
+    CComPtr<IDxcVersionInfo> version_info;
+    if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&version_info)))) {
+        UINT32 major = 0;
+        UINT32 minor = 0;
+        version_info->GetVersion(&major, &minor);
+        version = std::format("{}.{}", major, minor);
+    }
+    CComPtr<IDxcVersionInfo2> version_info2;
+    if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&version_info2)))) {
+        UINT32 commit_count = 0;
+        char* commit_hash = nullptr;
+        if (SUCCEEDED(version_info2->GetCommitInfo(&commit_count, &commit_hash)) && commit_hash) {
+            version += std::format(".{}-{}", commit_count, commit_hash);
+            CoTaskMemFree(commit_hash);
+        }
+    }
+    return version;
+}
+
+struct DxcInstance {
+    CComPtr<IDxcLibrary> library;
+    CComPtr<IDxcCompiler> compiler;
+    std::string version;
+};
+
+DxcInstance& GetDxcInstance(ShaderBlobType blob_type)
+{
+    thread_local std::map<ShaderBlobType, DxcInstance> instances;
+    DxcInstance& instance = instances[blob_type];
+    if (!instance.compiler) {
+        decltype(auto) dxc_support = GetDxcSupport(blob_type);
+        CHECK_HRESULT(dxc_support.CreateInstance(CLSID_DxcLibrary, &instance.library));
+        CHECK_HRESULT(dxc_support.CreateInstance(CLSID_DxcCompiler, &instance.compiler));
+        instance.version = GetCompilerVersion(instance.compiler);
+    }
+    return instance;
+}
+
+CComPtr<IDxcBlobEncoding> CreateBlob(IDxcLibrary* library, const SourceFile& source_file)
+{
+    CComPtr<IDxcBlobEncoding> blob;
+    CHECK_HRESULT(library->CreateBlobWithEncodingFromPinned(source_file.data.data(), source_file.data.size(),
+                                                            DXC_CP_ACP, &blob));
+    return blob;
+}
+
+class CompileArguments {
+public:
+    CompileArguments(const ShaderDesc& shader, ShaderBlobType blob_type)
+        : target_(nowide::widen(GetShaderTarget(shader.type, shader.model)))
+        , entrypoint_(nowide::widen(shader.entrypoint))
+        , space_(std::to_wstring(static_cast<uint32_t>(shader.type)))
+    {
+        for (const auto& define : shader.define) {
+            defines_store_.emplace_back(nowide::widen(define.first), nowide::widen(define.second));
+        }
+        for (const auto& define : defines_store_) {
+            defines_.push_back({ define.first.c_str(), define.second.c_str() });
+        }
+
+        switch (shader.profile) {
+        case ShaderCompileProfile::kDebug:
+            arguments_.push_back(L"/Zi");
+            arguments_.push_back(L"/Qembed_debug");
+            break;
+        case ShaderCompileProfile::kRelease:
+            arguments_.push_back(L"/O3");
+            // SPIR-V debug info cannot be split from the module, so only DXIL keeps it in a side blob.
+            if (blob_type == ShaderBlobType::kDXIL) {
+                arguments_.push_back(L"/Zi");
+                arguments_.push_back(L"/Qstrip_debug");
+            }
+            break;
+        case ShaderCompileProfile::kSize:
+            arguments_.push_back(L"/O3");
+            break;
+        default:
+            NOTREACHED();
+        }
+        arguments_.push_back(L"-Werror");
+        if (blob_type == ShaderBlobType::kSPIRV) {
+            arguments_.emplace_back(L"-spirv");
+            arguments_.emplace_back(L"-fspv-target-env=vulkan1.2");
+            arguments_.emplace_back(L"-fspv-extension=KHR");
+            arguments_.emplace_back(L"-fspv-extension=SPV_EXT_descriptor_indexing");
+            arguments_.emplace_back(L"-fspv-extension=SPV_EXT_mesh_shader");
+            arguments_.emplace_back(L"-fspv-extension=SPV_EXT_shader_viewport_index_layer");
+            arguments_.emplace_back(L"-fspv-extension=SPV_GOOGLE_hlsl_functionality1");
+            arguments_.emplace_back(L"-fspv-extension=SPV_GOOGLE_user_type");
+            arguments_.emplace_back(L"-fvk-use-dx-layout");
+            // SPIRVReflection only needs the reflection decorations for vertex input semantics.
+            if (shader.profile == ShaderCompileProfile::kDebug || shader.type == ShaderType::kVertex) {
+                arguments_.emplace_back(L"-fspv-reflect");
+            }
+        }
+        arguments_.emplace_back(L"-auto-binding-space");
+        arguments_.emplace_back(space_.c_str());
+    }
+
+    const std::wstring& GetTarget() const
+    {
+        return target_;
+    }
+
+    const std::wstring& GetEntrypoint() const
+    {
+        return entrypoint_;
+    }
+
+    const std::vector<DxcDefine>& GetDefines() const
+    {
+        return defines_;
+    }
+
+    std::vector<LPCWSTR>& GetArguments()
+    {
+        return arguments_;
+    }
+
+private:
+    std::wstring target_;
+    std::wstring entrypoint_;
+    std::wstring space_;
+    std::deque<std::pair<std::wstring, std::wstring>> defines_store_;
+    std::vector<DxcDefine> defines_;
+    std::vector<LPCWSTR> arguments_;
+};
+
 } // namespace
 
 class IncludeHandler : public IDxcIncludeHandler {
@@ -61,71 +199,103 @@ public:
     HRESULT STDMETHODCALLTYPE LoadSource(_In_ LPCWSTR pFilename,
                                          _COM_Outptr_result_maybenull_ IDxcBlob** ppIncludeSource) override
     {
-        std::wstring path = base_path_ + pFilename;
-        CComPtr<IDxcBlobEncoding> source;
-        HRESULT hr = library_->CreateBlobFromFile(path.c_str(), nullptr, &source);
-        if (SUCCEEDED(hr) && ppIncludeSource) {
-            *ppIncludeSource = source.Detach();
+        std::string path = nowide::narrow(base_path_ + pFilename);
+        auto source_file = LoadSourceFile(path);
+        if (!source_file) {
+            return E_FAIL;
+        }
+        dependencies_[path] = source_file;
+        if (ppIncludeSource) {
+            *ppIncludeSource = CreateBlob(library_, *source_file).Detach();
         }
-        return hr;
+        return S_OK;
+    }
+
+    const std::map<std::string, std::shared_ptr<const SourceFile>>& GetDependencies() const
+    {
+        return dependencies_;
     }
 
 private:
     CComPtr<IDxcLibrary> library_;
     const std::wstring& base_path_;
+    // Keeps pinned include blobs alive until compilation is done.
+    std::map<std::string, std::shared_ptr<const SourceFile>> dependencies_;
 };
 
-std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type)
+std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type, CompileReport* report)
 {
-    decltype(auto) dxc_support = GetDxcSupport(blob_type);
+    TRACE_SCOPE("Compile");
+    std::vector<uint8_t> server_blob;
+    CompileReport server_report;
+    if (CompileOnShaderServer(shader, blob_type, server_blob, server_report)) {
+        if (report) {
+            *report = std::move(server_report);
+        } else if (!server_report.errors.empty()) {
+            Logging::Println("{}", shader.shader_path);
+            Logging::Println("{}", server_report.errors);
+        }
+        return server_blob;
+    }
+
+    DxcInstance& dxc_instance = GetDxcInstance(blob_type);
 
     std::wstring shader_path = nowide::widen(shader.shader_path);
     std::wstring shader_dir = shader_path.substr(0, shader_path.find_last_of(L"\\/") + 1);
 
-    CComPtr<IDxcLibrary> library;
-    dxc_support.CreateInstance(CLSID_DxcLibrary, &library);
-    CComPtr<IDxcBlobEncoding> source;
-    CHECK_HRESULT(library->CreateBlobFromFile(shader_path.c_str(), nullptr, &source));
-
-    std::wstring target = nowide::widen(GetShaderTarget(shader.type, shader.model));
-    std::wstring entrypoint = nowide::widen(shader.entrypoint);
-    std::vector<std::pair<std::wstring, std::wstring>> defines_store;
-    std::vector<DxcDefine> defines;
+    auto source_file = LoadSourceFile(shader.shader_path);
+    CHECK(source_file, "Failed to load {}", shader.shader_path);
+    CComPtr<IDxcBlobEncoding> source = CreateBlob(dxc_instance.library, *source_file);
+
+    CompileArguments args(shader, blob_type);
+    auto& arguments = args.GetArguments();
+    const auto& defines = args.GetDefines();
+    const auto& target = args.GetTarget();
+
+    std::string cache_key = std::format("{}|{}|{}|{}|{:016x}|{}", static_cast<uint32_t>(blob_type),
+                                        dxc_instance.version, nowide::narrow(target), shader.entrypoint,
+                                        source_file->hash, shader.shader_path);
+    for (const auto& argument : arguments) {
+        cache_key += "|" + nowide::narrow(argument);
+    }
     for (const auto& define : shader.define) {
-        defines_store.emplace_back(nowide::widen(define.first), nowide::widen(define.second));
-        defines.push_back({ defines_store.back().first.c_str(), defines_store.back().second.c_str() });
-    }
-
-    std::vector<LPCWSTR> arguments;
-    std::deque<std::wstring> dynamic_arguments;
-    arguments.push_back(L"/Zi");
-    arguments.push_back(L"/Qembed_debug");
-    arguments.push_back(L"-Werror");
-    if (blob_type == ShaderBlobType::kSPIRV) {
-        arguments.emplace_back(L"-spirv");
-        arguments.emplace_back(L"-fspv-target-env=vulkan1.2");
-        arguments.emplace_back(L"-fspv-extension=KHR");
-        arguments.emplace_back(L"-fspv-extension=SPV_EXT_descriptor_indexing");
-        arguments.emplace_back(L"-fspv-extension=SPV_EXT_mesh_shader");
-        arguments.emplace_back(L"-fspv-extension=SPV_EXT_shader_viewport_index_layer");
-        arguments.emplace_back(L"-fspv-extension=SPV_GOOGLE_hlsl_functionality1");
-        arguments.emplace_back(L"-fspv-extension=SPV_GOOGLE_user_type");
-        arguments.emplace_back(L"-fvk-use-dx-layout");
-        arguments.emplace_back(L"-fspv-reflect");
-    }
-
-    uint32_t space = static_cast<uint32_t>(shader.type);
-    arguments.emplace_back(L"-auto-binding-space");
-    dynamic_arguments.emplace_back(std::to_wstring(space));
-    arguments.emplace_back(dynamic_arguments.back().c_str());
+        cache_key += std::format("|-D{}={}", define.first, define.second);
+    }
+
+    auto fill_report = [&](ShaderCacheEntry& entry) {
+        if (!report) {
+            return;
+        }
+        report->dependencies.assign({ shader.shader_path });
+        for (const auto& dependency : entry.dependencies) {
+            report->dependencies.push_back(dependency.path);
+        }
+        report->debug_info = std::move(entry.debug_info);
+        report->debug_info_name = std::move(entry.debug_info_name);
+    };
+
+    if (auto entry = LoadCachedShader(cache_key)) {
+        fill_report(*entry);
+        return std::move(entry->blob);
+    }
 
     CComPtr<IDxcOperationResult> result;
-    IncludeHandler include_handler(library, shader_dir);
-    CComPtr<IDxcCompiler> compiler;
-    dxc_support.CreateInstance(CLSID_DxcCompiler, &compiler);
-    CHECK_HRESULT(compiler->Compile(source, L"main.hlsl", entrypoint.c_str(), target.c_str(), arguments.data(),
-                                    static_cast<UINT32>(arguments.size()), defines.data(),
-                                    static_cast<UINT32>(defines.size()), &include_handler, &result));
+    CComPtr<IDxcBlob> debug_blob;
+    LPWSTR debug_blob_name = nullptr;
+    IncludeHandler include_handler(dxc_instance.library, shader_dir);
+    CComPtr<IDxcCompiler2> compiler2;
+    if (shader.profile == ShaderCompileProfile::kRelease && blob_type == ShaderBlobType::kDXIL &&
+        SUCCEEDED(dxc_instance.compiler->QueryInterface(IID_PPV_ARGS(&compiler2)))) {
+        CHECK_HRESULT(compiler2->CompileWithDebug(source, L"main.hlsl", args.GetEntrypoint().c_str(), target.c_str(),
+                                                  arguments.data(), static_cast<UINT32>(arguments.size()),
+                                                  defines.data(), static_cast<UINT32>(defines.size()),
+                                                  &include_handler, &result, &debug_blob_name, &debug_blob));
+    } else {
+        CHECK_HRESULT(dxc_instance.compiler->Compile(source, L"main.hlsl", args.GetEntrypoint().c_str(),
+                                                     target.c_str(), arguments.data(),
+                                                     static_cast<UINT32>(arguments.size()), defines.data(),
+                                                     static_cast<UINT32>(defines.size()), &include_handler, &result));
+    }
 
     HRESULT hr = {};
     result->GetStatus(&hr);
@@ -135,13 +305,76 @@ std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type)
         CHECK_HRESULT(result->GetResult(&dxc_blob));
         blob.assign((uint8_t*)dxc_blob->GetBufferPointer(),
                     (uint8_t*)dxc_blob->GetBufferPointer() + dxc_blob->GetBufferSize());
+
+        ShaderCacheEntry entry = { .blob = blob };
+        for (const auto& [path, include_file] : include_handler.GetDependencies()) {
+            entry.dependencies.push_back({ path, include_file->hash });
+        }
+        if (debug_blob) {
+            entry.debug_info.assign((uint8_t*)debug_blob->GetBufferPointer(),
+                                    (uint8_t*)debug_blob->GetBufferPointer() + debug_blob->GetBufferSize());
+        }
+        if (debug_blob_name) {
+            entry.debug_info_name = nowide::narrow(debug_blob_name);
+        }
+        StoreCachedShader(cache_key, entry);
+        fill_report(entry);
     } else {
         CComPtr<IDxcBlobEncoding> errors;
         result->GetErrorBuffer(&errors);
-        if (errors && errors->GetBufferSize() > 0) {
+        if (errors && errors->GetBufferSize() > 0 && report) {
+            report->errors = static_cast<char*>(errors->GetBufferPointer());
+        } else if (errors && errors->GetBufferSize() > 0) {
             Logging::Println("{}", shader.shader_path);
             Logging::Println("{}", static_cast<char*>(errors->GetBufferPointer()));
         }
     }
+    if (debug_blob_name) {
+        CoTaskMemFree(debug_blob_name);
+    }
     return blob;
 }
+
+std::string Preprocess(const ShaderDesc& shader, ShaderBlobType blob_type, CompileReport* report)
+{
+    TRACE_SCOPE("Preprocess");
+    DxcInstance& dxc_instance = GetDxcInstance(blob_type);
+
+    std::wstring shader_path = nowide::widen(shader.shader_path);
+    std::wstring shader_dir = shader_path.substr(0, shader_path.find_last_of(L"\\/") + 1);
+
+    auto source_file = LoadSourceFile(shader.shader_path);
+    CHECK(source_file, "Failed to load {}", shader.shader_path);
+    CComPtr<IDxcBlobEncoding> source = CreateBlob(dxc_instance.library, *source_file);
+
+    CompileArguments args(shader, blob_type);
+    CComPtr<IDxcOperationResult> result;
+    IncludeHandler include_handler(dxc_instance.library, shader_dir);
+    CHECK_HRESULT(dxc_instance.compiler->Preprocess(
+        source, L"main.hlsl", args.GetArguments().data(), static_cast<UINT32>(args.GetArguments().size()),
+        args.GetDefines().data(), static_cast<UINT32>(args.GetDefines().size()), &include_handler, &result));
+
+    HRESULT hr = {};
+    result->GetStatus(&hr);
+    if (FAILED(hr)) {
+        CComPtr<IDxcBlobEncoding> errors;
+        result->GetErrorBuffer(&errors);
+        if (errors && errors->GetBufferSize() > 0 && report) {
+            report->errors = static_cast<char*>(errors->GetBufferPointer());
+        } else if (errors && errors->GetBufferSize() > 0) {
+            Logging::Println("{}", shader.shader_path);
+            Logging::Println("{}", static_cast<char*>(errors->GetBufferPointer()));
+        }
+        return {};
+    }
+
+    CComPtr<IDxcBlob> dxc_blob;
+    CHECK_HRESULT(result->GetResult(&dxc_blob));
+    if (report) {
+        report->dependencies.assign({ shader.shader_path });
+        for (const auto& [path, include_file] : include_handler.GetDependencies()) {
+            report->dependencies.push_back(path);
+        }
+    }
+    return std::string(static_cast<const char*>(dxc_blob->GetBufferPointer()), dxc_blob->GetBufferSize());
+}
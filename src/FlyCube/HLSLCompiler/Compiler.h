@@ -1,4 +1,19 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 
-std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type);
+#include <string>
+#include <vector>
+
+struct CompileReport {
+    std::vector<std::string> dependencies;
+    std::string errors;
+    // External debug info (PDB) produced by ShaderCompileProfile::kRelease for DXIL, named as the blob expects.
+    std::vector<uint8_t> debug_info;
+    std::string debug_info_name;
+};
+
+// Errors are logged unless a report is passed, in which case they are returned in it.
+std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type, CompileReport* report = nullptr);
+
+// Runs only the preprocessor, returns an empty string on failure.
+std::string Preprocess(const ShaderDesc& shader, ShaderBlobType blob_type, CompileReport* report = nullptr);
@@ -7,6 +7,7 @@
 #include <dxc/Support/Global.h>
 
 #include <filesystem>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -104,7 +105,9 @@ std::unique_ptr<dxc::DxcDllSupport> GetDxcSupportImpl(ShaderBlobType target)
 
 dxc::DxcDllSupport& GetDxcSupport(ShaderBlobType target)
 {
+    static std::mutex mutex;
     static std::map<ShaderBlobType, std::unique_ptr<dxc::DxcDllSupport>> cache;
+    std::lock_guard lock(mutex);
     auto it = cache.find(target);
     if (it == cache.end()) {
         it = cache.emplace(target, GetDxcSupportImpl(target)).first;
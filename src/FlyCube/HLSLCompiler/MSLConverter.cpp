@@ -1,12 +1,31 @@
 #include "HLSLCompiler/MSLConverter.h"
 
 #include "ShaderReflection/SPIRVReflection.h"
+#include "Utilities/BinaryStream.h"
 #include "Utilities/Check.h"
+#include "Utilities/Sha256.h"
 
 #include <spirv_msl.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace {
 
+constexpr uint32_t kMSLShaderMagic = 0x4c534d46; // "FMSL"
+constexpr uint32_t kMSLShaderVersion = 3;
+
+struct RegistryKey {
+    Sha256Digest spirv_digest;
+    ShaderType shader_type;
+
+    auto operator<=>(const RegistryKey&) const = default;
+};
+
+// Only holds offline shaders that were registered but not used yet, see RegisterMSLShader.
+std::mutex g_registry_mutex;
+std::map<RegistryKey, MSLShader> g_registry;
+
 std::map<BindKey, uint32_t> ParseBindings(ShaderType shader_type, const spirv_cross::CompilerMSL& compiler)
 {
     std::map<BindKey, uint32_t> mapping;
@@ -33,9 +52,32 @@ std::map<BindKey, uint32_t> ParseBindings(ShaderType shader_type, const spirv_cr
 } // namespace
 
 std::string GetMSLShader(ShaderType shader_type,
-                         const std::vector<uint8_t>& blob,
+                         std::span<const uint8_t> blob,
                          std::map<BindKey, uint32_t>& mapping,
                          std::string& entry_point)
+{
+    bool has_offline_shaders = false;
+    {
+        std::lock_guard lock(g_registry_mutex);
+        has_offline_shaders = !g_registry.empty();
+    }
+    MSLShader shader;
+    if (has_offline_shaders) {
+        RegistryKey key = { Sha256(blob), shader_type };
+        std::lock_guard lock(g_registry_mutex);
+        if (auto node = g_registry.extract(key)) {
+            shader = std::move(node.mapped());
+        }
+    }
+    if (shader.source.empty()) {
+        shader = ConvertToMSLShader(shader_type, blob);
+    }
+    mapping = std::move(shader.mapping);
+    entry_point = std::move(shader.entry_point);
+    return std::move(shader.source);
+}
+
+MSLShader ConvertToMSLShader(ShaderType shader_type, std::span<const uint8_t> blob)
 {
     assert(blob.size() % sizeof(uint32_t) == 0);
     spirv_cross::CompilerMSL compiler((const uint32_t*)blob.data(), blob.size() / sizeof(uint32_t));
@@ -43,11 +85,77 @@ std::string GetMSLShader(ShaderType shader_type,
     options.set_msl_version(4, 0);
     options.argument_buffers_tier = spirv_cross::CompilerMSL::Options::ArgumentBuffersTier::Tier2;
     compiler.set_msl_options(options);
-    auto msl_source = compiler.compile();
-    mapping = ParseBindings(shader_type, compiler);
+    MSLShader shader;
+    shader.source = compiler.compile();
+    shader.mapping = ParseBindings(shader_type, compiler);
     auto shader_entry_points = compiler.get_entry_points_and_stages();
     assert(!shader_entry_points.empty());
-    entry_point =
+    shader.entry_point =
         compiler.get_cleansed_entry_point_name(shader_entry_points[0].name, shader_entry_points[0].execution_model);
-    return msl_source;
+    return shader;
+}
+
+std::vector<uint8_t> SerializeMSLShader(ShaderType shader_type,
+                                        std::span<const uint8_t> spirv_blob,
+                                        const MSLShader& shader)
+{
+    BinaryWriter writer;
+    writer.Write(kMSLShaderMagic);
+    writer.Write(kMSLShaderVersion);
+    writer.Write(static_cast<uint32_t>(shader_type));
+    writer.Write(Sha256(spirv_blob));
+    writer.WriteArray(shader.source);
+    writer.WriteArray(shader.entry_point);
+    writer.Write<uint64_t>(shader.mapping.size());
+    for (const auto& [bind_key, index] : shader.mapping) {
+        writer.Write(static_cast<uint32_t>(bind_key.shader_type));
+        writer.Write(static_cast<uint32_t>(bind_key.view_type));
+        writer.Write(bind_key.slot);
+        writer.Write(bind_key.space);
+        writer.Write(bind_key.count);
+        writer.Write(index);
+    }
+    return writer.GetData();
+}
+
+bool RegisterMSLShader(const std::vector<uint8_t>& data, std::span<const uint8_t> spirv_blob)
+{
+    BinaryReader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t shader_type = 0;
+    Sha256Digest spirv_digest = {};
+    uint64_t mapping_count = 0;
+    MSLShader shader;
+    if (!reader.Read(magic) || magic != kMSLShaderMagic || !reader.Read(version) || version != kMSLShaderVersion ||
+        !reader.Read(shader_type) || !reader.Read(spirv_digest) || !reader.ReadArray(shader.source) ||
+        !reader.ReadArray(shader.entry_point) || !reader.Read(mapping_count)) {
+        return false;
+    }
+    // A stale .msl next to a rebuilt .spirv must not be used.
+    if (spirv_digest != Sha256(spirv_blob) || shader.source.empty()) {
+        return false;
+    }
+    for (uint64_t i = 0; i < mapping_count; ++i) {
+        uint32_t bind_shader_type = 0;
+        uint32_t view_type = 0;
+        BindKey bind_key = {};
+        uint32_t index = 0;
+        if (!reader.Read(bind_shader_type) || !reader.Read(view_type) || !reader.Read(bind_key.slot) ||
+            !reader.Read(bind_key.space) || !reader.Read(bind_key.count) || !reader.Read(index)) {
+            return false;
+        }
+        bind_key.shader_type = static_cast<ShaderType>(bind_shader_type);
+        bind_key.view_type = static_cast<ViewType>(view_type);
+        shader.mapping[bind_key] = index;
+    }
+
+    std::lock_guard lock(g_registry_mutex);
+    g_registry[{ spirv_digest, static_cast<ShaderType>(shader_type) }] = std::move(shader);
+    return true;
+}
+
+std::vector<uint8_t> GenerateOfflineMSLShader(ShaderType shader_type, std::span<const uint8_t> spirv_blob)
+{
+    return SerializeMSLShader(shader_type, spirv_blob, ConvertToMSLShader(shader_type, spirv_blob));
 }
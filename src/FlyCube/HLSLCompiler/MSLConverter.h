@@ -1,7 +1,32 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+struct MSLShader {
+    std::string source;
+    std::map<BindKey, uint32_t> mapping;
+    std::string entry_point;
+};
+
+// Uses an offline shader registered for this SPIR-V blob if there is one, otherwise runs spirv-cross.
 std::string GetMSLShader(ShaderType shader_type,
-                         const std::vector<uint8_t>& blob,
+                         std::span<const uint8_t> blob,
                          std::map<BindKey, uint32_t>& mapping,
                          std::string& entry_point);
+MSLShader ConvertToMSLShader(ShaderType shader_type, std::span<const uint8_t> blob);
+
+// Offline MSL as written by ShaderCompilerCLI, keyed by the shader type and the SHA-256 of the SPIR-V blob it was
+// generated from.
+std::vector<uint8_t> SerializeMSLShader(ShaderType shader_type,
+                                        std::span<const uint8_t> spirv_blob,
+                                        const MSLShader& shader);
+// Fails unless data was generated from spirv_blob. The registered shader is handed to the first GetMSLShader call for
+// this blob and dropped from the registry, later calls run spirv-cross again.
+bool RegisterMSLShader(const std::vector<uint8_t>& data, std::span<const uint8_t> spirv_blob);
+// The .msl file ShaderCompilerCLI writes for a SPIR-V blob.
+std::vector<uint8_t> GenerateOfflineMSLShader(ShaderType shader_type, std::span<const uint8_t> spirv_blob);
@@ -137,7 +137,7 @@ uint32_t GetRangeType(ViewType view_type)
 }
 
 std::vector<uint8_t> ConvertToMetalLibBytecode(ShaderType shader_type,
-                                               const std::vector<uint8_t>& blob,
+                                               std::span<const uint8_t> blob,
                                                std::string& entry_point)
 {
     IRCompiler* compiler = IRCompilerCreate();
@@ -1,6 +1,8 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 
+#include <span>
+
 inline constexpr uint32_t kDxilMaxRangeType = 4;
 
 uint32_t GetRangeType(ViewType view_type);
@@ -11,5 +13,5 @@ inline uint32_t GetArgumentBufferKey(uint32_t space, ViewType view_type)
 }
 
 std::vector<uint8_t> ConvertToMetalLibBytecode(ShaderType shader_type,
-                                               const std::vector<uint8_t>& blob,
+                                               std::span<const uint8_t> blob,
                                                std::string& entry_point);
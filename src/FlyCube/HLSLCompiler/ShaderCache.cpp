@@ -0,0 +1,177 @@
+#include "HLSLCompiler/ShaderCache.h"
+
+#include "HLSLCompiler/SourceFileCache.h"
+#include "Utilities/BinaryStream.h"
+#include "Utilities/Hash.h"
+#include "Utilities/SystemUtils.h"
+#include "Utilities/Trace.h"
+
+#include <nowide/fstream.hpp>
+
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <mutex>
+
+namespace {
+
+constexpr uint32_t kShaderCacheMagic = 0x43534346; // "FCSC"
+constexpr uint32_t kShaderCacheVersion = 2;
+
+std::mutex g_cache_dir_mutex;
+std::optional<std::string> g_cache_dir;
+
+std::string GetEntryPath(const std::string& dir, const std::string& key)
+{
+    return std::format("{}/{:016x}.bin", dir, HashString(key));
+}
+
+std::optional<std::vector<uint8_t>> ReadFile(const std::string& path)
+{
+    nowide::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+    file.unsetf(std::ios::skipws);
+    return std::vector<uint8_t>(std::istream_iterator<uint8_t>(file), std::istream_iterator<uint8_t>());
+}
+
+} // namespace
+
+void SetShaderCacheDir(const std::string& dir)
+{
+    std::lock_guard lock(g_cache_dir_mutex);
+    g_cache_dir = dir;
+}
+
+std::string GetShaderCacheDir()
+{
+    std::lock_guard lock(g_cache_dir_mutex);
+    if (!g_cache_dir) {
+        g_cache_dir = GetEnvironmentVar("FLYCUBE_SHADER_CACHE_DIR");
+        if (g_cache_dir->empty()) {
+            g_cache_dir = GetExecutableDir() + "/ShaderCache";
+        }
+    }
+    return *g_cache_dir;
+}
+
+std::optional<ShaderCacheEntry> LoadCachedShader(const std::string& key)
+{
+    TRACE_SCOPE("LoadCachedShader");
+    std::string dir = GetShaderCacheDir();
+    if (dir.empty()) {
+        return {};
+    }
+
+    auto data = ReadFile(GetEntryPath(dir, key));
+    if (!data) {
+        return {};
+    }
+
+    BinaryReader reader(*data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    std::string stored_key;
+    uint64_t dependency_count = 0;
+    if (!reader.Read(magic) || magic != kShaderCacheMagic || !reader.Read(version) ||
+        version != kShaderCacheVersion || !reader.ReadArray(stored_key) || stored_key != key ||
+        !reader.Read(dependency_count)) {
+        return {};
+    }
+
+    ShaderCacheEntry entry;
+    for (uint64_t i = 0; i < dependency_count; ++i) {
+        ShaderCacheDependency dependency = {};
+        if (!reader.ReadArray(dependency.path) || !reader.Read(dependency.hash)) {
+            return {};
+        }
+        if (HashFile(dependency.path) != dependency.hash) {
+            return {};
+        }
+        entry.dependencies.push_back(std::move(dependency));
+    }
+    if (!reader.ReadArray(entry.blob) || entry.blob.empty() || !reader.ReadArray(entry.debug_info) ||
+        !reader.ReadArray(entry.debug_info_name)) {
+        return {};
+    }
+    return entry;
+}
+
+void StoreCachedShader(const std::string& key, const ShaderCacheEntry& entry)
+{
+    TRACE_SCOPE("StoreCachedShader");
+    std::string dir = GetShaderCacheDir();
+    if (dir.empty()) {
+        return;
+    }
+
+    BinaryWriter writer;
+    writer.Write(kShaderCacheMagic);
+    writer.Write(kShaderCacheVersion);
+    writer.WriteArray(key);
+    writer.Write<uint64_t>(entry.dependencies.size());
+    for (const auto& dependency : entry.dependencies) {
+        writer.WriteArray(dependency.path);
+        writer.Write(dependency.hash);
+    }
+    writer.WriteArray(entry.blob);
+    writer.WriteArray(entry.debug_info);
+    writer.WriteArray(entry.debug_info_name);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::string path = GetEntryPath(dir, key);
+    std::string tmp_path = GetTempFilePath(path);
+    {
+        nowide::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        const auto& data = writer.GetData();
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+    }
+}
+
+uint64_t HashFile(const std::string& path)
+{
+    auto source_file = LoadSourceFile(path);
+    if (!source_file) {
+        return 0;
+    }
+    return source_file->hash;
+}
+
+void WriteDepfile(const std::string& path,
+                  const std::vector<std::string>& targets,
+                  const std::vector<std::string>& dependencies)
+{
+    auto escape = [](const std::string& str) {
+        std::string res;
+        for (char c : str) {
+            if (c == ' ' || c == '#') {
+                res += '\\';
+            } else if (c == '$') {
+                res += '$';
+            }
+            res += c == '\\' ? '/' : c;
+        }
+        return res;
+    };
+
+    nowide::ofstream file(path, std::ios::trunc);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        file << (i ? " " : "") << escape(targets[i]);
+    }
+    file << ":";
+    for (const auto& dependency : dependencies) {
+        file << " \\\n  " << escape(dependency);
+    }
+    file << "\n";
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct ShaderCacheDependency {
+    std::string path;
+    uint64_t hash;
+};
+
+struct ShaderCacheEntry {
+    std::vector<ShaderCacheDependency> dependencies;
+    std::vector<uint8_t> blob;
+    std::vector<uint8_t> debug_info;
+    std::string debug_info_name;
+};
+
+// Defaults to FLYCUBE_SHADER_CACHE_DIR or ShaderCache next to the executable, an empty dir disables the cache.
+void SetShaderCacheDir(const std::string& dir);
+std::string GetShaderCacheDir();
+
+std::optional<ShaderCacheEntry> LoadCachedShader(const std::string& key);
+void StoreCachedShader(const std::string& key, const ShaderCacheEntry& entry);
+
+uint64_t HashFile(const std::string& path);
+void WriteDepfile(const std::string& path,
+                  const std::vector<std::string>& targets,
+                  const std::vector<std::string>& dependencies);
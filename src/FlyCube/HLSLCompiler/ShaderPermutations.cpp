@@ -0,0 +1,285 @@
+#include "HLSLCompiler/ShaderPermutations.h"
+
+#include "Utilities/BinaryStream.h"
+#include "Utilities/Check.h"
+#include "Utilities/Hash.h"
+#include "Utilities/Logging.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Trace.h"
+
+#include <nowide/fstream.hpp>
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <map>
+#include <set>
+
+namespace {
+
+constexpr uint32_t kPermutationTableMagic = 0x50534346; // "FCSP"
+constexpr uint32_t kPermutationTableVersion = 1;
+// The full cartesian product is limited to 2^16 permutations, larger sets must request explicit masks.
+constexpr size_t kMaxFullProductKeywords = 16;
+
+struct PermutationResult {
+    CompileReport report;
+    std::string source;
+    uint64_t source_hash = 0;
+    std::vector<uint8_t> blob;
+};
+
+// Debug blobs embed the compile arguments including every define, so equal sources still give different blobs.
+bool CanReuseBlobForSource(const ShaderDesc& shader)
+{
+    return shader.profile != ShaderCompileProfile::kDebug;
+}
+
+} // namespace
+
+ShaderPermutationTable::ShaderPermutationTable(std::vector<std::string> keywords,
+                                               std::unordered_map<uint64_t, uint32_t> blob_indices,
+                                               std::vector<std::vector<uint8_t>> blobs)
+    : keywords_(std::move(keywords))
+    , blob_indices_(std::move(blob_indices))
+    , blobs_(std::move(blobs))
+{
+}
+
+std::optional<ShaderPermutationTable> ShaderPermutationTable::Load(const std::string& path)
+{
+    TRACE_SCOPE("ShaderPermutationTable::Load");
+    nowide::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+    file.unsetf(std::ios::skipws);
+    std::vector<uint8_t> data(std::istream_iterator<uint8_t>(file), {});
+
+    BinaryReader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t keyword_count = 0;
+    if (!reader.Read(magic) || magic != kPermutationTableMagic || !reader.Read(version) ||
+        version != kPermutationTableVersion || !reader.Read(keyword_count)) {
+        return {};
+    }
+
+    std::vector<std::string> keywords(keyword_count);
+    for (auto& keyword : keywords) {
+        if (!reader.ReadArray(keyword)) {
+            return {};
+        }
+    }
+
+    uint64_t blob_count = 0;
+    if (!reader.Read(blob_count)) {
+        return {};
+    }
+    std::vector<std::vector<uint8_t>> blobs(blob_count);
+    for (auto& blob : blobs) {
+        if (!reader.ReadArray(blob)) {
+            return {};
+        }
+    }
+
+    uint64_t permutation_count = 0;
+    if (!reader.Read(permutation_count)) {
+        return {};
+    }
+    std::unordered_map<uint64_t, uint32_t> blob_indices;
+    for (uint64_t i = 0; i < permutation_count; ++i) {
+        uint64_t mask = 0;
+        uint32_t blob_index = 0;
+        if (!reader.Read(mask) || !reader.Read(blob_index) || blob_index >= blobs.size()) {
+            return {};
+        }
+        blob_indices[mask] = blob_index;
+    }
+    return ShaderPermutationTable(std::move(keywords), std::move(blob_indices), std::move(blobs));
+}
+
+bool ShaderPermutationTable::Save(const std::string& path) const
+{
+    BinaryWriter writer;
+    writer.Write(kPermutationTableMagic);
+    writer.Write(kPermutationTableVersion);
+    writer.Write<uint64_t>(keywords_.size());
+    for (const auto& keyword : keywords_) {
+        writer.WriteArray(keyword);
+    }
+    writer.Write<uint64_t>(blobs_.size());
+    for (const auto& blob : blobs_) {
+        writer.WriteArray(blob);
+    }
+    std::map<uint64_t, uint32_t> sorted_indices(blob_indices_.begin(), blob_indices_.end());
+    writer.Write<uint64_t>(sorted_indices.size());
+    for (const auto& [mask, blob_index] : sorted_indices) {
+        writer.Write(mask);
+        writer.Write(blob_index);
+    }
+
+    nowide::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const auto& data = writer.GetData();
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return !!file;
+}
+
+uint64_t ShaderPermutationTable::GetMask(const std::vector<std::string>& keywords) const
+{
+    uint64_t mask = 0;
+    for (const auto& keyword : keywords) {
+        auto it = std::find(keywords_.begin(), keywords_.end(), keyword);
+        if (it != keywords_.end()) {
+            mask |= 1ull << std::distance(keywords_.begin(), it);
+        }
+    }
+    return mask;
+}
+
+const std::vector<uint8_t>* ShaderPermutationTable::GetBlob(uint64_t mask) const
+{
+    auto it = blob_indices_.find(mask);
+    if (it == blob_indices_.end()) {
+        return nullptr;
+    }
+    return &blobs_[it->second];
+}
+
+const std::vector<std::string>& ShaderPermutationTable::GetKeywords() const
+{
+    return keywords_;
+}
+
+size_t ShaderPermutationTable::GetPermutationCount() const
+{
+    return blob_indices_.size();
+}
+
+size_t ShaderPermutationTable::GetUniqueBlobCount() const
+{
+    return blobs_.size();
+}
+
+ShaderDesc GetPermutationShaderDesc(const ShaderPermutationDesc& desc, uint64_t mask)
+{
+    ShaderDesc shader = desc.shader;
+    for (size_t i = 0; i < desc.keywords.size(); ++i) {
+        if (mask & (1ull << i)) {
+            shader.define[desc.keywords[i]] = "1";
+        }
+    }
+    return shader;
+}
+
+std::optional<ShaderPermutationTable> CompilePermutations(const ShaderPermutationDesc& desc,
+                                                          ShaderBlobType blob_type,
+                                                          const std::vector<uint64_t>& masks,
+                                                          uint32_t thread_count,
+                                                          CompileReport* report)
+{
+    TRACE_SCOPE("CompilePermutations");
+    CHECK(desc.keywords.size() <= 64, "Too many keywords in {}", desc.shader.shader_path);
+
+    std::vector<uint64_t> requested_masks = masks;
+    if (requested_masks.empty()) {
+        CHECK(desc.keywords.size() <= kMaxFullProductKeywords, "Too many keywords for the full product in {}",
+              desc.shader.shader_path);
+        for (uint64_t mask = 0; mask < (1ull << desc.keywords.size()); ++mask) {
+            requested_masks.push_back(mask);
+        }
+    }
+    std::sort(requested_masks.begin(), requested_masks.end());
+    requested_masks.erase(std::unique(requested_masks.begin(), requested_masks.end()), requested_masks.end());
+
+    std::vector<PermutationResult> results(requested_masks.size());
+    ThreadPool thread_pool(thread_count);
+    for (size_t i = 0; i < requested_masks.size(); ++i) {
+        thread_pool.Enqueue([&, i] {
+            PermutationResult& result = results[i];
+            result.source = Preprocess(GetPermutationShaderDesc(desc, requested_masks[i]), blob_type, &result.report);
+            if (!result.source.empty()) {
+                result.source_hash = HashString(result.source);
+            } else if (result.report.errors.empty()) {
+                result.report.errors = "preprocessing failed";
+            }
+        });
+    }
+    thread_pool.WaitIdle();
+
+    // Only the first permutation of each preprocessed source is compiled, the rest reuse its blob.
+    bool reuse_blobs = CanReuseBlobForSource(desc.shader);
+    std::multimap<uint64_t, size_t> unique_sources;
+    std::vector<size_t> source_indices(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        source_indices[i] = i;
+        if (!results[i].report.errors.empty()) {
+            continue;
+        }
+        if (reuse_blobs) {
+            auto [begin, end] = unique_sources.equal_range(results[i].source_hash);
+            auto it = std::find_if(
+                begin, end, [&](const auto& entry) { return results[entry.second].source == results[i].source; });
+            if (it != end) {
+                source_indices[i] = it->second;
+            } else {
+                unique_sources.emplace(results[i].source_hash, i);
+            }
+        }
+        if (source_indices[i] == i) {
+            thread_pool.Enqueue([&, i] {
+                PermutationResult& result = results[i];
+                result.blob = Compile(GetPermutationShaderDesc(desc, requested_masks[i]), blob_type, &result.report);
+                if (result.blob.empty() && result.report.errors.empty()) {
+                    result.report.errors = "compilation failed";
+                }
+            });
+        }
+    }
+    thread_pool.WaitIdle();
+
+    std::string errors;
+    std::set<std::string> dependencies;
+    std::vector<std::vector<uint8_t>> blobs;
+    std::multimap<uint64_t, uint32_t> blob_hashes;
+    std::vector<uint32_t> blob_indices_by_result(results.size());
+    std::unordered_map<uint64_t, uint32_t> blob_indices;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const PermutationResult& result = results[i];
+        if (!result.report.errors.empty()) {
+            errors += std::format("{} (mask {:016x}):\n{}\n", desc.shader.shader_path, requested_masks[i],
+                                  result.report.errors);
+            continue;
+        }
+        if (source_indices[i] != i) {
+            if (results[source_indices[i]].report.errors.empty()) {
+                blob_indices[requested_masks[i]] = blob_indices_by_result[source_indices[i]];
+            }
+            continue;
+        }
+        dependencies.insert(result.report.dependencies.begin(), result.report.dependencies.end());
+
+        uint64_t blob_hash = HashBytes(result.blob.data(), result.blob.size());
+        auto [begin, end] = blob_hashes.equal_range(blob_hash);
+        auto it = std::find_if(begin, end, [&](const auto& entry) { return blobs[entry.second] == result.blob; });
+        if (it != end) {
+            blob_indices_by_result[i] = it->second;
+        } else {
+            blob_indices_by_result[i] = static_cast<uint32_t>(blobs.size());
+            blob_hashes.emplace(blob_hash, blob_indices_by_result[i]);
+            blobs.push_back(result.blob);
+        }
+        blob_indices[requested_masks[i]] = blob_indices_by_result[i];
+    }
+
+    if (report) {
+        report->dependencies.assign(dependencies.begin(), dependencies.end());
+        report->errors = errors;
+    } else if (!errors.empty()) {
+        Logging::Println("{}", errors);
+    }
+    if (!errors.empty()) {
+        return {};
+    }
+    return ShaderPermutationTable(desc.keywords, std::move(blob_indices), std::move(blobs));
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "HLSLCompiler/Compiler.h"
+#include "Instance/BaseTypes.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ShaderPermutationDesc {
+    ShaderDesc shader;
+    // Bit i of a permutation mask enables keywords[i], which is then defined as 1.
+    std::vector<std::string> keywords;
+};
+
+class ShaderPermutationTable {
+public:
+    ShaderPermutationTable() = default;
+    ShaderPermutationTable(std::vector<std::string> keywords,
+                           std::unordered_map<uint64_t, uint32_t> blob_indices,
+                           std::vector<std::vector<uint8_t>> blobs);
+
+    static std::optional<ShaderPermutationTable> Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    // Unknown keywords are ignored.
+    uint64_t GetMask(const std::vector<std::string>& keywords) const;
+    // Returns nullptr if the permutation was not compiled.
+    const std::vector<uint8_t>* GetBlob(uint64_t mask) const;
+    const std::vector<std::string>& GetKeywords() const;
+    size_t GetPermutationCount() const;
+    size_t GetUniqueBlobCount() const;
+
+private:
+    std::vector<std::string> keywords_;
+    std::unordered_map<uint64_t, uint32_t> blob_indices_;
+    std::vector<std::vector<uint8_t>> blobs_;
+};
+
+ShaderDesc GetPermutationShaderDesc(const ShaderPermutationDesc& desc, uint64_t mask);
+
+// Compiles the requested masks, or the full cartesian product when masks is empty. Unless the profile embeds debug
+// info, permutations with identical preprocessed source are compiled once. Byte-identical blobs are stored once.
+// Returns nullopt if any permutation fails, the errors of all failed permutations are then returned in the report or
+// logged.
+std::optional<ShaderPermutationTable> CompilePermutations(const ShaderPermutationDesc& desc,
+                                                          ShaderBlobType blob_type,
+                                                          const std::vector<uint64_t>& masks = {},
+                                                          uint32_t thread_count = 0,
+                                                          CompileReport* report = nullptr);
@@ -0,0 +1,485 @@
+#include "HLSLCompiler/ShaderServer.h"
+
+#include "Utilities/BinaryStream.h"
+#include "Utilities/Logging.h"
+#include "Utilities/ScopeGuard.h"
+#include "Utilities/SystemUtils.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Trace.h"
+
+#if !defined(_WIN32)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <optional>
+
+namespace {
+
+constexpr uint32_t kShaderServerMagic = 0x44534346; // "FCSD"
+constexpr uint32_t kShaderServerVersion = 3;
+// Guards against reading garbage lengths from a misbehaving peer.
+constexpr uint64_t kMaxMessageSize = 256 << 20;
+// A hung server must not block Compile() forever, the client falls back to compiling locally.
+constexpr auto kClientTimeout = std::chrono::seconds(60);
+
+enum class ResponseStatus : uint32_t {
+    kCompiled,
+    // The request was refused before compiling, the client compiles locally instead.
+    kRejected,
+};
+
+std::atomic<bool> g_client_enabled = GetEnvironmentVar("FLYCUBE_SHADERD") != "0";
+std::mutex g_socket_path_mutex;
+std::optional<std::string> g_socket_path;
+// Set on server threads so that Compile() never forwards back to the server.
+thread_local bool t_serving = false;
+
+#if !defined(_WIN32)
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool MakeSocketAddress(const std::string& socket_path, sockaddr_un& address)
+{
+    address = {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    return true;
+}
+
+int CreateSocket()
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+#if defined(SO_NOSIGPIPE)
+    if (fd != -1) {
+        int value = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+    }
+#endif
+    return fd;
+}
+
+// Only serve and trust processes of the same user, the socket path alone is not a security boundary.
+bool IsPeerSameUser(int fd)
+{
+#if defined(__linux__)
+    ucred credentials = {};
+    socklen_t size = sizeof(credentials);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == -1) {
+        return false;
+    }
+    return credentials.uid == geteuid();
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (getpeereid(fd, &uid, &gid) == -1) {
+        return false;
+    }
+    return uid == geteuid();
+#endif
+}
+
+std::string GetDefaultSocketPath()
+{
+    std::string runtime_dir = GetEnvironmentVar("XDG_RUNTIME_DIR");
+    if (!runtime_dir.empty()) {
+        return (std::filesystem::path(runtime_dir) / "flycube-shaderd.sock").string();
+    }
+    std::error_code ec;
+    std::filesystem::path temp_dir = std::filesystem::temp_directory_path(ec);
+    if (ec) {
+        temp_dir = "/tmp";
+    }
+    return (temp_dir / std::format("flycube-shaderd-{}", geteuid()) / "shaderd.sock").string();
+}
+
+// Creates dir with 0700 if needed and rejects it unless it is a real directory private to the current user.
+bool PreparePrivateDirectory(const std::string& dir)
+{
+    if (mkdir(dir.c_str(), 0700) == -1 && errno != EEXIST) {
+        Logging::Println("flycube-shaderd: failed to create {}: {}", dir, std::strerror(errno));
+        return false;
+    }
+    struct stat info = {};
+    if (lstat(dir.c_str(), &info) == -1 || !S_ISDIR(info.st_mode) || info.st_uid != geteuid() ||
+        (info.st_mode & (S_IRWXG | S_IRWXO))) {
+        Logging::Println("flycube-shaderd: {} must be a directory owned by the current user with mode 0700", dir);
+        return false;
+    }
+    return true;
+}
+
+void SetTimeout(int fd, std::chrono::seconds timeout)
+{
+    timeval value = {};
+    value.tv_sec = timeout.count();
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &value, sizeof(value));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &value, sizeof(value));
+}
+
+int Connect(const std::string& socket_path)
+{
+    sockaddr_un address = {};
+    if (!MakeSocketAddress(socket_path, address)) {
+        return -1;
+    }
+    int fd = CreateSocket();
+    if (fd == -1) {
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool SendAll(int fd, const void* data, size_t size)
+{
+    const char* ptr = static_cast<const char*>(data);
+    while (size) {
+        ssize_t res = send(fd, ptr, size, kSendFlags);
+        if (res == -1 && errno == EINTR) {
+            continue;
+        }
+        if (res <= 0) {
+            return false;
+        }
+        ptr += res;
+        size -= res;
+    }
+    return true;
+}
+
+bool RecvAll(int fd, void* data, size_t size)
+{
+    char* ptr = static_cast<char*>(data);
+    while (size) {
+        ssize_t res = recv(fd, ptr, size, 0);
+        if (res == -1 && errno == EINTR) {
+            continue;
+        }
+        if (res <= 0) {
+            return false;
+        }
+        ptr += res;
+        size -= res;
+    }
+    return true;
+}
+
+bool SendMessage(int fd, const std::vector<uint8_t>& message)
+{
+    uint64_t size = message.size();
+    return SendAll(fd, &size, sizeof(size)) && SendAll(fd, message.data(), message.size());
+}
+
+bool RecvMessage(int fd, std::vector<uint8_t>& message)
+{
+    uint64_t size = 0;
+    if (!RecvAll(fd, &size, sizeof(size)) || size > kMaxMessageSize) {
+        return false;
+    }
+    message.resize(size);
+    return RecvAll(fd, message.data(), message.size());
+}
+
+std::vector<uint8_t> WriteRequest(const ShaderDesc& shader, ShaderBlobType blob_type)
+{
+    BinaryWriter writer;
+    writer.Write(kShaderServerMagic);
+    writer.Write(kShaderServerVersion);
+    writer.Write(static_cast<uint32_t>(blob_type));
+    writer.Write(static_cast<uint32_t>(shader.type));
+    writer.Write(static_cast<uint32_t>(shader.profile));
+    writer.WriteArray(shader.shader_path);
+    writer.WriteArray(shader.entrypoint);
+    writer.WriteArray(shader.model);
+    writer.Write<uint64_t>(shader.define.size());
+    for (const auto& [name, value] : shader.define) {
+        writer.WriteArray(name);
+        writer.WriteArray(value);
+    }
+    return writer.GetData();
+}
+
+// A client of another protocol version can not parse our responses either, so it gets none.
+bool IsSupportedRequest(const std::vector<uint8_t>& message)
+{
+    BinaryReader reader(message);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    return reader.Read(magic) && magic == kShaderServerMagic && reader.Read(version) &&
+           version == kShaderServerVersion;
+}
+
+// Everything in the request comes from another process, reject what Compile() would CHECK on.
+bool ReadRequest(const std::vector<uint8_t>& message, ShaderDesc& shader, ShaderBlobType& blob_type, std::string& error)
+{
+    BinaryReader reader(message);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t blob_type_value = 0;
+    uint32_t shader_type_value = 0;
+    uint32_t profile_value = 0;
+    uint64_t define_count = 0;
+    if (!reader.Read(magic) || magic != kShaderServerMagic || !reader.Read(version) ||
+        version != kShaderServerVersion || !reader.Read(blob_type_value) || !reader.Read(shader_type_value) ||
+        !reader.Read(profile_value) || !reader.ReadArray(shader.shader_path) || !reader.ReadArray(shader.entrypoint) ||
+        !reader.ReadArray(shader.model) || !reader.Read(define_count)) {
+        error = "malformed request";
+        return false;
+    }
+    if (blob_type_value > static_cast<uint32_t>(ShaderBlobType::kSPIRV)) {
+        error = std::format("invalid shader blob type {}", blob_type_value);
+        return false;
+    }
+    if (shader_type_value == static_cast<uint32_t>(ShaderType::kUnknown) ||
+        shader_type_value > static_cast<uint32_t>(ShaderType::kLibrary)) {
+        error = std::format("invalid shader type {}", shader_type_value);
+        return false;
+    }
+    if (profile_value > static_cast<uint32_t>(ShaderCompileProfile::kSize)) {
+        error = std::format("invalid shader compile profile {}", profile_value);
+        return false;
+    }
+    blob_type = static_cast<ShaderBlobType>(blob_type_value);
+    shader.type = static_cast<ShaderType>(shader_type_value);
+    shader.profile = static_cast<ShaderCompileProfile>(profile_value);
+    for (uint64_t i = 0; i < define_count; ++i) {
+        std::string name;
+        std::string value;
+        if (!reader.ReadArray(name) || !reader.ReadArray(value)) {
+            error = "malformed request";
+            return false;
+        }
+        shader.define[name] = value;
+    }
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(shader.shader_path, ec)) {
+        error = std::format("failed to load {}", shader.shader_path);
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> WriteResponse(ResponseStatus status, const std::vector<uint8_t>& blob, const CompileReport& report)
+{
+    BinaryWriter writer;
+    writer.Write(kShaderServerMagic);
+    writer.Write(kShaderServerVersion);
+    writer.Write(status);
+    writer.WriteArray(blob);
+    writer.WriteArray(report.errors);
+    writer.WriteArray(report.debug_info);
+    writer.WriteArray(report.debug_info_name);
+    writer.Write<uint64_t>(report.dependencies.size());
+    for (const auto& dependency : report.dependencies) {
+        writer.WriteArray(dependency);
+    }
+    return writer.GetData();
+}
+
+// Only a compiled response is accepted, anything else makes the client compile locally.
+bool ReadResponse(const std::vector<uint8_t>& message, std::vector<uint8_t>& blob, CompileReport& report)
+{
+    BinaryReader reader(message);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    ResponseStatus status = {};
+    uint64_t dependency_count = 0;
+    if (!reader.Read(magic) || magic != kShaderServerMagic || !reader.Read(version) ||
+        version != kShaderServerVersion || !reader.Read(status) || status != ResponseStatus::kCompiled ||
+        !reader.ReadArray(blob) ||
+        !reader.ReadArray(report.errors) || !reader.ReadArray(report.debug_info) ||
+        !reader.ReadArray(report.debug_info_name) || !reader.Read(dependency_count)) {
+        return false;
+    }
+    report.dependencies.resize(dependency_count);
+    for (auto& dependency : report.dependencies) {
+        if (!reader.ReadArray(dependency)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ServeClient(int fd)
+{
+    TRACE_SCOPE("ServeClient");
+    t_serving = true;
+    ScopeGuard close_guard([&] { close(fd); });
+    if (!IsPeerSameUser(fd)) {
+        Logging::Println("flycube-shaderd: rejected a connection from another user");
+        return;
+    }
+    std::vector<uint8_t> message;
+    while (RecvMessage(fd, message)) {
+        if (!IsSupportedRequest(message)) {
+            Logging::Println("flycube-shaderd: closed a connection with an unsupported protocol version");
+            break;
+        }
+        ShaderDesc shader;
+        ShaderBlobType blob_type = {};
+        CompileReport report;
+        std::vector<uint8_t> blob;
+        ResponseStatus status = ResponseStatus::kCompiled;
+        if (!ReadRequest(message, shader, blob_type, report.errors)) {
+            Logging::Println("flycube-shaderd: rejected a request: {}", report.errors);
+            status = ResponseStatus::kRejected;
+        } else {
+            blob = Compile(shader, blob_type, &report);
+        }
+        if (!SendMessage(fd, WriteResponse(status, blob, report))) {
+            break;
+        }
+    }
+}
+#endif
+
+} // namespace
+
+void SetShaderServerSocketPath(const std::string& socket_path)
+{
+    std::lock_guard lock(g_socket_path_mutex);
+    g_socket_path = socket_path;
+}
+
+std::string GetShaderServerSocketPath()
+{
+    std::lock_guard lock(g_socket_path_mutex);
+    if (!g_socket_path) {
+        g_socket_path = GetEnvironmentVar("FLYCUBE_SHADERD_SOCKET");
+    }
+#if !defined(_WIN32)
+    if (g_socket_path->empty()) {
+        g_socket_path = GetDefaultSocketPath();
+    }
+#endif
+    return *g_socket_path;
+}
+
+void SetShaderServerClientEnabled(bool enabled)
+{
+    g_client_enabled = enabled;
+}
+
+bool IsShaderServerClientEnabled()
+{
+    return g_client_enabled;
+}
+
+bool CompileOnShaderServer(const ShaderDesc& shader,
+                           ShaderBlobType blob_type,
+                           std::vector<uint8_t>& blob,
+                           CompileReport& report)
+{
+#if defined(_WIN32)
+    return false;
+#else
+    if (!g_client_enabled || t_serving) {
+        return false;
+    }
+    int fd = Connect(GetShaderServerSocketPath());
+    if (fd == -1) {
+        return false;
+    }
+    ScopeGuard close_guard([&] { close(fd); });
+    if (!IsPeerSameUser(fd)) {
+        return false;
+    }
+    SetTimeout(fd, kClientTimeout);
+
+    TRACE_SCOPE("CompileOnShaderServer");
+    // The server has its own working directory.
+    ShaderDesc server_shader = shader;
+    std::error_code ec;
+    std::filesystem::path absolute_path = std::filesystem::absolute(shader.shader_path, ec);
+    if (!ec) {
+        server_shader.shader_path = absolute_path.string();
+    }
+
+    std::vector<uint8_t> message;
+    if (!SendMessage(fd, WriteRequest(server_shader, blob_type)) || !RecvMessage(fd, message) ||
+        !ReadResponse(message, blob, report)) {
+        blob.clear();
+        report = {};
+        return false;
+    }
+    if (!report.dependencies.empty()) {
+        report.dependencies.front() = shader.shader_path;
+    }
+    return true;
+#endif
+}
+
+bool RunShaderServer(const std::string& socket_path, uint32_t thread_count, const std::atomic<bool>& stop)
+{
+#if defined(_WIN32)
+    Logging::Println("flycube-shaderd: Unix domain sockets are not supported on this platform");
+    return false;
+#else
+    sockaddr_un address = {};
+    if (!MakeSocketAddress(socket_path, address)) {
+        Logging::Println("flycube-shaderd: socket path is too long: {}", socket_path);
+        return false;
+    }
+    if (socket_path == GetDefaultSocketPath() &&
+        !PreparePrivateDirectory(std::filesystem::path(socket_path).parent_path().string())) {
+        return false;
+    }
+    int existing_fd = Connect(socket_path);
+    if (existing_fd != -1) {
+        close(existing_fd);
+        Logging::Println("flycube-shaderd: already running on {}", socket_path);
+        return false;
+    }
+    unlink(socket_path.c_str());
+
+    int listen_fd = CreateSocket();
+    if (listen_fd == -1) {
+        Logging::Println("flycube-shaderd: socket failed: {}", std::strerror(errno));
+        return false;
+    }
+    ScopeGuard listen_guard([&] {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    });
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        chmod(socket_path.c_str(), S_IRUSR | S_IWUSR) == -1 || listen(listen_fd, SOMAXCONN) == -1) {
+        Logging::Println("flycube-shaderd: failed to listen on {}: {}", socket_path, std::strerror(errno));
+        return false;
+    }
+
+    ThreadPool thread_pool(thread_count);
+    Logging::Println("flycube-shaderd: listening on {} with {} threads", socket_path, thread_pool.GetThreadCount());
+    while (!stop) {
+        pollfd fd = { listen_fd, POLLIN, 0 };
+        if (poll(&fd, 1, 200) <= 0) {
+            continue;
+        }
+        int client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd == -1) {
+            continue;
+        }
+        thread_pool.Enqueue([client_fd] { ServeClient(client_fd); });
+    }
+    return true;
+#endif
+}
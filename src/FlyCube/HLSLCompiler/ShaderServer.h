@@ -0,0 +1,27 @@
+#pragma once
+#include "HLSLCompiler/Compiler.h"
+#include "Instance/BaseTypes.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Defaults to FLYCUBE_SHADERD_SOCKET, then $XDG_RUNTIME_DIR/flycube-shaderd.sock, then a private 0700
+// flycube-shaderd-<uid> directory in the temp directory. Connections from other users are rejected on both ends.
+void SetShaderServerSocketPath(const std::string& socket_path);
+std::string GetShaderServerSocketPath();
+
+// Compile() forwards to a running flycube-shaderd unless FLYCUBE_SHADERD=0 or the client is disabled here.
+void SetShaderServerClientEnabled(bool enabled);
+bool IsShaderServerClientEnabled();
+
+// Returns false if no server of the same protocol version is reachable or it rejected the request, the caller is then
+// expected to compile locally.
+bool CompileOnShaderServer(const ShaderDesc& shader,
+                           ShaderBlobType blob_type,
+                           std::vector<uint8_t>& blob,
+                           CompileReport& report);
+
+// Serves compile requests until stop is set, returns false if the socket could not be created.
+bool RunShaderServer(const std::string& socket_path, uint32_t thread_count, const std::atomic<bool>& stop);
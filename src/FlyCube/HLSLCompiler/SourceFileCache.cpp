@@ -0,0 +1,48 @@
+#include "HLSLCompiler/SourceFileCache.h"
+
+#include "Utilities/Hash.h"
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+namespace {
+
+std::mutex g_mutex;
+std::map<std::string, std::shared_ptr<const SourceFile>> g_files;
+
+} // namespace
+
+std::shared_ptr<const SourceFile> LoadSourceFile(const std::string& path)
+{
+    std::filesystem::path fs_path(std::u8string(path.begin(), path.end()));
+    std::error_code ec;
+    auto last_write_time = std::filesystem::last_write_time(fs_path, ec);
+    if (ec) {
+        std::lock_guard lock(g_mutex);
+        g_files.erase(path);
+        return nullptr;
+    }
+
+    {
+        std::lock_guard lock(g_mutex);
+        auto it = g_files.find(path);
+        if (it != g_files.end() && it->second->last_write_time == last_write_time) {
+            return it->second;
+        }
+    }
+
+    std::ifstream file(fs_path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    auto source_file = std::make_shared<SourceFile>();
+    source_file->data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    source_file->hash = HashBytes(source_file->data.data(), source_file->data.size());
+    source_file->last_write_time = last_write_time;
+
+    std::lock_guard lock(g_mutex);
+    g_files[path] = source_file;
+    return source_file;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SourceFile {
+    std::vector<char> data;
+    uint64_t hash;
+    std::filesystem::file_time_type last_write_time;
+};
+
+// Returns the file contents shared between threads, re-reading the file only when its mtime changes.
+std::shared_ptr<const SourceFile> LoadSourceFile(const std::string& path);
@@ -1,9 +1,20 @@
 #include "HLSLCompiler/Compiler.h"
 #include "HLSLCompiler/MSLConverter.h"
+#include "HLSLCompiler/ShaderCache.h"
+#include "HLSLCompiler/ShaderPermutations.h"
+#include "HLSLCompiler/ShaderServer.h"
+#include "ShaderReflection/ShaderReflection.h"
 #include "Utilities/Logging.h"
+#include "Utilities/ThreadPool.h"
 
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
 #if defined(__APPLE__)
 #import <Metal/Metal.h>
 #endif
@@ -59,11 +70,9 @@ void RunTest(const ShaderDesc& desc)
     }
 }
 
-} // namespace
-
-TEST_CASE("HLSLCompilerTest")
+std::vector<ShaderDesc> GetTestShaderDescs()
 {
-    std::vector<ShaderDesc> shader_descs = {
+    return {
         { ASSETS_PATH "shaders/BindlessTriangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
         { ASSETS_PATH "shaders/BindlessTriangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
         { ASSETS_PATH "shaders/RayTracingTriangle/RayTracing.hlsl", "", ShaderType::kLibrary, "6_3" },
@@ -74,7 +83,13 @@ TEST_CASE("HLSLCompilerTest")
         { ASSETS_PATH "shaders/Triangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
         { ASSETS_PATH "shaders/Triangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
     };
-    for (const auto& shader_desc : shader_descs) {
+}
+
+} // namespace
+
+TEST_CASE("HLSLCompilerTest")
+{
+    for (const auto& shader_desc : GetTestShaderDescs()) {
         auto test_name = shader_desc.shader_path.substr(std::string_view{ ASSETS_PATH "shaders/" }.size());
         DYNAMIC_SECTION(test_name)
         {
@@ -82,3 +97,264 @@ TEST_CASE("HLSLCompilerTest")
         }
     }
 }
+
+TEST_CASE("HLSLCompilerCacheTest")
+{
+    auto cache_dir = std::filesystem::temp_directory_path() / "FlyCubeShaderCacheTest";
+    std::filesystem::remove_all(cache_dir);
+    SetShaderCacheDir(cache_dir.string());
+    bool server_client_enabled = IsShaderServerClientEnabled();
+    SetShaderServerClientEnabled(false);
+
+    ShaderDesc desc = {
+        ASSETS_PATH "shaders/DispatchIndirect/ComputeShader.hlsl", "main", ShaderType::kCompute, "6_0",
+    };
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        CompileReport cold_report;
+        auto cold_blob = Compile(desc, blob_type, &cold_report);
+        REQUIRE(!cold_blob.empty());
+
+        CompileReport warm_report;
+        auto warm_blob = Compile(desc, blob_type, &warm_report);
+        REQUIRE(warm_blob == cold_blob);
+        REQUIRE(warm_report.dependencies == cold_report.dependencies);
+        REQUIRE(std::any_of(warm_report.dependencies.begin(), warm_report.dependencies.end(),
+                            [](const std::string& path) { return path.ends_with("voronoi.hlsl"); }));
+
+        ShaderDesc define_desc = desc;
+        define_desc.define["FLYCUBE_CACHE_TEST"] = "1";
+        REQUIRE(!Compile(define_desc, blob_type).empty());
+    }
+
+    auto entries = std::distance(std::filesystem::directory_iterator(cache_dir), std::filesystem::directory_iterator());
+    REQUIRE(entries == 4);
+
+    SetShaderServerClientEnabled(server_client_enabled);
+    SetShaderCacheDir({});
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST_CASE("HLSLCompilerPermutationsTest")
+{
+    SetShaderCacheDir({});
+    ShaderPermutationDesc desc = {
+        { ASSETS_PATH "shaders/DispatchIndirect/ComputeShader.hlsl", "main", ShaderType::kCompute, "6_0" },
+        { "TAU", "FLYCUBE_UNUSED_KEYWORD" },
+    };
+    // Debug blobs embed the defines, so only the other profiles can reuse a blob for the same source.
+    desc.shader.profile = ShaderCompileProfile::kSize;
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        auto table = CompilePermutations(desc, blob_type);
+        REQUIRE(table);
+        REQUIRE(table->GetPermutationCount() == 4);
+        REQUIRE(table->GetUniqueBlobCount() == 2);
+        for (uint64_t mask = 0; mask < 4; ++mask) {
+            REQUIRE(table->GetBlob(mask));
+            REQUIRE(*table->GetBlob(mask) == Compile(GetPermutationShaderDesc(desc, mask), blob_type));
+        }
+        REQUIRE(table->GetBlob(table->GetMask({ "FLYCUBE_UNUSED_KEYWORD" })) == table->GetBlob(0));
+        REQUIRE(table->GetBlob(table->GetMask({ "TAU" })) != table->GetBlob(0));
+
+        auto path = (std::filesystem::temp_directory_path() / "FlyCubePermutationsTest.bin").string();
+        REQUIRE(table->Save(path));
+        auto loaded = ShaderPermutationTable::Load(path);
+        REQUIRE(loaded);
+        REQUIRE(loaded->GetKeywords() == desc.keywords);
+        REQUIRE(loaded->GetUniqueBlobCount() == 2);
+        REQUIRE(*loaded->GetBlob(3) == *table->GetBlob(3));
+        std::filesystem::remove(path);
+
+        auto subset = CompilePermutations(desc, blob_type, { 1 });
+        REQUIRE(subset);
+        REQUIRE(subset->GetPermutationCount() == 1);
+        REQUIRE(!subset->GetBlob(0));
+
+        ShaderPermutationDesc debug_desc = desc;
+        debug_desc.shader.profile = ShaderCompileProfile::kDebug;
+        auto debug_table = CompilePermutations(debug_desc, blob_type);
+        REQUIRE(debug_table);
+        for (uint64_t mask = 0; mask < 4; ++mask) {
+            REQUIRE(*debug_table->GetBlob(mask) == Compile(GetPermutationShaderDesc(debug_desc, mask), blob_type));
+        }
+    }
+}
+
+TEST_CASE("HLSLCompilerOfflineMSLTest")
+{
+    for (const auto& shader_desc : GetTestShaderDescs()) {
+        if (shader_desc.type == ShaderType::kLibrary) {
+            continue;
+        }
+        auto spirv_blob = Compile(shader_desc, ShaderBlobType::kSPIRV);
+        REQUIRE(!spirv_blob.empty());
+
+        // Nothing is registered for this blob yet, so this is the spirv-cross path used at runtime.
+        std::map<BindKey, uint32_t> runtime_mapping;
+        std::string runtime_entry_point;
+        auto runtime_source = GetMSLShader(shader_desc.type, spirv_blob, runtime_mapping, runtime_entry_point);
+        REQUIRE(!runtime_source.empty());
+
+        // The .msl file ShaderCompilerCLI writes must carry exactly what the runtime would generate.
+        auto offline_data = GenerateOfflineMSLShader(shader_desc.type, spirv_blob);
+        REQUIRE(offline_data == SerializeMSLShader(shader_desc.type, spirv_blob,
+                                                   { runtime_source, runtime_mapping, runtime_entry_point }));
+        REQUIRE(RegisterMSLShader(offline_data, spirv_blob));
+
+        std::map<BindKey, uint32_t> mapping;
+        std::string entry_point;
+        auto source = GetMSLShader(shader_desc.type, spirv_blob, mapping, entry_point);
+        REQUIRE(source == runtime_source);
+        REQUIRE(mapping == runtime_mapping);
+        REQUIRE(entry_point == runtime_entry_point);
+    }
+
+    // A registered shader is only used for the exact blob and shader type it was generated from.
+    const auto& shader_desc = GetTestShaderDescs().front();
+    auto spirv_blob = Compile(shader_desc, ShaderBlobType::kSPIRV);
+    MSLShader forged = { "forged", {}, "forged" };
+    REQUIRE(RegisterMSLShader(SerializeMSLShader(ShaderType::kUnknown, spirv_blob, forged), spirv_blob));
+    std::map<BindKey, uint32_t> mapping;
+    std::string entry_point;
+    REQUIRE(GetMSLShader(shader_desc.type, spirv_blob, mapping, entry_point) != forged.source);
+
+    std::vector<uint8_t> other_blob = spirv_blob;
+    other_blob.push_back(0);
+    REQUIRE(!RegisterMSLShader(SerializeMSLShader(shader_desc.type, spirv_blob, forged), other_blob));
+
+    // The registry hands a shader out once and does not keep it afterwards.
+    REQUIRE(RegisterMSLShader(SerializeMSLShader(shader_desc.type, spirv_blob, forged), spirv_blob));
+    REQUIRE(GetMSLShader(shader_desc.type, spirv_blob, mapping, entry_point) == forged.source);
+    REQUIRE(GetMSLShader(shader_desc.type, spirv_blob, mapping, entry_point) != forged.source);
+
+    std::vector<uint8_t> truncated = { 'F', 'M', 'S', 'L' };
+    REQUIRE(!RegisterMSLShader(truncated, spirv_blob));
+}
+
+#if !defined(_WIN32)
+TEST_CASE("HLSLCompilerServerTest")
+{
+    SetShaderCacheDir({});
+    auto socket_path = (std::filesystem::temp_directory_path() / "flycube-shaderd-test.sock").string();
+    SetShaderServerSocketPath(socket_path);
+
+    std::atomic<bool> stop = false;
+    std::thread server([&] { RunShaderServer(socket_path, 0, stop); });
+    for (size_t i = 0; i < 500 && !std::filesystem::exists(socket_path); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    for (const auto& desc : GetTestShaderDescs()) {
+        for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+            std::vector<uint8_t> server_blob;
+            CompileReport server_report;
+            REQUIRE(CompileOnShaderServer(desc, blob_type, server_blob, server_report));
+            REQUIRE(!server_blob.empty());
+
+            bool server_client_enabled = IsShaderServerClientEnabled();
+            SetShaderServerClientEnabled(false);
+            CompileReport local_report;
+            auto local_blob = Compile(desc, blob_type, &local_report);
+            SetShaderServerClientEnabled(server_client_enabled);
+            REQUIRE(server_blob == local_blob);
+            REQUIRE(server_report.dependencies == local_report.dependencies);
+        }
+    }
+
+    ShaderDesc invalid_desc = GetTestShaderDescs().front();
+    invalid_desc.entrypoint = "missing_entrypoint";
+    std::vector<uint8_t> blob;
+    CompileReport report;
+    REQUIRE(CompileOnShaderServer(invalid_desc, ShaderBlobType::kSPIRV, blob, report));
+    REQUIRE(blob.empty());
+    REQUIRE(!report.errors.empty());
+
+    // A missing source is rejected so that the client compiles locally, and the server keeps running.
+    ShaderDesc missing_desc = GetTestShaderDescs().front();
+    missing_desc.shader_path = "missing_shader.hlsl";
+    report = {};
+    REQUIRE(!CompileOnShaderServer(missing_desc, ShaderBlobType::kSPIRV, blob, report));
+    REQUIRE(blob.empty());
+    REQUIRE(CompileOnShaderServer(GetTestShaderDescs().front(), ShaderBlobType::kSPIRV, blob, report));
+    REQUIRE(!blob.empty());
+
+    stop = true;
+    server.join();
+    SetShaderServerSocketPath({});
+    REQUIRE(!std::filesystem::exists(socket_path));
+}
+#endif
+
+TEST_CASE("HLSLCompilerBenchmark", "[.benchmark]")
+{
+    constexpr size_t kIterations = 100;
+    SetShaderCacheDir({});
+    SetShaderServerClientEnabled(false);
+    auto shader_descs = GetTestShaderDescs();
+
+    auto run = [&](uint32_t thread_count) {
+        std::atomic<size_t> failed = 0;
+        auto start = std::chrono::steady_clock::now();
+        {
+            ThreadPool thread_pool(thread_count);
+            for (size_t i = 0; i < kIterations; ++i) {
+                for (const auto& desc : shader_descs) {
+                    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+                        thread_pool.Enqueue([&, blob_type] { failed += Compile(desc, blob_type).empty(); });
+                    }
+                }
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE(failed == 0);
+        size_t count = kIterations * shader_descs.size() * 2;
+        Logging::Println("{} threads: {} compilations in {:.2f} s ({:.2f} ms per shader)", thread_count, count,
+                         elapsed.count(), elapsed.count() * 1000 / count);
+    };
+    run(1);
+    run(std::thread::hardware_concurrency());
+}
+
+TEST_CASE("HLSLCompilerProfilesBenchmark", "[.benchmark]")
+{
+    constexpr size_t kLoadIterations = 100;
+    SetShaderCacheDir({});
+    auto shader_descs = GetTestShaderDescs();
+    std::vector<std::pair<ShaderCompileProfile, std::string_view>> profiles = {
+        { ShaderCompileProfile::kDebug, "debug" },
+        { ShaderCompileProfile::kRelease, "release" },
+        { ShaderCompileProfile::kSize, "size" },
+    };
+
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        size_t debug_size = 0;
+        double debug_load_time = 0;
+        for (const auto& [profile, profile_name] : profiles) {
+            size_t size = 0;
+            size_t debug_info_size = 0;
+            std::chrono::duration<double, std::milli> load_time = {};
+            for (auto desc : shader_descs) {
+                desc.profile = profile;
+                CompileReport report;
+                auto blob = Compile(desc, blob_type, &report);
+                REQUIRE(!blob.empty());
+                size += blob.size();
+                debug_info_size += report.debug_info.size();
+
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < kLoadIterations; ++i) {
+                    REQUIRE(CreateShaderReflection(blob_type, blob.data(), blob.size()));
+                }
+                load_time += std::chrono::steady_clock::now() - start;
+            }
+            double load_time_ms = load_time.count() / kLoadIterations;
+            if (profile == ShaderCompileProfile::kDebug) {
+                debug_size = size;
+                debug_load_time = load_time_ms;
+            }
+            Logging::Println("{} {}: {} bytes ({:.1f}%), {} bytes external debug info, reflection {:.3f} ms ({:.1f}%)",
+                             blob_type == ShaderBlobType::kDXIL ? "DXIL" : "SPIR-V", profile_name, size,
+                             100.0 * size / debug_size, debug_info_size, load_time_ms,
+                             100.0 * load_time_ms / debug_load_time);
+        }
+    }
+}
@@ -291,12 +291,22 @@ struct ViewDesc {
     bool bindless = false;
 };
 
+enum class ShaderCompileProfile {
+    // Debug info and SPIR-V reflection decorations embedded in the blob.
+    kDebug,
+    // Optimized, DXIL debug info is returned separately and SPIR-V reflection decorations are dropped if unused.
+    kRelease,
+    // Optimized without any debug info.
+    kSize,
+};
+
 struct ShaderDesc {
     std::string shader_path;
     std::string entrypoint;
     ShaderType type;
     std::string model;
     std::map<std::string, std::string> define;
+    ShaderCompileProfile profile = ShaderCompileProfile::kDebug;
 
     ShaderDesc() = default;
 
@@ -358,6 +368,68 @@ struct RenderPassDesc {
     std::shared_ptr<View> shading_rate_image_view;
 };
 
+enum class PrimitiveTopology {
+    kTriangleList,
+    kTriangleStrip,
+    kLineList,
+    kLineStrip,
+    kPointList,
+};
+
+enum class PrimitiveTopologyClass {
+    kTriangle,
+    kLine,
+    kPoint,
+};
+
+// A pipeline with dynamic topology accepts any topology of the class of its desc topology.
+constexpr PrimitiveTopologyClass GetPrimitiveTopologyClass(PrimitiveTopology topology)
+{
+    switch (topology) {
+    case PrimitiveTopology::kTriangleList:
+    case PrimitiveTopology::kTriangleStrip:
+        return PrimitiveTopologyClass::kTriangle;
+    case PrimitiveTopology::kLineList:
+    case PrimitiveTopology::kLineStrip:
+        return PrimitiveTopologyClass::kLine;
+    default:
+        return PrimitiveTopologyClass::kPoint;
+    }
+}
+
+// The topology a pipeline with dynamic topology draws with until the command list sets one.
+constexpr PrimitiveTopology GetDefaultPrimitiveTopology(PrimitiveTopologyClass topology_class)
+{
+    switch (topology_class) {
+    case PrimitiveTopologyClass::kTriangle:
+        return PrimitiveTopology::kTriangleList;
+    case PrimitiveTopologyClass::kLine:
+        return PrimitiveTopology::kLineList;
+    default:
+        return PrimitiveTopology::kPointList;
+    }
+}
+
+namespace EnumClassDynamicStateFlags {
+enum DynamicStateFlags : uint32_t {
+    kNone = 0,
+    kPrimitiveTopology = 1 << 0,
+    kCullMode = 1 << 1,
+    kFrontFace = 1 << 2,
+    kDepthStencil = 1 << 3,
+    kBlend = 1 << 4,
+};
+}
+
+using DynamicStateFlags = EnumClassDynamicStateFlags::DynamicStateFlags;
+ENABLE_BITMASK_OPERATORS(DynamicStateFlags);
+
+struct SpecializationConstant {
+    uint32_t id;
+    // Raw 32-bit value: 0 or 1 for bool constants, the bit pattern for float constants.
+    uint32_t value;
+};
+
 struct GraphicsPipelineDesc {
     std::vector<std::shared_ptr<Shader>> shaders;
     std::shared_ptr<BindingSetLayout> layout;
@@ -368,11 +440,24 @@ struct GraphicsPipelineDesc {
     BlendDesc blend_desc;
     RasterizerDesc rasterizer_desc;
     uint32_t sample_count = 1;
+    PrimitiveTopology topology = PrimitiveTopology::kTriangleList;
+    // States listed here are taken from the command list setters and their desc values are ignored, so that descs
+    // differing only in them share one pipeline. Until a setter is called the defaults of RasterizerDesc,
+    // DepthStencilDesc and BlendDesc apply, and the list topology of the class of the desc topology. A dynamic topology
+    // may only change within the same point, line or triangle class.
+    DynamicStateFlags dynamic_states = DynamicStateFlags::kNone;
+    // Applied to every shader stage, ids that a stage does not declare are ignored.
+    std::vector<SpecializationConstant> specialization_constants;
 };
 
 struct ComputePipelineDesc {
     std::shared_ptr<Shader> shader;
     std::shared_ptr<BindingSetLayout> layout;
+    std::vector<SpecializationConstant> specialization_constants;
+    // 0 keeps the default subgroup size, otherwise a power of two within the device min/max subgroup size.
+    uint32_t required_subgroup_size = 0;
+    bool allow_varying_subgroup_size = false;
+    bool require_full_subgroups = false;
 };
 
 enum class RayTracingShaderGroupType {
@@ -393,6 +478,7 @@ struct RayTracingPipelineDesc {
     std::vector<std::shared_ptr<Shader>> shaders;
     std::shared_ptr<BindingSetLayout> layout;
     std::vector<RayTracingShaderGroup> groups;
+    std::vector<SpecializationConstant> specialization_constants;
 };
 
 struct RayTracingShaderTable {
@@ -607,6 +693,10 @@ constexpr uint64_t kAccelerationStructureAlignment = 256;
 
 enum class QueryHeapType {
     kAccelerationStructureCompactedSize,
+    kTimestamp,
+    kPipelineStatistics,
+    kOcclusion,
+    kBinaryOcclusion,
 };
 
 struct TextureDesc {
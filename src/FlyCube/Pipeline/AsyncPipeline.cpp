@@ -0,0 +1,75 @@
+#include "Pipeline/AsyncPipeline.h"
+
+#include "Device/Device.h"
+#include "Utilities/Trace.h"
+
+#include <chrono>
+
+AsyncPipeline::AsyncPipeline(std::shared_future<std::shared_ptr<Pipeline>> future)
+    : future_(std::move(future))
+{
+}
+
+bool AsyncPipeline::IsReady() const
+{
+    return future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::shared_ptr<Pipeline> AsyncPipeline::Get() const
+{
+    if (!IsReady()) {
+        return nullptr;
+    }
+    return future_.get();
+}
+
+const std::shared_ptr<Pipeline>& AsyncPipeline::Wait() const
+{
+    TRACE_SCOPE("AsyncPipeline::Wait");
+    return future_.get();
+}
+
+AsyncPipelineCompiler::AsyncPipelineCompiler(Device& device, uint32_t thread_count)
+    : device_(device)
+    , thread_pool_(thread_count)
+{
+}
+
+std::shared_ptr<AsyncPipeline> AsyncPipelineCompiler::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
+{
+    auto future = thread_pool_.Submit([this, desc] { return device_.CreateGraphicsPipeline(desc); });
+    return std::make_shared<AsyncPipeline>(future.share());
+}
+
+std::shared_ptr<AsyncPipeline> AsyncPipelineCompiler::CreateComputePipeline(const ComputePipelineDesc& desc)
+{
+    auto future = thread_pool_.Submit([this, desc] { return device_.CreateComputePipeline(desc); });
+    return std::make_shared<AsyncPipeline>(future.share());
+}
+
+std::vector<std::shared_ptr<AsyncPipeline>> AsyncPipelineCompiler::CreateGraphicsPipelines(
+    const std::vector<GraphicsPipelineDesc>& descs)
+{
+    std::vector<std::shared_ptr<AsyncPipeline>> pipelines;
+    pipelines.reserve(descs.size());
+    for (const auto& desc : descs) {
+        pipelines.emplace_back(CreateGraphicsPipeline(desc));
+    }
+    return pipelines;
+}
+
+std::vector<std::shared_ptr<AsyncPipeline>> AsyncPipelineCompiler::CreateComputePipelines(
+    const std::vector<ComputePipelineDesc>& descs)
+{
+    std::vector<std::shared_ptr<AsyncPipeline>> pipelines;
+    pipelines.reserve(descs.size());
+    for (const auto& desc : descs) {
+        pipelines.emplace_back(CreateComputePipeline(desc));
+    }
+    return pipelines;
+}
+
+void AsyncPipelineCompiler::WaitIdle()
+{
+    thread_pool_.WaitIdle();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Pipeline/Pipeline.h"
+#include "Utilities/ThreadPool.h"
+
+#include <future>
+#include <memory>
+#include <vector>
+
+class Device;
+
+enum class AsyncPipelineBindMode {
+    kWait,
+    kSkipIfNotReady,
+};
+
+class AsyncPipeline {
+public:
+    explicit AsyncPipeline(std::shared_future<std::shared_ptr<Pipeline>> future);
+
+    bool IsReady() const;
+    std::shared_ptr<Pipeline> Get() const;
+    const std::shared_ptr<Pipeline>& Wait() const;
+
+private:
+    std::shared_future<std::shared_ptr<Pipeline>> future_;
+};
+
+class AsyncPipelineCompiler {
+public:
+    AsyncPipelineCompiler(Device& device, uint32_t thread_count = 0);
+
+    std::shared_ptr<AsyncPipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc);
+    std::shared_ptr<AsyncPipeline> CreateComputePipeline(const ComputePipelineDesc& desc);
+    std::vector<std::shared_ptr<AsyncPipeline>> CreateGraphicsPipelines(const std::vector<GraphicsPipelineDesc>& descs);
+    std::vector<std::shared_ptr<AsyncPipeline>> CreateComputePipelines(const std::vector<ComputePipelineDesc>& descs);
+    void WaitIdle();
+
+private:
+    Device& device_;
+    ThreadPool thread_pool_;
+};
@@ -5,6 +5,7 @@
 #include "Pipeline/DXStateBuilder.h"
 #include "Shader/Shader.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/DXGIFormatHelper.h"
 #include "View/DXView.h"
 
@@ -16,6 +17,10 @@ DXComputePipeline::DXComputePipeline(DXDevice& device, const ComputePipelineDesc
     : device_(device)
     , desc_(desc)
 {
+    CHECK(desc_.specialization_constants.empty(), "Specialization constants are only supported by Vulkan");
+    // D3D12 takes the wave size from the [WaveSize] attribute of the shader.
+    CHECK(!desc_.required_subgroup_size && !desc_.require_full_subgroups,
+          "Subgroup size control is not supported by D3D12 pipelines");
     DXStateBuilder compute_state_builder;
 
     auto* dx_layout = CastToImpl<DXBindingSetLayout>(desc_.layout);
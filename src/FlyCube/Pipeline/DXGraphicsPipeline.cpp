@@ -41,6 +41,20 @@ D3D12_CULL_MODE ConvertCullMode(CullMode cull_mode)
     }
 }
 
+D3D12_PRIMITIVE_TOPOLOGY_TYPE ConvertPrimitiveTopologyClass(PrimitiveTopologyClass topology_class)
+{
+    switch (topology_class) {
+    case PrimitiveTopologyClass::kTriangle:
+        return D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    case PrimitiveTopologyClass::kLine:
+        return D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+    case PrimitiveTopologyClass::kPoint:
+        return D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT;
+    default:
+        NOTREACHED();
+    }
+}
+
 CD3DX12_RASTERIZER_DESC GetRasterizerDesc(const RasterizerDesc& desc)
 {
     CD3DX12_RASTERIZER_DESC rasterizer_desc(D3D12_DEFAULT);
@@ -236,10 +250,31 @@ std::pair<std::string, uint32_t> SplitSemanticName(std::string semantic_name)
 
 } // namespace
 
+D3D_PRIMITIVE_TOPOLOGY ConvertPrimitiveTopology(PrimitiveTopology topology)
+{
+    switch (topology) {
+    case PrimitiveTopology::kTriangleList:
+        return D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    case PrimitiveTopology::kTriangleStrip:
+        return D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+    case PrimitiveTopology::kLineList:
+        return D3D_PRIMITIVE_TOPOLOGY_LINELIST;
+    case PrimitiveTopology::kLineStrip:
+        return D3D_PRIMITIVE_TOPOLOGY_LINESTRIP;
+    case PrimitiveTopology::kPointList:
+        return D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
+    default:
+        NOTREACHED();
+    }
+}
+
 DXGraphicsPipeline::DXGraphicsPipeline(DXDevice& device, const GraphicsPipelineDesc& desc)
     : device_(device)
     , desc_(desc)
 {
+    CHECK((desc_.dynamic_states & ~device_.GetSupportedDynamicStates()) == DynamicStateFlags::kNone,
+          "Unsupported dynamic states {:#x}", static_cast<uint32_t>(desc_.dynamic_states));
+    CHECK(desc_.specialization_constants.empty(), "Specialization constants are only supported by Vulkan");
     DXStateBuilder graphics_state_builder;
 
     auto* dx_layout = CastToImpl<DXBindingSetLayout>(desc_.layout);
@@ -254,6 +289,8 @@ DXGraphicsPipeline::DXGraphicsPipeline(DXDevice& device, const GraphicsPipelineD
             graphics_state_builder.AddState<CD3DX12_PIPELINE_STATE_STREAM_VS>(shader_bytecode);
             ParseInputLayout(semantic_names);
             graphics_state_builder.AddState<CD3DX12_PIPELINE_STATE_STREAM_INPUT_LAYOUT>(GetInputLayoutDesc());
+            graphics_state_builder.AddState<CD3DX12_PIPELINE_STATE_STREAM_PRIMITIVE_TOPOLOGY>(
+                ConvertPrimitiveTopologyClass(GetPrimitiveTopologyClass(desc.topology)));
             graphics_state_builder.AddState<CD3DX12_PIPELINE_STATE_STREAM_DEPTH_STENCIL_FORMAT>(GetDSVFormat(desc));
             break;
         }
@@ -17,6 +17,8 @@ using Microsoft::WRL::ComPtr;
 class DXDevice;
 class Shader;
 
+D3D_PRIMITIVE_TOPOLOGY ConvertPrimitiveTopology(PrimitiveTopology topology);
+
 class DXGraphicsPipeline : public DXPipeline {
 public:
     DXGraphicsPipeline(DXDevice& device, const GraphicsPipelineDesc& desc);
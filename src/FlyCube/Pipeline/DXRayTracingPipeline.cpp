@@ -4,6 +4,7 @@
 #include "Device/DXDevice.h"
 #include "Shader/Shader.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/DXGIFormatHelper.h"
 #include "Utilities/SystemUtils.h"
 #include "View/DXView.h"
@@ -15,6 +16,7 @@ DXRayTracingPipeline::DXRayTracingPipeline(DXDevice& device, const RayTracingPip
     : device_(device)
     , desc_(desc)
 {
+    CHECK(desc_.specialization_constants.empty(), "Specialization constants are only supported by Vulkan");
     auto* dx_layout = CastToImpl<DXBindingSetLayout>(desc_.layout);
     root_signature_ = dx_layout->GetRootSignature();
 
@@ -3,6 +3,7 @@
 #include "Device/MTDevice.h"
 #include "Shader/MTShader.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 
@@ -11,6 +12,10 @@
 MTComputePipeline::MTComputePipeline(MTDevice& device, const ComputePipelineDesc& desc)
     : desc_(desc)
 {
+    CHECK(desc_.specialization_constants.empty(), "Specialization constants are only supported by Vulkan");
+    CHECK(!desc_.required_subgroup_size || desc_.required_subgroup_size == device.GetMaxSubgroupSize(),
+          "Unsupported subgroup size {}", desc_.required_subgroup_size);
+    CHECK(!desc_.require_full_subgroups, "Full subgroups are not supported by Metal pipelines");
     MTL4ComputePipelineDescriptor* pipeline_descriptor = [MTL4ComputePipelineDescriptor new];
     assert(desc_.shader->GetType() == ShaderType::kCompute);
     pipeline_descriptor.computeFunctionDescriptor = CastToImpl<MTShader>(desc_.shader)->GetFunctionDescriptor();
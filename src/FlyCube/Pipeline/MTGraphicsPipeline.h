@@ -6,6 +6,8 @@
 
 class MTDevice;
 
+MTLPrimitiveType ConvertPrimitiveTopology(PrimitiveTopology topology);
+
 class MTGraphicsPipeline : public MTPipeline {
 public:
     MTGraphicsPipeline(MTDevice& device, const GraphicsPipelineDesc& desc);
@@ -136,12 +136,47 @@ MTLBlendFactor ConvertBlendOp(BlendFactor factor)
     }
 }
 
+MTLPrimitiveTopologyClass ConvertPrimitiveTopologyClass(PrimitiveTopologyClass topology_class)
+{
+    switch (topology_class) {
+    case PrimitiveTopologyClass::kTriangle:
+        return MTLPrimitiveTopologyClassTriangle;
+    case PrimitiveTopologyClass::kLine:
+        return MTLPrimitiveTopologyClassLine;
+    case PrimitiveTopologyClass::kPoint:
+        return MTLPrimitiveTopologyClassPoint;
+    default:
+        NOTREACHED();
+    }
+}
+
 } // namespace
 
+MTLPrimitiveType ConvertPrimitiveTopology(PrimitiveTopology topology)
+{
+    switch (topology) {
+    case PrimitiveTopology::kTriangleList:
+        return MTLPrimitiveTypeTriangle;
+    case PrimitiveTopology::kTriangleStrip:
+        return MTLPrimitiveTypeTriangleStrip;
+    case PrimitiveTopology::kLineList:
+        return MTLPrimitiveTypeLine;
+    case PrimitiveTopology::kLineStrip:
+        return MTLPrimitiveTypeLineStrip;
+    case PrimitiveTopology::kPointList:
+        return MTLPrimitiveTypePoint;
+    default:
+        NOTREACHED();
+    }
+}
+
 MTGraphicsPipeline::MTGraphicsPipeline(MTDevice& device, const GraphicsPipelineDesc& desc)
     : device_(device)
     , desc_(desc)
 {
+    CHECK((desc_.dynamic_states & ~device_.GetSupportedDynamicStates()) == DynamicStateFlags::kNone,
+          "Unsupported dynamic states {:#x}", static_cast<uint32_t>(desc_.dynamic_states));
+    CHECK(desc_.specialization_constants.empty(), "Specialization constants are only supported by Vulkan");
     for (const auto& shader : desc.shaders) {
         shader_by_type_[shader->GetType()] = shader;
     }
@@ -197,7 +232,8 @@ void MTGraphicsPipeline::CreatePipeline()
         pipeline_descriptor.colorAttachments[i].pixelFormat = device_.GetMTLPixelFormat(desc_.color_formats[i]);
     }
     if constexpr (!is_mesh_pipeline) {
-        pipeline_descriptor.inputPrimitiveTopology = MTLPrimitiveTopologyClassTriangle;
+        pipeline_descriptor.inputPrimitiveTopology =
+            ConvertPrimitiveTopologyClass(GetPrimitiveTopologyClass(desc_.topology));
     }
     pipeline_descriptor.rasterSampleCount = desc_.sample_count;
 
@@ -0,0 +1,286 @@
+#include "Pipeline/PipelineDescCache.h"
+
+#include "Shader/Shader.h"
+#include "Utilities/BinaryStream.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+constexpr size_t kMinPruneThreshold = 64;
+
+enum class PipelineKeyType : uint8_t {
+    kGraphics,
+    kCompute,
+    kVertexInputLibrary,
+    kPreRasterizationShadersLibrary,
+    kFragmentShaderLibrary,
+    kFragmentOutputLibrary,
+};
+
+std::string GetKey(const BinaryWriter& writer)
+{
+    decltype(auto) data = writer.GetData();
+    return std::string(data.begin(), data.end());
+}
+
+void WriteSpecializationConstants(BinaryWriter& writer, const std::vector<SpecializationConstant>& constants)
+{
+    writer.Write<uint64_t>(constants.size());
+    for (const auto& constant : constants) {
+        writer.Write(constant.id);
+        writer.Write(constant.value);
+    }
+}
+
+void WriteStencilOp(BinaryWriter& writer, const StencilOpDesc& desc)
+{
+    writer.Write(desc.fail_op);
+    writer.Write(desc.depth_fail_op);
+    writer.Write(desc.pass_op);
+    writer.Write(desc.func);
+}
+
+void WriteRasterizerDesc(BinaryWriter& writer, const RasterizerDesc& desc)
+{
+    writer.Write(desc.fill_mode);
+    writer.Write(desc.cull_mode);
+    writer.Write(desc.front_face);
+    writer.Write(desc.depth_bias);
+    writer.Write(desc.depth_bias_clamp);
+    writer.Write(desc.slope_scaled_depth_bias);
+    writer.Write(desc.depth_clip_enable);
+}
+
+void WriteDepthStencilDesc(BinaryWriter& writer, const DepthStencilDesc& desc)
+{
+    writer.Write(desc.depth_test_enable);
+    writer.Write(desc.depth_write_enable);
+    writer.Write(desc.depth_func);
+    writer.Write(desc.depth_bounds_test_enable);
+    writer.Write(desc.stencil_enable);
+    writer.Write(desc.stencil_read_mask);
+    writer.Write(desc.stencil_write_mask);
+    WriteStencilOp(writer, desc.front_face);
+    WriteStencilOp(writer, desc.back_face);
+}
+
+void WriteBlendDesc(BinaryWriter& writer, const BlendDesc& desc)
+{
+    writer.Write(desc.blend_enable);
+    writer.Write(desc.src_color_blend_factor);
+    writer.Write(desc.dst_color_blend_factor);
+    writer.Write(desc.color_blend_op);
+    writer.Write(desc.src_alpha_blend_factor);
+    writer.Write(desc.dst_alpha_blend_factor);
+    writer.Write(desc.alpha_blend_op);
+    writer.Write(desc.color_write_mask);
+}
+
+void WriteLibraryShaders(BinaryWriter& writer, const GraphicsPipelineDesc& desc, bool fragment)
+{
+    for (const auto& shader : GetGraphicsPipelineLibraryShaders(desc, fragment)) {
+        writer.Write(shader.get());
+    }
+    WriteSpecializationConstants(writer, desc.specialization_constants);
+}
+
+// Fields are written one by one, padding bytes of the desc structs must not end up in the key.
+std::string GetKey(const GraphicsPipelineDesc& desc)
+{
+    BinaryWriter writer;
+    writer.Write(PipelineKeyType::kGraphics);
+    writer.Write<uint64_t>(desc.shaders.size());
+    for (const auto& shader : desc.shaders) {
+        writer.Write(shader.get());
+    }
+    writer.Write(desc.layout.get());
+    writer.Write<uint64_t>(desc.input.size());
+    for (const auto& input : desc.input) {
+        writer.Write(input.slot);
+        writer.WriteArray(input.semantic_name);
+        writer.Write(input.format);
+        writer.Write(input.stride);
+        writer.Write(input.offset);
+    }
+    writer.Write<uint64_t>(desc.color_formats.size());
+    for (const auto& format : desc.color_formats) {
+        writer.Write(format);
+    }
+    writer.Write(desc.depth_stencil_format);
+    writer.Write(desc.sample_count);
+    writer.Write(desc.dynamic_states);
+    WriteSpecializationConstants(writer, desc.specialization_constants);
+
+    // Command lists never read the desc values of dynamic states, see GraphicsPipelineDesc::dynamic_states.
+    if (desc.dynamic_states & DynamicStateFlags::kPrimitiveTopology) {
+        writer.Write(GetPrimitiveTopologyClass(desc.topology));
+    } else {
+        writer.Write(desc.topology);
+    }
+    RasterizerDesc rasterizer_desc = desc.rasterizer_desc;
+    if (desc.dynamic_states & DynamicStateFlags::kCullMode) {
+        rasterizer_desc.cull_mode = {};
+    }
+    if (desc.dynamic_states & DynamicStateFlags::kFrontFace) {
+        rasterizer_desc.front_face = {};
+    }
+    WriteRasterizerDesc(writer, rasterizer_desc);
+    if (!(desc.dynamic_states & DynamicStateFlags::kDepthStencil)) {
+        WriteDepthStencilDesc(writer, desc.depth_stencil_desc);
+    }
+    if (!(desc.dynamic_states & DynamicStateFlags::kBlend)) {
+        WriteBlendDesc(writer, desc.blend_desc);
+    }
+    return GetKey(writer);
+}
+
+std::string GetKey(const ComputePipelineDesc& desc)
+{
+    BinaryWriter writer;
+    writer.Write(PipelineKeyType::kCompute);
+    writer.Write(desc.shader.get());
+    writer.Write(desc.layout.get());
+    WriteSpecializationConstants(writer, desc.specialization_constants);
+    writer.Write(desc.required_subgroup_size);
+    writer.Write(desc.allow_varying_subgroup_size);
+    writer.Write(desc.require_full_subgroups);
+    return GetKey(writer);
+}
+
+} // namespace
+
+std::vector<std::shared_ptr<Shader>> GetGraphicsPipelineLibraryShaders(const GraphicsPipelineDesc& desc, bool fragment)
+{
+    std::vector<std::shared_ptr<Shader>> shaders;
+    std::copy_if(desc.shaders.begin(), desc.shaders.end(), std::back_inserter(shaders),
+                 [&](const auto& shader) { return (shader->GetType() == ShaderType::kPixel) == fragment; });
+    return shaders;
+}
+
+GraphicsPipelineLibraryKeys GetGraphicsPipelineLibraryKeys(const GraphicsPipelineDesc& desc)
+{
+    GraphicsPipelineLibraryKeys keys;
+    auto vertex_shader = std::find_if(desc.shaders.begin(), desc.shaders.end(),
+                                      [](const auto& shader) { return shader->GetType() == ShaderType::kVertex; });
+    if (vertex_shader != desc.shaders.end()) {
+        BinaryWriter writer;
+        writer.Write(PipelineKeyType::kVertexInputLibrary);
+        // Only the topology class is fixed when the topology is dynamic.
+        bool dynamic_topology = !!(desc.dynamic_states & DynamicStateFlags::kPrimitiveTopology);
+        writer.Write(dynamic_topology);
+        if (dynamic_topology) {
+            writer.Write(GetPrimitiveTopologyClass(desc.topology));
+        } else {
+            writer.Write(desc.topology);
+        }
+        // Attributes are written with their resolved location, so the part does not depend on the shader.
+        writer.Write<uint64_t>(desc.input.size());
+        for (const auto& input : desc.input) {
+            writer.Write(input.slot);
+            writer.Write((*vertex_shader)->GetInputLayoutLocation(input.semantic_name));
+            writer.Write(input.format);
+            writer.Write(input.stride);
+            writer.Write(input.offset);
+        }
+        keys.vertex_input = GetKey(writer);
+    }
+
+    RasterizerDesc rasterizer_desc = desc.rasterizer_desc;
+    if (desc.dynamic_states & DynamicStateFlags::kCullMode) {
+        rasterizer_desc.cull_mode = {};
+    }
+    if (desc.dynamic_states & DynamicStateFlags::kFrontFace) {
+        rasterizer_desc.front_face = {};
+    }
+    BinaryWriter pre_rasterization_writer;
+    pre_rasterization_writer.Write(PipelineKeyType::kPreRasterizationShadersLibrary);
+    pre_rasterization_writer.Write(desc.layout.get());
+    WriteRasterizerDesc(pre_rasterization_writer, rasterizer_desc);
+    WriteLibraryShaders(pre_rasterization_writer, desc, /*fragment=*/false);
+    keys.pre_rasterization_shaders = GetKey(pre_rasterization_writer);
+
+    DepthStencilDesc depth_stencil_desc = desc.depth_stencil_desc;
+    if (desc.dynamic_states & DynamicStateFlags::kDepthStencil) {
+        depth_stencil_desc = {};
+    }
+    BinaryWriter fragment_shader_writer;
+    fragment_shader_writer.Write(PipelineKeyType::kFragmentShaderLibrary);
+    fragment_shader_writer.Write(desc.layout.get());
+    fragment_shader_writer.Write(desc.sample_count);
+    WriteDepthStencilDesc(fragment_shader_writer, depth_stencil_desc);
+    WriteLibraryShaders(fragment_shader_writer, desc, /*fragment=*/true);
+    keys.fragment_shader = GetKey(fragment_shader_writer);
+
+    BlendDesc blend_desc = desc.blend_desc;
+    if (desc.dynamic_states & DynamicStateFlags::kBlend) {
+        blend_desc = {};
+    }
+    BinaryWriter fragment_output_writer;
+    fragment_output_writer.Write(PipelineKeyType::kFragmentOutputLibrary);
+    fragment_output_writer.Write(desc.sample_count);
+    fragment_output_writer.Write(desc.depth_stencil_format);
+    WriteBlendDesc(fragment_output_writer, blend_desc);
+    fragment_output_writer.Write<uint64_t>(desc.color_formats.size());
+    for (const auto& format : desc.color_formats) {
+        fragment_output_writer.Write(format);
+    }
+    keys.fragment_output = GetKey(fragment_output_writer);
+    return keys;
+}
+
+std::shared_ptr<Pipeline> PipelineDescCache::GetOrCreate(const GraphicsPipelineDesc& desc,
+                                                         const CreateCallback& create)
+{
+    return GetOrCreate(GetKey(desc), create);
+}
+
+std::shared_ptr<Pipeline> PipelineDescCache::GetOrCreate(const ComputePipelineDesc& desc,
+                                                         const CreateCallback& create)
+{
+    return GetOrCreate(GetKey(desc), create);
+}
+
+std::shared_ptr<Pipeline> PipelineDescCache::GetOrCreate(const std::string& key, const CreateCallback& create)
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto it = pipelines_.find(key);
+        if (it != pipelines_.end()) {
+            if (auto pipeline = it->second.lock()) {
+                ++hits_;
+                return pipeline;
+            }
+        }
+        ++misses_;
+    }
+
+    // Pipelines are created outside of the lock so that different descs still compile in parallel.
+    std::shared_ptr<Pipeline> pipeline = create();
+
+    std::lock_guard lock(mutex_);
+    auto& entry = pipelines_[key];
+    if (auto existing = entry.lock()) {
+        return existing;
+    }
+    entry = pipeline;
+    if (pipelines_.size() >= prune_threshold_) {
+        PruneExpired();
+    }
+    return pipeline;
+}
+
+void PipelineDescCache::PruneExpired()
+{
+    std::erase_if(pipelines_, [](const auto& entry) { return entry.second.expired(); });
+    prune_threshold_ = std::max(kMinPruneThreshold, pipelines_.size() * 2);
+}
+
+PipelineDescCacheStats PipelineDescCache::GetStats() const
+{
+    std::lock_guard lock(mutex_);
+    uint64_t live_pipelines = std::count_if(pipelines_.begin(), pipelines_.end(),
+                                            [](const auto& entry) { return !entry.second.expired(); });
+    return { hits_, misses_, live_pipelines };
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Pipeline/Pipeline.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct PipelineDescCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t live_pipelines;
+};
+
+// Returns the already created pipeline for an identical desc. Shaders and layouts are compared by identity. States
+// declared dynamic are ignored, only the class of a dynamic topology has to match. Command lists resolve unset dynamic
+// states without reading the desc of the bound pipeline, so the pipeline of another desc draws the same way.
+// Entries only hold weak references, so unused pipelines are still destroyed; the pointers in a key stay valid while
+// its pipeline is alive because every pipeline keeps its desc.
+class PipelineDescCache {
+public:
+    using CreateCallback = std::function<std::shared_ptr<Pipeline>()>;
+
+    std::shared_ptr<Pipeline> GetOrCreate(const GraphicsPipelineDesc& desc, const CreateCallback& create);
+    std::shared_ptr<Pipeline> GetOrCreate(const ComputePipelineDesc& desc, const CreateCallback& create);
+    PipelineDescCacheStats GetStats() const;
+
+private:
+    std::shared_ptr<Pipeline> GetOrCreate(const std::string& key, const CreateCallback& create);
+    void PruneExpired();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<Pipeline>> pipelines_;
+    size_t prune_threshold_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+// Keys of the parts VK_EXT_graphics_pipeline_library splits a graphics pipeline into. States declared dynamic are left
+// out, so that one part serves every value of them. Like above, shaders and layouts are compared by identity, so a
+// cached part has to keep the objects returned by GetGraphicsPipelineLibraryShaders and the layout alive.
+struct GraphicsPipelineLibraryKeys {
+    // Empty for mesh shading pipelines, they have no vertex input state.
+    std::string vertex_input;
+    std::string pre_rasterization_shaders;
+    std::string fragment_shader;
+    std::string fragment_output;
+};
+
+GraphicsPipelineLibraryKeys GetGraphicsPipelineLibraryKeys(const GraphicsPipelineDesc& desc);
+std::vector<std::shared_ptr<Shader>> GetGraphicsPipelineLibraryShaders(const GraphicsPipelineDesc& desc, bool fragment);
@@ -3,18 +3,56 @@
 #include "Device/VKDevice.h"
 #include "Pipeline/VKGraphicsPipeline.h"
 #include "Shader/Shader.h"
+#include "Utilities/Check.h"
 
+#include <bit>
 #include <map>
 
 VKComputePipeline::VKComputePipeline(VKDevice& device, const ComputePipelineDesc& desc)
-    : VKPipeline(device, { desc.shader }, desc.layout)
+    : VKPipeline(device, { desc.shader }, desc.layout, desc.specialization_constants)
     , desc_(desc)
 {
     vk::ComputePipelineCreateInfo pipeline_info = {};
     assert(shader_stage_create_info_.size() == 1);
     pipeline_info.stage = shader_stage_create_info_.front();
+
+    const auto& numthreads = desc_.shader->GetReflection()->GetShaderFeatureInfo().numthreads;
+    uint32_t thread_count = numthreads[0] * numthreads[1] * numthreads[2];
+    vk::PipelineShaderStageRequiredSubgroupSizeCreateInfo required_subgroup_size_info = {};
+    if (desc_.required_subgroup_size) {
+        CHECK(device_.IsSubgroupSizeControlSupported(), "Subgroup size control is not supported");
+        CHECK(std::has_single_bit(desc_.required_subgroup_size) &&
+                  desc_.required_subgroup_size >= device_.GetMinSubgroupSize() &&
+                  desc_.required_subgroup_size <= device_.GetMaxSubgroupSize(),
+              "Unsupported subgroup size {}", desc_.required_subgroup_size);
+        CHECK(!desc_.allow_varying_subgroup_size, "A required subgroup size can not vary");
+        CHECK(thread_count <= desc_.required_subgroup_size * device_.GetMaxComputeWorkgroupSubgroups(),
+              "Workgroup of {} threads needs more than {} subgroups of size {}", thread_count,
+              device_.GetMaxComputeWorkgroupSubgroups(), desc_.required_subgroup_size);
+        required_subgroup_size_info.requiredSubgroupSize = desc_.required_subgroup_size;
+        pipeline_info.stage.pNext = &required_subgroup_size_info;
+    }
+    if (desc_.allow_varying_subgroup_size) {
+        CHECK(device_.IsSubgroupSizeControlSupported(), "Subgroup size control is not supported");
+        pipeline_info.stage.flags |= vk::PipelineShaderStageCreateFlagBits::eAllowVaryingSubgroupSize;
+    }
+    if (desc_.require_full_subgroups) {
+        CHECK(device_.IsComputeFullSubgroupsSupported(), "Full compute subgroups are not supported");
+        // A varying subgroup size may be anything up to the maximum, otherwise the pipeline uses the default size.
+        uint32_t subgroup_size = desc_.required_subgroup_size;
+        if (!subgroup_size) {
+            subgroup_size = desc_.allow_varying_subgroup_size ? device_.GetMaxSubgroupSize()
+                                                              : device_.GetDefaultSubgroupSize();
+        }
+        CHECK(numthreads[0] % subgroup_size == 0, "Workgroup width {} is not a multiple of the subgroup size {}",
+              numthreads[0], subgroup_size);
+        pipeline_info.stage.flags |= vk::PipelineShaderStageCreateFlagBits::eRequireFullSubgroups;
+    }
+
     pipeline_info.layout = pipeline_layout_;
-    pipeline_ = device_.GetDevice().createComputePipelineUnique({}, pipeline_info).value;
+    pipeline_info.pNext = ChainCreationFeedback(pipeline_info.pNext);
+    pipeline_ = device_.GetDevice().createComputePipelineUnique(device_.GetPipelineCache(), pipeline_info).value;
+    ReportCreationFeedback();
 }
 
 PipelineType VKComputePipeline::GetPipelineType() const
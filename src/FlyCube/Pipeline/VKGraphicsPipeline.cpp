@@ -1,8 +1,11 @@
 #include "Pipeline/VKGraphicsPipeline.h"
 
 #include "Device/VKDevice.h"
+#include "Pipeline/PipelineDescCache.h"
+#include "Utilities/BinaryStream.h"
 #include "Utilities/Check.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/Trace.h"
 
 namespace {
 
@@ -30,19 +33,6 @@ vk::StencilOp Convert(StencilOp op)
     }
 }
 
-vk::StencilOpState Convert(const StencilOpDesc& desc, uint8_t read_mask, uint8_t write_mask)
-{
-    vk::StencilOpState stencil_op_state = {};
-    stencil_op_state.failOp = Convert(desc.fail_op);
-    stencil_op_state.passOp = Convert(desc.pass_op);
-    stencil_op_state.depthFailOp = Convert(desc.depth_fail_op);
-    stencil_op_state.compareOp = ConvertToCompareOp(desc.func);
-    stencil_op_state.compareMask = read_mask;
-    stencil_op_state.writeMask = write_mask;
-    stencil_op_state.reference = 0;
-    return stencil_op_state;
-}
-
 vk::PolygonMode ConvertFillMode(FillMode fill_mode)
 {
     switch (fill_mode) {
@@ -56,32 +46,6 @@ vk::PolygonMode ConvertFillMode(FillMode fill_mode)
     }
 }
 
-vk::CullModeFlags ConvertCullMode(CullMode cull_mode)
-{
-    switch (cull_mode) {
-    case CullMode::kNone:
-        return vk::CullModeFlagBits::eNone;
-    case CullMode::kFront:
-        return vk::CullModeFlagBits::eFront;
-    case CullMode::kBack:
-        return vk::CullModeFlagBits::eBack;
-    default:
-        NOTREACHED();
-    }
-}
-
-vk::FrontFace ConvertFrontFace(FrontFace front_face)
-{
-    switch (front_face) {
-    case FrontFace::kClockwise:
-        return vk::FrontFace::eClockwise;
-    case FrontFace::kCounterClockwise:
-        return vk::FrontFace::eCounterClockwise;
-    default:
-        NOTREACHED();
-    }
-}
-
 vk::PipelineRasterizationStateCreateInfo ConvertRasterizerDesc(const RasterizerDesc& desc)
 {
     vk::PipelineRasterizationStateCreateInfo pipeline_rasterization_state_info = {};
@@ -164,10 +128,95 @@ vk::BlendFactor ConvertBlendOp(BlendFactor factor)
 
 } // namespace
 
+vk::PrimitiveTopology ConvertPrimitiveTopology(PrimitiveTopology topology)
+{
+    switch (topology) {
+    case PrimitiveTopology::kTriangleList:
+        return vk::PrimitiveTopology::eTriangleList;
+    case PrimitiveTopology::kTriangleStrip:
+        return vk::PrimitiveTopology::eTriangleStrip;
+    case PrimitiveTopology::kLineList:
+        return vk::PrimitiveTopology::eLineList;
+    case PrimitiveTopology::kLineStrip:
+        return vk::PrimitiveTopology::eLineStrip;
+    case PrimitiveTopology::kPointList:
+        return vk::PrimitiveTopology::ePointList;
+    default:
+        NOTREACHED();
+    }
+}
+
+vk::CullModeFlags ConvertCullMode(CullMode cull_mode)
+{
+    switch (cull_mode) {
+    case CullMode::kNone:
+        return vk::CullModeFlagBits::eNone;
+    case CullMode::kFront:
+        return vk::CullModeFlagBits::eFront;
+    case CullMode::kBack:
+        return vk::CullModeFlagBits::eBack;
+    default:
+        NOTREACHED();
+    }
+}
+
+vk::FrontFace ConvertFrontFace(FrontFace front_face)
+{
+    switch (front_face) {
+    case FrontFace::kClockwise:
+        return vk::FrontFace::eClockwise;
+    case FrontFace::kCounterClockwise:
+        return vk::FrontFace::eCounterClockwise;
+    default:
+        NOTREACHED();
+    }
+}
+
+vk::StencilOpState ConvertStencilOpDesc(const StencilOpDesc& desc, uint8_t read_mask, uint8_t write_mask)
+{
+    vk::StencilOpState stencil_op_state = {};
+    stencil_op_state.failOp = Convert(desc.fail_op);
+    stencil_op_state.passOp = Convert(desc.pass_op);
+    stencil_op_state.depthFailOp = Convert(desc.depth_fail_op);
+    stencil_op_state.compareOp = ConvertToCompareOp(desc.func);
+    stencil_op_state.compareMask = read_mask;
+    stencil_op_state.writeMask = write_mask;
+    stencil_op_state.reference = 0;
+    return stencil_op_state;
+}
+
+vk::PipelineColorBlendAttachmentState ConvertBlendDesc(const BlendDesc& desc)
+{
+    vk::PipelineColorBlendAttachmentState color_blend_attachment = {};
+    color_blend_attachment.blendEnable = desc.blend_enable;
+    color_blend_attachment.srcColorBlendFactor = ConvertBlendOp(desc.src_color_blend_factor);
+    color_blend_attachment.dstColorBlendFactor = ConvertBlendOp(desc.dst_color_blend_factor);
+    color_blend_attachment.colorBlendOp = ConvertBlendOp(desc.color_blend_op);
+    color_blend_attachment.srcAlphaBlendFactor = ConvertBlendOp(desc.src_alpha_blend_factor);
+    color_blend_attachment.dstAlphaBlendFactor = ConvertBlendOp(desc.dst_alpha_blend_factor);
+    color_blend_attachment.alphaBlendOp = ConvertBlendOp(desc.alpha_blend_op);
+    color_blend_attachment.colorWriteMask = {};
+    if (desc.color_write_mask & ColorComponentFlagBits::kRed) {
+        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eR;
+    }
+    if (desc.color_write_mask & ColorComponentFlagBits::kGreen) {
+        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eG;
+    }
+    if (desc.color_write_mask & ColorComponentFlagBits::kBlue) {
+        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eB;
+    }
+    if (desc.color_write_mask & ColorComponentFlagBits::kAlpha) {
+        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eA;
+    }
+    return color_blend_attachment;
+}
+
 VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineDesc& desc)
-    : VKPipeline(device, desc.shaders, desc.layout)
+    : VKPipeline(device, desc.shaders, desc.layout, desc.specialization_constants)
     , desc_(desc)
 {
+    CHECK((desc_.dynamic_states & ~device_.GetSupportedDynamicStates()) == DynamicStateFlags::kNone,
+          "Unsupported dynamic states {:#x}", static_cast<uint32_t>(desc_.dynamic_states));
     for (const auto& shader : desc.shaders) {
         if (shader->GetType() == ShaderType::kVertex) {
             CreateInputLayout(shader);
@@ -181,7 +230,7 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
     vertex_input_info.pVertexAttributeDescriptions = attribute_desc_.data();
 
     vk::PipelineInputAssemblyStateCreateInfo input_assembly = {};
-    input_assembly.topology = vk::PrimitiveTopology::eTriangleList;
+    input_assembly.topology = ConvertPrimitiveTopology(desc_.topology);
     input_assembly.primitiveRestartEnable = VK_FALSE;
 
     vk::PipelineViewportStateCreateInfo viewport_state = {};
@@ -190,27 +239,7 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
 
     vk::PipelineRasterizationStateCreateInfo rasterizer = ConvertRasterizerDesc(desc.rasterizer_desc);
 
-    vk::PipelineColorBlendAttachmentState color_blend_attachment = {};
-    color_blend_attachment.blendEnable = desc_.blend_desc.blend_enable;
-    color_blend_attachment.srcColorBlendFactor = ConvertBlendOp(desc_.blend_desc.src_color_blend_factor);
-    color_blend_attachment.dstColorBlendFactor = ConvertBlendOp(desc_.blend_desc.dst_color_blend_factor);
-    color_blend_attachment.colorBlendOp = ConvertBlendOp(desc_.blend_desc.color_blend_op);
-    color_blend_attachment.srcAlphaBlendFactor = ConvertBlendOp(desc_.blend_desc.src_alpha_blend_factor);
-    color_blend_attachment.dstAlphaBlendFactor = ConvertBlendOp(desc_.blend_desc.dst_alpha_blend_factor);
-    color_blend_attachment.alphaBlendOp = ConvertBlendOp(desc_.blend_desc.alpha_blend_op);
-    color_blend_attachment.colorWriteMask = {};
-    if (desc_.blend_desc.color_write_mask & ColorComponentFlagBits::kRed) {
-        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eR;
-    }
-    if (desc_.blend_desc.color_write_mask & ColorComponentFlagBits::kGreen) {
-        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eG;
-    }
-    if (desc_.blend_desc.color_write_mask & ColorComponentFlagBits::kBlue) {
-        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eB;
-    }
-    if (desc_.blend_desc.color_write_mask & ColorComponentFlagBits::kAlpha) {
-        color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eA;
-    }
+    vk::PipelineColorBlendAttachmentState color_blend_attachment = ConvertBlendDesc(desc_.blend_desc);
 
     std::vector<vk::PipelineColorBlendAttachmentState> color_blend_attachments(desc_.color_formats.size(),
                                                                                color_blend_attachment);
@@ -231,10 +260,12 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
     depth_stencil.depthCompareOp = ConvertToCompareOp(desc_.depth_stencil_desc.depth_func);
     depth_stencil.depthBoundsTestEnable = desc_.depth_stencil_desc.depth_bounds_test_enable;
     depth_stencil.stencilTestEnable = desc_.depth_stencil_desc.stencil_enable;
-    depth_stencil.back = Convert(desc_.depth_stencil_desc.back_face, desc_.depth_stencil_desc.stencil_read_mask,
-                                 desc_.depth_stencil_desc.stencil_write_mask);
-    depth_stencil.front = Convert(desc_.depth_stencil_desc.front_face, desc_.depth_stencil_desc.stencil_read_mask,
-                                  desc_.depth_stencil_desc.stencil_write_mask);
+    depth_stencil.back = ConvertStencilOpDesc(desc_.depth_stencil_desc.back_face,
+                                              desc_.depth_stencil_desc.stencil_read_mask,
+                                              desc_.depth_stencil_desc.stencil_write_mask);
+    depth_stencil.front = ConvertStencilOpDesc(desc_.depth_stencil_desc.front_face,
+                                               desc_.depth_stencil_desc.stencil_read_mask,
+                                               desc_.depth_stencil_desc.stencil_write_mask);
     depth_stencil.minDepthBounds = 0.0;
     depth_stencil.maxDepthBounds = 1.0;
 
@@ -247,9 +278,30 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
     if (device_.IsVariableRateShadingSupported()) {
         dynamic_state_enables.push_back(vk::DynamicState::eFragmentShadingRateKHR);
     }
-    if (depth_stencil.depthBoundsTestEnable) {
+    if (depth_stencil.depthBoundsTestEnable || (desc_.dynamic_states & DynamicStateFlags::kDepthStencil)) {
         dynamic_state_enables.push_back(vk::DynamicState::eDepthBounds);
     }
+    if (desc_.dynamic_states & DynamicStateFlags::kPrimitiveTopology) {
+        dynamic_state_enables.push_back(vk::DynamicState::ePrimitiveTopology);
+    }
+    if (desc_.dynamic_states & DynamicStateFlags::kCullMode) {
+        dynamic_state_enables.push_back(vk::DynamicState::eCullMode);
+    }
+    if (desc_.dynamic_states & DynamicStateFlags::kFrontFace) {
+        dynamic_state_enables.push_back(vk::DynamicState::eFrontFace);
+    }
+    if (desc_.dynamic_states & DynamicStateFlags::kDepthStencil) {
+        dynamic_state_enables.insert(dynamic_state_enables.end(),
+                                     { vk::DynamicState::eDepthTestEnable, vk::DynamicState::eDepthWriteEnable,
+                                       vk::DynamicState::eDepthCompareOp, vk::DynamicState::eDepthBoundsTestEnable,
+                                       vk::DynamicState::eStencilTestEnable, vk::DynamicState::eStencilOp,
+                                       vk::DynamicState::eStencilCompareMask, vk::DynamicState::eStencilWriteMask });
+    }
+    if (desc_.dynamic_states & DynamicStateFlags::kBlend) {
+        dynamic_state_enables.insert(dynamic_state_enables.end(),
+                                     { vk::DynamicState::eColorBlendEnableEXT, vk::DynamicState::eColorBlendEquationEXT,
+                                       vk::DynamicState::eColorWriteMaskEXT });
+    }
 
     vk::PipelineDynamicStateCreateInfo pipeline_dynamic_state_info = {};
     pipeline_dynamic_state_info.pDynamicStates = dynamic_state_enables.data();
@@ -285,9 +337,158 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
     if (desc_.depth_stencil_format != gli::format::FORMAT_UNDEFINED && gli::is_stencil(desc_.depth_stencil_format)) {
         pipeline_rendering_info.stencilAttachmentFormat = static_cast<vk::Format>(desc_.depth_stencil_format);
     }
-    pipeline_info.pNext = &pipeline_rendering_info;
 
-    pipeline_ = device_.GetDevice().createGraphicsPipelineUnique({}, pipeline_info).value;
+    if (device_.IsGraphicsPipelineLibrarySupported()) {
+        pipeline_info.pNext = &pipeline_rendering_info;
+        CreateFromLibraries(pipeline_info, dynamic_state_enables);
+    } else {
+        pipeline_info.pNext = ChainCreationFeedback(&pipeline_rendering_info);
+        pipeline_ =
+            device_.GetDevice().createGraphicsPipelineUnique(device_.GetPipelineCache(), pipeline_info).value;
+    }
+    ReportCreationFeedback();
+}
+
+void VKGraphicsPipeline::CreateFromLibraries(const vk::GraphicsPipelineCreateInfo& pipeline_info,
+                                             const std::vector<vk::DynamicState>& dynamic_states)
+{
+    TRACE_SCOPE("VKGraphicsPipeline::CreateFromLibraries");
+    auto create_part = [&](vk::GraphicsPipelineLibraryFlagsEXT part, vk::GraphicsPipelineCreateInfo part_info) {
+        vk::GraphicsPipelineLibraryCreateInfoEXT library_info = {};
+        library_info.flags = part;
+        library_info.pNext = pipeline_info.pNext;
+        part_info.pNext = &library_info;
+        part_info.flags = pipeline_info.flags | vk::PipelineCreateFlagBits::eLibraryKHR |
+                          vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+        part_info.pDynamicState = pipeline_info.pDynamicState;
+        return device_.GetDevice().createGraphicsPipelineUnique(device_.GetPipelineCache(), part_info).value;
+    };
+
+    std::vector<vk::PipelineShaderStageCreateInfo> pre_rasterization_stages;
+    std::vector<vk::PipelineShaderStageCreateInfo> fragment_stages;
+    for (const auto& stage : shader_stage_create_info_) {
+        if (stage.stage == vk::ShaderStageFlagBits::eFragment) {
+            fragment_stages.push_back(stage);
+        } else {
+            pre_rasterization_stages.push_back(stage);
+        }
+    }
+
+    // Every part is created with the same flags and dynamic states, which depend on the device as well as the desc.
+    BinaryWriter writer;
+    writer.Write(static_cast<VkPipelineCreateFlags>(pipeline_info.flags));
+    writer.Write<uint64_t>(dynamic_states.size());
+    for (const auto& dynamic_state : dynamic_states) {
+        writer.Write(dynamic_state);
+    }
+    std::string prefix(writer.GetData().begin(), writer.GetData().end());
+
+    auto& cache = device_.GetGraphicsPipelineLibraryCache();
+    GraphicsPipelineLibraryKeys keys = GetGraphicsPipelineLibraryKeys(desc_);
+    if (!keys.vertex_input.empty()) {
+        libraries_.push_back(cache.GetOrCreate(prefix + keys.vertex_input, nullptr, {}, [&] {
+            vk::GraphicsPipelineCreateInfo part_info = {};
+            part_info.pVertexInputState = pipeline_info.pVertexInputState;
+            part_info.pInputAssemblyState = pipeline_info.pInputAssemblyState;
+            return create_part(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface, part_info);
+        }));
+    }
+
+    auto create_pre_rasterization_shaders = [&] {
+        vk::GraphicsPipelineCreateInfo part_info = {};
+        part_info.stageCount = pre_rasterization_stages.size();
+        part_info.pStages = pre_rasterization_stages.data();
+        part_info.pViewportState = pipeline_info.pViewportState;
+        part_info.pRasterizationState = pipeline_info.pRasterizationState;
+        part_info.layout = pipeline_layout_;
+        return create_part(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders, part_info);
+    };
+    libraries_.push_back(cache.GetOrCreate(prefix + keys.pre_rasterization_shaders, desc_.layout,
+                                           GetGraphicsPipelineLibraryShaders(desc_, /*fragment=*/false),
+                                           create_pre_rasterization_shaders));
+
+    auto create_fragment_shader = [&] {
+        vk::GraphicsPipelineCreateInfo part_info = {};
+        part_info.stageCount = fragment_stages.size();
+        part_info.pStages = fragment_stages.data();
+        part_info.pDepthStencilState = pipeline_info.pDepthStencilState;
+        part_info.pMultisampleState = pipeline_info.pMultisampleState;
+        part_info.layout = pipeline_layout_;
+        return create_part(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader, part_info);
+    };
+    libraries_.push_back(cache.GetOrCreate(prefix + keys.fragment_shader, desc_.layout,
+                                           GetGraphicsPipelineLibraryShaders(desc_, /*fragment=*/true),
+                                           create_fragment_shader));
+
+    libraries_.push_back(cache.GetOrCreate(prefix + keys.fragment_output, nullptr, {}, [&] {
+        vk::GraphicsPipelineCreateInfo part_info = {};
+        part_info.pColorBlendState = pipeline_info.pColorBlendState;
+        part_info.pMultisampleState = pipeline_info.pMultisampleState;
+        return create_part(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface, part_info);
+    }));
+
+    std::vector<vk::Pipeline> libraries;
+    for (const auto& library : libraries_) {
+        libraries.push_back(library->pipeline.get());
+    }
+    vk::PipelineLibraryCreateInfoKHR library_info = {};
+    library_info.libraryCount = libraries.size();
+    library_info.pLibraries = libraries.data();
+
+    // Without fast linking a plain link is not guaranteed to be cheap, so link once with optimizations.
+    vk::GraphicsPipelineCreateInfo link_info = {};
+    link_info.flags = pipeline_info.flags;
+    if (!device_.HasGraphicsPipelineLibraryFastLinking()) {
+        link_info.flags |= vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
+    }
+    link_info.layout = pipeline_layout_;
+    link_info.pNext = ChainCreationFeedback(&library_info, /*stage_count=*/0);
+    pipeline_ = device_.GetDevice().createGraphicsPipelineUnique(device_.GetPipelineCache(), link_info).value;
+
+    if (device_.HasGraphicsPipelineLibraryFastLinking()) {
+        LinkOptimizedInBackground(pipeline_info.flags);
+    }
+}
+
+void VKGraphicsPipeline::LinkOptimizedInBackground(vk::PipelineCreateFlags flags)
+{
+    ThreadPool* thread_pool = device_.GetPipelineLinkThreadPool();
+    if (!thread_pool) {
+        return;
+    }
+
+    // The task owns everything it touches, including the layout and the parts, since the pipeline may be destroyed
+    // first and the parts trimmed from the cache.
+    optimized_pipeline_ = std::make_shared<OptimizedPipeline>();
+    thread_pool->Enqueue([&device = device_, optimized_pipeline = optimized_pipeline_, layout = desc_.layout,
+                          pipeline_layout = pipeline_layout_, parts = libraries_, flags] {
+        TRACE_SCOPE("VKGraphicsPipeline::LinkOptimized");
+        std::vector<vk::Pipeline> libraries;
+        for (const auto& part : parts) {
+            libraries.push_back(part->pipeline.get());
+        }
+        vk::PipelineCreationFeedback feedback = {};
+        vk::PipelineCreationFeedbackCreateInfo feedback_info = {};
+        feedback_info.pPipelineCreationFeedback = &feedback;
+
+        vk::PipelineLibraryCreateInfoKHR library_info = {};
+        library_info.libraryCount = libraries.size();
+        library_info.pLibraries = libraries.data();
+        if (device.IsPipelineCreationFeedbackSupported()) {
+            library_info.pNext = &feedback_info;
+        }
+
+        vk::GraphicsPipelineCreateInfo link_info = {};
+        link_info.pNext = &library_info;
+        link_info.flags = flags | vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
+        link_info.layout = pipeline_layout;
+        optimized_pipeline->pipeline =
+            device.GetDevice().createGraphicsPipelineUnique(device.GetPipelineCache(), link_info).value;
+        optimized_pipeline->ready.store(true, std::memory_order_release);
+        if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid) {
+            device.OnPipelineCreated(feedback);
+        }
+    });
 }
 
 PipelineType VKGraphicsPipeline::GetPipelineType() const
@@ -295,6 +496,14 @@ PipelineType VKGraphicsPipeline::GetPipelineType() const
     return PipelineType::kGraphics;
 }
 
+vk::Pipeline VKGraphicsPipeline::GetPipeline() const
+{
+    if (optimized_pipeline_ && optimized_pipeline_->ready.load(std::memory_order_acquire)) {
+        return optimized_pipeline_->pipeline.get();
+    }
+    return VKPipeline::GetPipeline();
+}
+
 void VKGraphicsPipeline::CreateInputLayout(const std::shared_ptr<Shader>& shader)
 {
     std::map<size_t, uint32_t> input_layout_stride;
@@ -1,22 +1,44 @@
 #pragma once
 #include "Instance/BaseTypes.h"
+#include "Pipeline/VKGraphicsPipelineLibrary.h"
 #include "Pipeline/VKPipeline.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <memory>
+
 class VKDevice;
 
+vk::PrimitiveTopology ConvertPrimitiveTopology(PrimitiveTopology topology);
+vk::CullModeFlags ConvertCullMode(CullMode cull_mode);
+vk::FrontFace ConvertFrontFace(FrontFace front_face);
+vk::StencilOpState ConvertStencilOpDesc(const StencilOpDesc& desc, uint8_t read_mask, uint8_t write_mask);
+vk::PipelineColorBlendAttachmentState ConvertBlendDesc(const BlendDesc& desc);
+
 class VKGraphicsPipeline : public VKPipeline {
 public:
     VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineDesc& desc);
     PipelineType GetPipelineType() const override;
+    vk::Pipeline GetPipeline() const override;
 
     const GraphicsPipelineDesc& GetDesc() const;
 
 private:
     void CreateInputLayout(const std::shared_ptr<Shader>& shader);
+    void CreateFromLibraries(const vk::GraphicsPipelineCreateInfo& pipeline_info,
+                             const std::vector<vk::DynamicState>& dynamic_states);
+    void LinkOptimizedInBackground(vk::PipelineCreateFlags flags);
+
+    struct OptimizedPipeline {
+        vk::UniquePipeline pipeline;
+        std::atomic<bool> ready = false;
+    };
 
     GraphicsPipelineDesc desc_;
     std::vector<vk::VertexInputBindingDescription> binding_desc_;
     std::vector<vk::VertexInputAttributeDescription> attribute_desc_;
+    // Parts are only destroyed by VKGraphicsPipelineLibraryCache::Trim() once no pipeline links from them.
+    std::vector<std::shared_ptr<VKGraphicsPipelineLibrary>> libraries_;
+    std::shared_ptr<OptimizedPipeline> optimized_pipeline_;
 };
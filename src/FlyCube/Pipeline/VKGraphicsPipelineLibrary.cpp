@@ -0,0 +1,39 @@
+#include "Pipeline/VKGraphicsPipelineLibrary.h"
+
+#include "Utilities/Trace.h"
+
+std::shared_ptr<VKGraphicsPipelineLibrary> VKGraphicsPipelineLibraryCache::GetOrCreate(
+    const std::string& key,
+    const std::shared_ptr<BindingSetLayout>& layout,
+    const std::vector<std::shared_ptr<Shader>>& shaders,
+    const std::function<vk::UniquePipeline()>& create)
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto it = libraries_.find(key);
+        if (it != libraries_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+    }
+
+    // Compile outside of the lock, a concurrent request for the same part keeps the first result.
+    TRACE_SCOPE("VKGraphicsPipelineLibraryCache::Create");
+    auto library = std::make_shared<VKGraphicsPipelineLibrary>(VKGraphicsPipelineLibrary{ create(), layout, shaders });
+    std::lock_guard lock(mutex_);
+    return libraries_.try_emplace(key, std::move(library)).first->second;
+}
+
+size_t VKGraphicsPipelineLibraryCache::Trim()
+{
+    std::lock_guard lock(mutex_);
+    // Pipelines and their background links hold a reference to every part they were linked from.
+    return std::erase_if(libraries_, [](const auto& entry) { return entry.second.use_count() == 1; });
+}
+
+GraphicsPipelineLibraryStats VKGraphicsPipelineLibraryCache::GetStats() const
+{
+    std::lock_guard lock(mutex_);
+    return { hits_, misses_, libraries_.size() };
+}
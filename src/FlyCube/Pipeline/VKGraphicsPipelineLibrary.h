@@ -0,0 +1,45 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BindingSetLayout;
+class Shader;
+
+struct GraphicsPipelineLibraryStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t libraries;
+};
+
+struct VKGraphicsPipelineLibrary {
+    vk::UniquePipeline pipeline;
+    // Keys refer to the layout and shaders by identity, so they can not be replaced by unrelated objects.
+    std::shared_ptr<BindingSetLayout> layout;
+    std::vector<std::shared_ptr<Shader>> shaders;
+};
+
+// Keeps VK_EXT_graphics_pipeline_library parts alive until Trim() so that pipelines sharing a vertex input,
+// pre-rasterization, fragment shader or fragment output state only pay for linking. Keys are the serialized part
+// state, see GetGraphicsPipelineLibraryKeys.
+class VKGraphicsPipelineLibraryCache {
+public:
+    std::shared_ptr<VKGraphicsPipelineLibrary> GetOrCreate(const std::string& key,
+                                                           const std::shared_ptr<BindingSetLayout>& layout,
+                                                           const std::vector<std::shared_ptr<Shader>>& shaders,
+                                                           const std::function<vk::UniquePipeline()>& create);
+    // Destroys the parts no pipeline uses anymore, returns how many were destroyed.
+    size_t Trim();
+    GraphicsPipelineLibraryStats GetStats() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<VKGraphicsPipelineLibrary>> libraries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
@@ -2,9 +2,13 @@
 
 #include "BindingSetLayout/VKBindingSetLayout.h"
 #include "Device/VKDevice.h"
+#include "Shader/VKShader.h"
 #include "Utilities/Cast.h"
+#include "Utilities/Check.h"
 #include "Utilities/NotReached.h"
 
+#include <algorithm>
+
 namespace {
 
 vk::ShaderStageFlagBits ExecutionModel2Bit(ShaderKind kind)
@@ -43,18 +47,35 @@ vk::ShaderStageFlagBits ExecutionModel2Bit(ShaderKind kind)
 
 VKPipeline::VKPipeline(VKDevice& device,
                        const std::vector<std::shared_ptr<Shader>>& shaders,
-                       const std::shared_ptr<BindingSetLayout>& layout)
+                       const std::shared_ptr<BindingSetLayout>& layout,
+                       const std::vector<SpecializationConstant>& specialization_constants)
     : device_(device)
 {
     auto* vk_layout = CastToImpl<VKBindingSetLayout>(layout);
     pipeline_layout_ = vk_layout->GetPipelineLayout();
 
+    for (const auto& specialization_constant : specialization_constants) {
+        bool duplicate = std::any_of(specialization_map_entries_.begin(), specialization_map_entries_.end(),
+                                     [&](const auto& entry) { return entry.constantID == specialization_constant.id; });
+        CHECK(!duplicate, "Specialization constant {} is set more than once", specialization_constant.id);
+        auto& map_entry = specialization_map_entries_.emplace_back();
+        map_entry.constantID = specialization_constant.id;
+        map_entry.offset = specialization_data_.size() * sizeof(uint32_t);
+        map_entry.size = sizeof(uint32_t);
+        specialization_data_.push_back(specialization_constant.value);
+    }
+    specialization_info_.mapEntryCount = specialization_map_entries_.size();
+    specialization_info_.pMapEntries = specialization_map_entries_.data();
+    specialization_info_.dataSize = specialization_data_.size() * sizeof(uint32_t);
+    specialization_info_.pData = specialization_data_.data();
+
     for (const auto& shader : shaders) {
-        decltype(auto) blob = shader->GetBlob();
-        vk::ShaderModuleCreateInfo shader_module_info = {};
-        shader_module_info.codeSize = blob.size();
-        shader_module_info.pCode = (uint32_t*)blob.data();
-        shader_modules_.emplace_back(device_.GetDevice().createShaderModuleUnique(shader_module_info));
+        vk::ShaderModule shader_module;
+        if (device_.IsShaderModuleSharingEnabled()) {
+            shader_module = CastToImpl<VKShader>(shader)->GetShaderModule();
+        } else {
+            shader_module = shader_modules_.emplace_back(device_.CreateShaderModule(shader->GetBlob())).get();
+        }
 
         decltype(auto) reflection = shader->GetReflection();
         decltype(auto) entry_points = reflection->GetEntryPoints();
@@ -62,9 +83,12 @@ VKPipeline::VKPipeline(VKDevice& device,
             shader_ids_[shader->GetId(entry_point.name)] = shader_stage_create_info_.size();
             decltype(auto) shader_stage_create_info = shader_stage_create_info_.emplace_back();
             shader_stage_create_info.stage = ExecutionModel2Bit(entry_point.kind);
-            shader_stage_create_info.module = shader_modules_.back().get();
+            shader_stage_create_info.module = shader_module;
             decltype(auto) name = entry_point_names.emplace_back(entry_point.name);
             shader_stage_create_info.pName = name.c_str();
+            if (!specialization_map_entries_.empty()) {
+                shader_stage_create_info.pSpecializationInfo = &specialization_info_;
+            }
         }
     }
 }
@@ -83,3 +107,34 @@ std::vector<uint8_t> VKPipeline::GetRayTracingShaderGroupHandles(uint32_t first_
 {
     return {};
 }
+
+const vk::PipelineCreationFeedback& VKPipeline::GetCreationFeedback() const
+{
+    return creation_feedback_;
+}
+
+const void* VKPipeline::ChainCreationFeedback(const void* next)
+{
+    return ChainCreationFeedback(next, shader_stage_create_info_.size());
+}
+
+const void* VKPipeline::ChainCreationFeedback(const void* next, uint32_t stage_count)
+{
+    if (!device_.IsPipelineCreationFeedbackSupported()) {
+        return next;
+    }
+
+    stage_creation_feedbacks_.resize(stage_count);
+    creation_feedback_info_.pNext = next;
+    creation_feedback_info_.pPipelineCreationFeedback = &creation_feedback_;
+    creation_feedback_info_.pipelineStageCreationFeedbackCount = stage_creation_feedbacks_.size();
+    creation_feedback_info_.pPipelineStageCreationFeedbacks = stage_creation_feedbacks_.data();
+    return &creation_feedback_info_;
+}
+
+void VKPipeline::ReportCreationFeedback()
+{
+    if (creation_feedback_.flags & vk::PipelineCreationFeedbackFlagBits::eValid) {
+        device_.OnPipelineCreated(creation_feedback_);
+    }
+}
@@ -11,17 +11,30 @@ class VKPipeline : public Pipeline {
 public:
     VKPipeline(VKDevice& device,
                const std::vector<std::shared_ptr<Shader>>& shaders,
-               const std::shared_ptr<BindingSetLayout>& layout);
+               const std::shared_ptr<BindingSetLayout>& layout,
+               const std::vector<SpecializationConstant>& specialization_constants);
     vk::PipelineLayout GetPipelineLayout() const;
-    vk::Pipeline GetPipeline() const;
+    virtual vk::Pipeline GetPipeline() const;
     std::vector<uint8_t> GetRayTracingShaderGroupHandles(uint32_t first_group, uint32_t group_count) const override;
+    const vk::PipelineCreationFeedback& GetCreationFeedback() const;
 
 protected:
+    const void* ChainCreationFeedback(const void* next);
+    const void* ChainCreationFeedback(const void* next, uint32_t stage_count);
+    void ReportCreationFeedback();
+
     VKDevice& device_;
     std::deque<std::string> entry_point_names;
     std::vector<vk::PipelineShaderStageCreateInfo> shader_stage_create_info_;
+    std::vector<vk::SpecializationMapEntry> specialization_map_entries_;
+    std::vector<uint32_t> specialization_data_;
+    vk::SpecializationInfo specialization_info_ = {};
+    // Only used when shader module sharing is disabled, see VKShader::GetShaderModule().
     std::vector<vk::UniqueShaderModule> shader_modules_;
     vk::UniquePipeline pipeline_;
     vk::PipelineLayout pipeline_layout_;
     std::map<uint64_t, uint32_t> shader_ids_;
+    vk::PipelineCreationFeedback creation_feedback_ = {};
+    std::vector<vk::PipelineCreationFeedback> stage_creation_feedbacks_;
+    vk::PipelineCreationFeedbackCreateInfo creation_feedback_info_ = {};
 };
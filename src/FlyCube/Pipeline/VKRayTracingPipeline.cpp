@@ -9,7 +9,7 @@
 #include <map>
 
 VKRayTracingPipeline::VKRayTracingPipeline(VKDevice& device, const RayTracingPipelineDesc& desc)
-    : VKPipeline(device, desc.shaders, desc.layout)
+    : VKPipeline(device, desc.shaders, desc.layout, desc.specialization_constants)
     , desc_(desc)
 {
     std::vector<vk::RayTracingShaderGroupCreateInfoKHR> groups(desc_.groups.size());
@@ -53,8 +53,12 @@ VKRayTracingPipeline::VKRayTracingPipeline(VKDevice& device, const RayTracingPip
     ray_pipeline_info.pGroups = groups.data();
     ray_pipeline_info.maxPipelineRayRecursionDepth = 1;
     ray_pipeline_info.layout = pipeline_layout_;
+    ray_pipeline_info.pNext = ChainCreationFeedback(ray_pipeline_info.pNext);
 
-    pipeline_ = device_.GetDevice().createRayTracingPipelineKHRUnique({}, {}, ray_pipeline_info).value;
+    pipeline_ = device_.GetDevice()
+                    .createRayTracingPipelineKHRUnique({}, device_.GetPipelineCache(), ray_pipeline_info)
+                    .value;
+    ReportCreationFeedback();
 }
 
 PipelineType VKRayTracingPipeline::GetPipelineType() const
@@ -0,0 +1,145 @@
+#include "Pipeline/PipelineDescCache.h"
+
+#include <catch2/catch_all.hpp>
+
+namespace {
+
+class TestPipeline : public Pipeline {
+public:
+    PipelineType GetPipelineType() const override
+    {
+        return PipelineType::kGraphics;
+    }
+
+    std::vector<uint8_t> GetRayTracingShaderGroupHandles(uint32_t first_group, uint32_t group_count) const override
+    {
+        return {};
+    }
+};
+
+std::shared_ptr<Pipeline> CreateTestPipeline()
+{
+    return std::make_shared<TestPipeline>();
+}
+
+} // namespace
+
+TEST_CASE("PipelineDescCache returns the same pipeline for an identical desc")
+{
+    PipelineDescCache cache;
+    GraphicsPipelineDesc desc = {};
+    desc.color_formats = { gli::format::FORMAT_RGBA8_UNORM_PACK8 };
+    auto first = cache.GetOrCreate(desc, CreateTestPipeline);
+    auto second = cache.GetOrCreate(desc, CreateTestPipeline);
+    CHECK(first == second);
+
+    desc.rasterizer_desc.cull_mode = CullMode::kBack;
+    auto third = cache.GetOrCreate(desc, CreateTestPipeline);
+    CHECK(third != first);
+
+    auto stats = cache.GetStats();
+    CHECK(stats.hits == 1);
+    CHECK(stats.misses == 2);
+    CHECK(stats.live_pipelines == 2);
+}
+
+TEST_CASE("PipelineDescCache ignores dynamic state")
+{
+    PipelineDescCache cache;
+    GraphicsPipelineDesc desc = {};
+    desc.dynamic_states = DynamicStateFlags::kCullMode | DynamicStateFlags::kPrimitiveTopology |
+                          DynamicStateFlags::kDepthStencil | DynamicStateFlags::kBlend;
+    auto first = cache.GetOrCreate(desc, CreateTestPipeline);
+
+    desc.rasterizer_desc.cull_mode = CullMode::kFront;
+    desc.topology = PrimitiveTopology::kTriangleStrip;
+    desc.depth_stencil_desc.depth_func = ComparisonFunc::kGreater;
+    desc.blend_desc.blend_enable = true;
+    CHECK(cache.GetOrCreate(desc, CreateTestPipeline) == first);
+
+    // The topology class and states that are not dynamic are still baked into the pipeline.
+    desc.topology = PrimitiveTopology::kLineList;
+    CHECK(cache.GetOrCreate(desc, CreateTestPipeline) != first);
+    desc.topology = PrimitiveTopology::kTriangleList;
+    desc.rasterizer_desc.front_face = FrontFace::kCounterClockwise;
+    CHECK(cache.GetOrCreate(desc, CreateTestPipeline) != first);
+}
+
+TEST_CASE("PipelineDescCache does not keep unused pipelines alive")
+{
+    PipelineDescCache cache;
+    ComputePipelineDesc desc = {};
+    std::weak_ptr<Pipeline> weak = cache.GetOrCreate(desc, CreateTestPipeline);
+    CHECK(weak.expired());
+    CHECK(cache.GetStats().live_pipelines == 0);
+
+    auto pipeline = cache.GetOrCreate(desc, CreateTestPipeline);
+    CHECK(cache.GetOrCreate(desc, CreateTestPipeline) == pipeline);
+    CHECK(cache.GetStats().hits == 1);
+}
+
+TEST_CASE("PipelineDescCache keys compute pipelines by subgroup size controls")
+{
+    PipelineDescCache cache;
+    ComputePipelineDesc desc = {};
+    auto base = cache.GetOrCreate(desc, CreateTestPipeline);
+
+    ComputePipelineDesc required_desc = desc;
+    required_desc.required_subgroup_size = 32;
+    auto required = cache.GetOrCreate(required_desc, CreateTestPipeline);
+    CHECK(required != base);
+    CHECK(cache.GetOrCreate(required_desc, CreateTestPipeline) == required);
+
+    required_desc.required_subgroup_size = 64;
+    CHECK(cache.GetOrCreate(required_desc, CreateTestPipeline) != required);
+
+    ComputePipelineDesc varying_desc = desc;
+    varying_desc.allow_varying_subgroup_size = true;
+    auto varying = cache.GetOrCreate(varying_desc, CreateTestPipeline);
+    CHECK(varying != base);
+
+    ComputePipelineDesc full_desc = varying_desc;
+    full_desc.require_full_subgroups = true;
+    auto full = cache.GetOrCreate(full_desc, CreateTestPipeline);
+    CHECK(full != varying);
+    CHECK(full != base);
+}
+
+TEST_CASE("GraphicsPipelineLibraryKeys leave out dynamic state")
+{
+    GraphicsPipelineDesc desc = {};
+    desc.color_formats = { gli::format::FORMAT_RGBA8_UNORM_PACK8 };
+    desc.dynamic_states = DynamicStateFlags::kCullMode | DynamicStateFlags::kBlend;
+    auto keys = GetGraphicsPipelineLibraryKeys(desc);
+    // Without a vertex shader there is no vertex input part.
+    CHECK(keys.vertex_input.empty());
+
+    GraphicsPipelineDesc dynamic_desc = desc;
+    dynamic_desc.rasterizer_desc.cull_mode = CullMode::kFront;
+    dynamic_desc.blend_desc.blend_enable = true;
+    auto dynamic_keys = GetGraphicsPipelineLibraryKeys(dynamic_desc);
+    CHECK(dynamic_keys.pre_rasterization_shaders == keys.pre_rasterization_shaders);
+    CHECK(dynamic_keys.fragment_output == keys.fragment_output);
+
+    dynamic_desc.dynamic_states = {};
+    auto static_keys = GetGraphicsPipelineLibraryKeys(dynamic_desc);
+    CHECK(static_keys.pre_rasterization_shaders != keys.pre_rasterization_shaders);
+    CHECK(static_keys.fragment_output != keys.fragment_output);
+    CHECK(static_keys.fragment_shader == keys.fragment_shader);
+}
+
+TEST_CASE("GraphicsPipelineLibraryKeys include specialization constants in the shader parts")
+{
+    GraphicsPipelineDesc desc = {};
+    desc.specialization_constants = { { 0, 1 } };
+    auto keys = GetGraphicsPipelineLibraryKeys(desc);
+
+    desc.specialization_constants = { { 0, 2 } };
+    auto other_keys = GetGraphicsPipelineLibraryKeys(desc);
+    CHECK(other_keys.pre_rasterization_shaders != keys.pre_rasterization_shaders);
+    CHECK(other_keys.fragment_shader != keys.fragment_shader);
+    CHECK(other_keys.fragment_output == keys.fragment_output);
+
+    // Every part is keyed separately, so equal state of different parts must not collide.
+    CHECK(keys.pre_rasterization_shaders != keys.fragment_shader);
+}
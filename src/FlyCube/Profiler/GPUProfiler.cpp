@@ -0,0 +1,141 @@
+#include "Profiler/GPUProfiler.h"
+
+#include "Utilities/Check.h"
+
+GPUProfiler::GPUProfiler(const std::shared_ptr<Device>& device,
+                         uint32_t frame_count,
+                         uint32_t max_queries_per_frame)
+    : device_(device)
+    , max_queries_per_frame_(max_queries_per_frame)
+    , frames_(frame_count)
+{
+    timestamp_period_ = device_->GetTimestampPeriod();
+    if (timestamp_period_ == 0) {
+        return;
+    }
+    uint32_t query_count = frame_count * max_queries_per_frame_;
+    query_heap_ = device_->CreateQueryHeap(QueryHeapType::kTimestamp, query_count);
+    if (!query_heap_) {
+        return;
+    }
+    readback_buffer_ = device_->CreateBuffer(
+        MemoryType::kReadback, { .size = query_count * sizeof(uint64_t), .usage = BindFlag::kCopyDest });
+    readback_buffer_->SetName("GPUProfiler readback");
+}
+
+void GPUProfiler::BeginFrame(uint32_t frame_index)
+{
+    std::lock_guard lock(mutex_);
+    CHECK(frame_index < frames_.size());
+    frame_index_ = frame_index;
+    auto& frame = frames_[frame_index_];
+    if (frame.resolved) {
+        ReadbackFrame(frame_index_);
+    } else if (frame.query_count != 0) {
+        // EndFrame was skipped, so the queries written last time were never resolved and reset.
+        query_heap_->Reset(frame_index_ * max_queries_per_frame_, frame.query_count);
+    }
+    frame = {};
+    event_stacks_.clear();
+}
+
+void GPUProfiler::EndFrame(const std::shared_ptr<CommandList>& command_list)
+{
+    std::lock_guard lock(mutex_);
+    auto& frame = frames_[frame_index_];
+    if (!query_heap_ || frame.query_count == 0) {
+        return;
+    }
+    uint32_t first_query = frame_index_ * max_queries_per_frame_;
+    command_list->ResolveQueryData(query_heap_, first_query, frame.query_count, readback_buffer_,
+                                   first_query * sizeof(uint64_t));
+    frame.resolved = true;
+}
+
+void GPUProfiler::OnBeginEvent(CommandList& command_list, const std::string& name)
+{
+    std::lock_guard lock(mutex_);
+    auto& frame = frames_[frame_index_];
+    auto query = AllocateQuery(frame);
+    if (!query) {
+        return;
+    }
+    command_list.WriteTimestamp(query_heap_, query.value());
+
+    auto& stack = event_stacks_[&command_list];
+    Event& event = frame.events.emplace_back();
+    event.name = name;
+    event.begin_query = query.value();
+    if (!stack.empty()) {
+        event.parent = stack.back();
+    }
+    stack.push_back(frame.events.size() - 1);
+}
+
+void GPUProfiler::OnEndEvent(CommandList& command_list)
+{
+    std::lock_guard lock(mutex_);
+    auto& stack = event_stacks_[&command_list];
+    if (stack.empty()) {
+        return;
+    }
+    auto& frame = frames_[frame_index_];
+    Event& event = frame.events[stack.back()];
+    stack.pop_back();
+    auto query = AllocateQuery(frame);
+    if (!query) {
+        return;
+    }
+    command_list.WriteTimestamp(query_heap_, query.value());
+    event.end_query = query;
+}
+
+const std::vector<GPUProfileNode>& GPUProfiler::GetFrameTree() const
+{
+    return frame_tree_;
+}
+
+std::optional<uint32_t> GPUProfiler::AllocateQuery(Frame& frame)
+{
+    if (!query_heap_ || frame.query_count == max_queries_per_frame_) {
+        return {};
+    }
+    return frame_index_ * max_queries_per_frame_ + frame.query_count++;
+}
+
+void GPUProfiler::ReadbackFrame(uint32_t frame_index)
+{
+    const auto& events = frames_[frame_index].events;
+    const uint64_t* timestamps = reinterpret_cast<const uint64_t*>(readback_buffer_->Map());
+
+    std::vector<GPUProfileNode> nodes(events.size());
+    std::vector<std::vector<size_t>> children(events.size());
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        nodes[i].name = event.name;
+        if (event.end_query) {
+            uint64_t begin = timestamps[event.begin_query];
+            uint64_t end = timestamps[event.end_query.value()];
+            if (end > begin) {
+                nodes[i].time_ms = (end - begin) * timestamp_period_ / 1e6;
+            }
+        }
+        if (event.parent) {
+            children[event.parent.value()].push_back(i);
+        } else {
+            roots.push_back(i);
+        }
+    }
+    readback_buffer_->Unmap();
+
+    for (size_t i = events.size(); i-- > 0;) {
+        for (size_t child : children[i]) {
+            nodes[i].children.push_back(std::move(nodes[child]));
+        }
+    }
+    frame_tree_.clear();
+    for (size_t root : roots) {
+        frame_tree_.push_back(std::move(nodes[root]));
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "CommandList/CommandList.h"
+#include "Device/Device.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct GPUProfileNode {
+    std::string name;
+    double time_ms = 0;
+    std::vector<GPUProfileNode> children;
+};
+
+class GPUProfiler {
+public:
+    GPUProfiler(const std::shared_ptr<Device>& device, uint32_t frame_count, uint32_t max_queries_per_frame = 1024);
+
+    void BeginFrame(uint32_t frame_index);
+    void EndFrame(const std::shared_ptr<CommandList>& command_list);
+    void OnBeginEvent(CommandList& command_list, const std::string& name);
+    void OnEndEvent(CommandList& command_list);
+    const std::vector<GPUProfileNode>& GetFrameTree() const;
+
+private:
+    struct Event {
+        std::string name;
+        uint32_t begin_query = 0;
+        std::optional<uint32_t> end_query;
+        std::optional<size_t> parent;
+    };
+
+    struct Frame {
+        std::vector<Event> events;
+        uint32_t query_count = 0;
+        bool resolved = false;
+    };
+
+    std::optional<uint32_t> AllocateQuery(Frame& frame);
+    void ReadbackFrame(uint32_t frame_index);
+
+    std::shared_ptr<Device> device_;
+    std::shared_ptr<QueryHeap> query_heap_;
+    std::shared_ptr<Resource> readback_buffer_;
+    double timestamp_period_ = 0;
+    uint32_t max_queries_per_frame_;
+    std::vector<Frame> frames_;
+    uint32_t frame_index_ = 0;
+    std::map<CommandList*, std::vector<size_t>> event_stacks_;
+    std::vector<GPUProfileNode> frame_tree_;
+    std::mutex mutex_;
+};
@@ -0,0 +1,71 @@
+#include "QueryHeap/DXQueryHeap.h"
+
+#include "Device/DXDevice.h"
+#include "Utilities/DXUtility.h"
+#include "Utilities/NotReached.h"
+
+namespace {
+
+D3D12_QUERY_HEAP_TYPE ConvertQueryHeapType(QueryHeapType type)
+{
+    switch (type) {
+    case QueryHeapType::kTimestamp:
+        return D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    case QueryHeapType::kPipelineStatistics:
+        return D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS;
+    case QueryHeapType::kOcclusion:
+    case QueryHeapType::kBinaryOcclusion:
+        return D3D12_QUERY_HEAP_TYPE_OCCLUSION;
+    default:
+        NOTREACHED();
+    }
+}
+
+D3D12_QUERY_TYPE ConvertToQueryType(QueryHeapType type)
+{
+    switch (type) {
+    case QueryHeapType::kTimestamp:
+        return D3D12_QUERY_TYPE_TIMESTAMP;
+    case QueryHeapType::kPipelineStatistics:
+        return D3D12_QUERY_TYPE_PIPELINE_STATISTICS;
+    case QueryHeapType::kOcclusion:
+        return D3D12_QUERY_TYPE_OCCLUSION;
+    case QueryHeapType::kBinaryOcclusion:
+        return D3D12_QUERY_TYPE_BINARY_OCCLUSION;
+    default:
+        NOTREACHED();
+    }
+}
+
+} // namespace
+
+DXQueryHeap::DXQueryHeap(DXDevice& device, QueryHeapType type, uint32_t count)
+    : device_(device)
+    , type_(type)
+    , query_type_(ConvertToQueryType(type))
+{
+    D3D12_QUERY_HEAP_DESC desc = {};
+    desc.Type = ConvertQueryHeapType(type_);
+    desc.Count = count;
+    CHECK_HRESULT(device_.GetDevice()->CreateQueryHeap(&desc, IID_PPV_ARGS(&query_heap_)));
+}
+
+QueryHeapType DXQueryHeap::GetType() const
+{
+    return type_;
+}
+
+void DXQueryHeap::Reset(uint32_t first_query, uint32_t query_count)
+{
+    // D3D12 queries can be written again without a reset.
+}
+
+D3D12_QUERY_TYPE DXQueryHeap::GetQueryType() const
+{
+    return query_type_;
+}
+
+ComPtr<ID3D12QueryHeap> DXQueryHeap::GetQueryHeap() const
+{
+    return query_heap_;
+}
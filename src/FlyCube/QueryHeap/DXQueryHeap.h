@@ -0,0 +1,31 @@
+#pragma once
+#include "QueryHeap/QueryHeap.h"
+
+#if defined(_WIN32)
+#include <wrl.h>
+#else
+#include <wsl/wrladapter.h>
+#endif
+
+#include <directx/d3d12.h>
+
+using Microsoft::WRL::ComPtr;
+
+class DXDevice;
+
+class DXQueryHeap : public QueryHeap {
+public:
+    DXQueryHeap(DXDevice& device, QueryHeapType type, uint32_t count);
+
+    QueryHeapType GetType() const override;
+    void Reset(uint32_t first_query, uint32_t query_count) override;
+
+    D3D12_QUERY_TYPE GetQueryType() const;
+    ComPtr<ID3D12QueryHeap> GetQueryHeap() const;
+
+private:
+    DXDevice& device_;
+    QueryHeapType type_;
+    D3D12_QUERY_TYPE query_type_;
+    ComPtr<ID3D12QueryHeap> query_heap_;
+};
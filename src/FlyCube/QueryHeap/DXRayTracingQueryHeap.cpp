@@ -21,6 +21,11 @@ QueryHeapType DXRayTracingQueryHeap::GetType() const
     return QueryHeapType::kAccelerationStructureCompactedSize;
 }
 
+void DXRayTracingQueryHeap::Reset(uint32_t first_query, uint32_t query_count)
+{
+    // Postbuild info is overwritten by every emit, nothing to reset.
+}
+
 ID3D12Resource* DXRayTracingQueryHeap::GetResource() const
 {
     return resource_.Get();
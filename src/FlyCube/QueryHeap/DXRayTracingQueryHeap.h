@@ -18,6 +18,7 @@ public:
     DXRayTracingQueryHeap(DXDevice& device, QueryHeapType type, uint32_t count);
 
     QueryHeapType GetType() const override;
+    void Reset(uint32_t first_query, uint32_t query_count) override;
 
     ID3D12Resource* GetResource() const;
 
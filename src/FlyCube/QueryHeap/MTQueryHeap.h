@@ -10,6 +10,7 @@ public:
     MTQueryHeap(MTDevice& device, QueryHeapType type, uint32_t count);
 
     QueryHeapType GetType() const override;
+    void Reset(uint32_t first_query, uint32_t query_count) override;
 
     id<MTLBuffer> GetBuffer() const;
 
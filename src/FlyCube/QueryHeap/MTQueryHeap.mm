@@ -12,6 +12,11 @@ QueryHeapType MTQueryHeap::GetType() const
     return QueryHeapType::kAccelerationStructureCompactedSize;
 }
 
+void MTQueryHeap::Reset(uint32_t first_query, uint32_t query_count)
+{
+    // Results are plain buffer writes, nothing to reset.
+}
+
 id<MTLBuffer> MTQueryHeap::GetBuffer() const
 {
     return buffer_;
@@ -0,0 +1,29 @@
+#include "QueryHeap/QueryData.h"
+
+#include "Utilities/NotReached.h"
+
+#include <cstring>
+
+static_assert(sizeof(PipelineStatistics) == 11 * sizeof(uint64_t));
+
+uint64_t GetQueryDataStride(QueryHeapType type)
+{
+    switch (type) {
+    case QueryHeapType::kAccelerationStructureCompactedSize:
+    case QueryHeapType::kTimestamp:
+    case QueryHeapType::kOcclusion:
+    case QueryHeapType::kBinaryOcclusion:
+        return sizeof(uint64_t);
+    case QueryHeapType::kPipelineStatistics:
+        return sizeof(PipelineStatistics);
+    default:
+        NOTREACHED();
+    }
+}
+
+std::vector<PipelineStatistics> DecodePipelineStatistics(const void* data, uint32_t query_count)
+{
+    std::vector<PipelineStatistics> statistics(query_count);
+    memcpy(statistics.data(), data, query_count * sizeof(PipelineStatistics));
+    return statistics;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+struct PipelineStatistics {
+    uint64_t input_assembly_vertices = 0;
+    uint64_t input_assembly_primitives = 0;
+    uint64_t vertex_shader_invocations = 0;
+    uint64_t geometry_shader_invocations = 0;
+    uint64_t geometry_shader_primitives = 0;
+    uint64_t clipping_invocations = 0;
+    uint64_t clipping_primitives = 0;
+    uint64_t fragment_shader_invocations = 0;
+    uint64_t tessellation_control_shader_patches = 0;
+    uint64_t tessellation_evaluation_shader_invocations = 0;
+    uint64_t compute_shader_invocations = 0;
+};
+
+uint64_t GetQueryDataStride(QueryHeapType type);
+std::vector<PipelineStatistics> DecodePipelineStatistics(const void* data, uint32_t query_count);
@@ -5,4 +5,6 @@ class QueryHeap {
 public:
     virtual ~QueryHeap() = default;
     virtual QueryHeapType GetType() const = 0;
+    // Makes queries that were written but never resolved available again. Must not be pending on the GPU.
+    virtual void Reset(uint32_t first_query, uint32_t query_count) = 0;
 };
@@ -1,20 +1,64 @@
 #include "QueryHeap/VKQueryHeap.h"
 
 #include "Device/VKDevice.h"
+#include "Utilities/NotReached.h"
+
+namespace {
+
+vk::QueryType ConvertQueryHeapType(QueryHeapType type)
+{
+    switch (type) {
+    case QueryHeapType::kAccelerationStructureCompactedSize:
+        return vk::QueryType::eAccelerationStructureCompactedSizeKHR;
+    case QueryHeapType::kTimestamp:
+        return vk::QueryType::eTimestamp;
+    case QueryHeapType::kPipelineStatistics:
+        return vk::QueryType::ePipelineStatistics;
+    case QueryHeapType::kOcclusion:
+    case QueryHeapType::kBinaryOcclusion:
+        return vk::QueryType::eOcclusion;
+    default:
+        NOTREACHED();
+    }
+}
+
+} // namespace
 
 VKQueryHeap::VKQueryHeap(VKDevice& device, QueryHeapType type, uint32_t count)
     : device_(device)
+    , type_(type)
 {
-    query_type_ = vk::QueryType::eAccelerationStructureCompactedSizeKHR;
+    query_type_ = ConvertQueryHeapType(type_);
     vk::QueryPoolCreateInfo desc = {};
     desc.queryCount = count;
     desc.queryType = query_type_;
+    if (query_type_ == vk::QueryType::ePipelineStatistics) {
+        desc.pipelineStatistics = vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+                                  vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+                                  vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+                                  vk::QueryPipelineStatisticFlagBits::eGeometryShaderInvocations |
+                                  vk::QueryPipelineStatisticFlagBits::eGeometryShaderPrimitives |
+                                  vk::QueryPipelineStatisticFlagBits::eClippingInvocations |
+                                  vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+                                  vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+                                  vk::QueryPipelineStatisticFlagBits::eTessellationControlShaderPatches |
+                                  vk::QueryPipelineStatisticFlagBits::eTessellationEvaluationShaderInvocations |
+                                  vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+    }
     query_pool_ = device_.GetDevice().createQueryPoolUnique(desc);
+    if (query_type_ != vk::QueryType::eAccelerationStructureCompactedSizeKHR) {
+        device_.GetDevice().resetQueryPool(query_pool_.get(), 0, count);
+    }
 }
 
 QueryHeapType VKQueryHeap::GetType() const
 {
-    return QueryHeapType::kAccelerationStructureCompactedSize;
+    return type_;
+}
+
+void VKQueryHeap::Reset(uint32_t first_query, uint32_t query_count)
+{
+    device_.GetDevice().resetQueryPool(query_pool_.get(), first_query, query_count);
 }
 
 vk::QueryType VKQueryHeap::GetQueryType() const
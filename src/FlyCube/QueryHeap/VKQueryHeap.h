@@ -10,12 +10,14 @@ public:
     VKQueryHeap(VKDevice& device, QueryHeapType type, uint32_t count);
 
     QueryHeapType GetType() const override;
+    void Reset(uint32_t first_query, uint32_t query_count) override;
 
     vk::QueryType GetQueryType() const;
     vk::QueryPool GetQueryPool() const;
 
 private:
     VKDevice& device_;
+    QueryHeapType type_;
     vk::UniqueQueryPool query_pool_;
     vk::QueryType query_type_;
 };
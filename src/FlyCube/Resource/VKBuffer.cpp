@@ -51,6 +51,9 @@ std::shared_ptr<VKBuffer> VKBuffer::CreateBuffer(VKDevice& device, const BufferD
     }
     if (desc.usage & BindFlag::kIndirectBuffer) {
         buffer_info.usage |= vk::BufferUsageFlagBits::eIndirectBuffer;
+        if (device.IsConditionalRenderingSupported()) {
+            buffer_info.usage |= vk::BufferUsageFlagBits::eConditionalRenderingEXT;
+        }
     }
 
     std::shared_ptr<VKBuffer> self = std::make_shared<VKBuffer>(PassKey<VKBuffer>(), device);
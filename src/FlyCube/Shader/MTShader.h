@@ -12,6 +12,7 @@ class MTDevice;
 class MTShader : public ShaderBase {
 public:
     MTShader(MTDevice& device, const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type);
+    MTShader(MTDevice& device, const ShaderBundleShader& shader);
 
 #if !defined(USE_METAL_SHADER_CONVERTER)
     uint32_t GetIndex(BindKey bind_key) const;
@@ -20,6 +21,8 @@ public:
     MTL4LibraryFunctionDescriptor* GetFunctionDescriptor();
 
 private:
+    void CreateFunctionDescriptor(MTDevice& device);
+
     MTL4LibraryFunctionDescriptor* function_descriptor_ = nullptr;
 #if !defined(USE_METAL_SHADER_CONVERTER)
     std::map<BindKey, uint32_t> slot_remapping_;
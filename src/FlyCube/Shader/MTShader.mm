@@ -11,10 +11,21 @@
 
 MTShader::MTShader(MTDevice& device, const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type)
     : ShaderBase(blob, blob_type, shader_type)
+{
+    CreateFunctionDescriptor(device);
+}
+
+MTShader::MTShader(MTDevice& device, const ShaderBundleShader& shader)
+    : ShaderBase(shader)
+{
+    CreateFunctionDescriptor(device);
+}
+
+void MTShader::CreateFunctionDescriptor(MTDevice& device)
 {
 #if defined(USE_METAL_SHADER_CONVERTER)
     std::string entry_point;
-    auto metal_lib_bytecode = ConvertToMetalLibBytecode(shader_type, blob, entry_point);
+    auto metal_lib_bytecode = ConvertToMetalLibBytecode(shader_type_, blob_, entry_point);
     dispatch_data_t metal_lib_data = dispatch_data_create(metal_lib_bytecode.data(), metal_lib_bytecode.size(), nullptr,
                                                           DISPATCH_DATA_DESTRUCTOR_DEFAULT);
     NSError* error = nullptr;
@@ -24,7 +35,7 @@ MTShader::MTShader(MTDevice& device, const std::vector<uint8_t>& blob, ShaderBlo
     }
 #else
     std::string entry_point;
-    std::string msl_source = GetMSLShader(shader_type, blob_, slot_remapping_, entry_point);
+    std::string msl_source = GetMSLShader(shader_type_, blob_, slot_remapping_, entry_point);
 
     MTL4LibraryDescriptor* library_descriptor = [MTL4LibraryDescriptor new];
     library_descriptor.source = [NSString stringWithUTF8String:msl_source.c_str()];
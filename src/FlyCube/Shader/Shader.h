@@ -1,16 +1,21 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 #include "ShaderReflection/ShaderReflection.h"
+#include "Utilities/InternedName.h"
 
 #include <memory>
+#include <span>
 
 class Shader {
 public:
     virtual ~Shader() = default;
     virtual ShaderType GetType() const = 0;
-    virtual const std::vector<uint8_t>& GetBlob() const = 0;
+    virtual std::span<const uint8_t> GetBlob() const = 0;
     virtual uint64_t GetId(const std::string& entry_point) const = 0;
     virtual const BindKey& GetBindKey(const std::string& name) const = 0;
     virtual uint32_t GetInputLayoutLocation(const std::string& semantic_name) const = 0;
+    // Skip the intern table lookup, callers that look up the same names repeatedly should intern them once.
+    virtual const BindKey& GetBindKey(InternedName name) const = 0;
+    virtual uint32_t GetInputLayoutLocation(InternedName semantic_name) const = 0;
     virtual const std::shared_ptr<ShaderReflection>& GetReflection() const = 0;
 };
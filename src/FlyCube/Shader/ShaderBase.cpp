@@ -11,11 +11,27 @@ uint64_t GenId()
 } // namespace
 
 ShaderBase::ShaderBase(const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type)
-    : blob_(blob)
+    : blob_storage_(blob)
+    , blob_(blob_storage_)
     , blob_type_(blob_type)
     , shader_type_(shader_type)
 {
     reflection_ = CreateShaderReflection(blob_type, blob_.data(), blob_.size());
+    ParseReflection();
+}
+
+ShaderBase::ShaderBase(const ShaderBundleShader& shader)
+    : blob_owner_(shader.owner)
+    , blob_(shader.blob)
+    , blob_type_(shader.blob_type)
+    , shader_type_(shader.type)
+    , reflection_(shader.reflection)
+{
+    ParseReflection();
+}
+
+void ShaderBase::ParseReflection()
+{
     for (const auto& binding : reflection_->GetBindings()) {
         BindKey bind_key = {
             .shader_type = shader_type_,
@@ -24,15 +40,18 @@ ShaderBase::ShaderBase(const std::vector<uint8_t>& blob, ShaderBlobType blob_typ
             .space = binding.space,
             .count = binding.count,
         };
-        bind_keys_[binding.name] = bind_key;
+        bind_keys_.Insert(InternedName(binding.name), bind_key);
     }
 
     for (const auto& input_parameter : reflection_->GetInputParameters()) {
-        locations_[input_parameter.semantic_name] = input_parameter.location;
+        locations_.Insert(InternedName(input_parameter.semantic_name), input_parameter.location);
     }
 
     for (const auto& entry_point : reflection_->GetEntryPoints()) {
-        ids_.emplace(entry_point.name, GenId());
+        InternedName name(entry_point.name);
+        if (!ids_.Find(name)) {
+            ids_.Insert(name, GenId());
+        }
     }
 }
 
@@ -41,24 +60,34 @@ ShaderType ShaderBase::GetType() const
     return shader_type_;
 }
 
-const std::vector<uint8_t>& ShaderBase::GetBlob() const
+std::span<const uint8_t> ShaderBase::GetBlob() const
 {
     return blob_;
 }
 
 uint64_t ShaderBase::GetId(const std::string& entry_point) const
 {
-    return ids_.at(entry_point);
+    return ids_.At(entry_point);
 }
 
 const BindKey& ShaderBase::GetBindKey(const std::string& name) const
 {
-    return bind_keys_.at(name);
+    return bind_keys_.At(name);
 }
 
 uint32_t ShaderBase::GetInputLayoutLocation(const std::string& semantic_name) const
 {
-    return locations_.at(semantic_name);
+    return locations_.At(semantic_name);
+}
+
+const BindKey& ShaderBase::GetBindKey(InternedName name) const
+{
+    return bind_keys_.At(name);
+}
+
+uint32_t ShaderBase::GetInputLayoutLocation(InternedName semantic_name) const
+{
+    return locations_.At(semantic_name);
 }
 
 const std::shared_ptr<ShaderReflection>& ShaderBase::GetReflection() const
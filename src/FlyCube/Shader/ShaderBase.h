@@ -1,27 +1,43 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 #include "Shader/Shader.h"
+#include "Shader/ShaderBundle.h"
 #include "ShaderReflection/ShaderReflection.h"
+#include "Utilities/FlatNameMap.h"
 
-#include <map>
 #include <vector>
 
 class ShaderBase : public Shader {
 public:
     ShaderBase(const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type);
+    // Uses the bundle memory and reflection as is, nothing is copied or reparsed.
+    explicit ShaderBase(const ShaderBundleShader& shader);
+    // blob_ may point into blob_storage_, a copy or move would leave it pointing at the source object.
+    ShaderBase(const ShaderBase&) = delete;
+    ShaderBase(ShaderBase&&) = delete;
+    ShaderBase& operator=(const ShaderBase&) = delete;
+    ShaderBase& operator=(ShaderBase&&) = delete;
+
     ShaderType GetType() const override;
-    const std::vector<uint8_t>& GetBlob() const override;
+    std::span<const uint8_t> GetBlob() const override;
     uint64_t GetId(const std::string& entry_point) const override;
     const BindKey& GetBindKey(const std::string& name) const override;
     uint32_t GetInputLayoutLocation(const std::string& semantic_name) const override;
+    const BindKey& GetBindKey(InternedName name) const override;
+    uint32_t GetInputLayoutLocation(InternedName semantic_name) const override;
     const std::shared_ptr<ShaderReflection>& GetReflection() const override;
 
 protected:
-    std::vector<uint8_t> blob_;
+    std::vector<uint8_t> blob_storage_;
+    std::shared_ptr<const void> blob_owner_;
+    std::span<const uint8_t> blob_;
     ShaderBlobType blob_type_;
     ShaderType shader_type_;
-    std::map<std::string, uint64_t> ids_;
-    std::map<std::string, BindKey> bind_keys_;
-    std::map<std::string, uint32_t> locations_;
+    FlatNameMap<uint64_t> ids_;
+    FlatNameMap<BindKey> bind_keys_;
+    FlatNameMap<uint32_t> locations_;
     std::shared_ptr<ShaderReflection> reflection_;
+
+private:
+    void ParseReflection();
 };
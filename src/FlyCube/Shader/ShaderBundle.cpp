@@ -0,0 +1,167 @@
+#include "Shader/ShaderBundle.h"
+
+#include "ShaderReflection/SerializedReflection.h"
+#include "Utilities/BinaryStream.h"
+#include "Utilities/FileMapping.h"
+#include "Utilities/Trace.h"
+
+#include <nowide/fstream.hpp>
+
+namespace {
+
+constexpr uint32_t kShaderBundleMagic = 0x42534346; // "FCSB"
+constexpr uint32_t kShaderBundleVersion = 1;
+// Blobs are used in place, SPIR-V words must be at least 4-byte aligned.
+constexpr uint64_t kShaderBundleBlobAlignment = 16;
+// magic, version, data offset and shader count.
+constexpr uint64_t kShaderBundleHeaderSize = 24;
+
+uint64_t AlignBlobOffset(uint64_t offset)
+{
+    return (offset + kShaderBundleBlobAlignment - 1) & ~(kShaderBundleBlobAlignment - 1);
+}
+
+} // namespace
+
+ShaderBundle::ShaderBundle(std::shared_ptr<const void> owner, std::span<const uint8_t> data)
+    : owner_(std::move(owner))
+    , data_(data)
+{
+}
+
+std::shared_ptr<ShaderBundle> ShaderBundle::Open(const std::string& path)
+{
+    TRACE_SCOPE("ShaderBundle::Open");
+    auto mapping = FileMapping::Open(path);
+    if (!mapping) {
+        return {};
+    }
+    std::span<const uint8_t> data = mapping->GetData();
+    std::shared_ptr<ShaderBundle> bundle(new ShaderBundle(std::move(mapping), data));
+    if (!bundle->ParseIndex()) {
+        return {};
+    }
+    return bundle;
+}
+
+std::shared_ptr<ShaderBundle> ShaderBundle::Create(std::vector<uint8_t> data)
+{
+    auto storage = std::make_shared<std::vector<uint8_t>>(std::move(data));
+    std::span<const uint8_t> span = *storage;
+    std::shared_ptr<ShaderBundle> bundle(new ShaderBundle(std::move(storage), span));
+    if (!bundle->ParseIndex()) {
+        return {};
+    }
+    return bundle;
+}
+
+bool ShaderBundle::ParseIndex()
+{
+    BinaryReader reader(data_);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t data_offset = 0;
+    uint64_t shader_count = 0;
+    if (!reader.Read(magic) || magic != kShaderBundleMagic || !reader.Read(version) ||
+        version != kShaderBundleVersion || !reader.Read(data_offset) || !reader.Read(shader_count) ||
+        data_offset > data_.size()) {
+        return false;
+    }
+
+    std::span<const uint8_t> blob_data = data_.subspan(data_offset);
+    for (uint64_t i = 0; i < shader_count; ++i) {
+        std::string name;
+        uint32_t type = 0;
+        uint32_t blob_type = 0;
+        uint64_t blob_offset = 0;
+        uint64_t blob_size = 0;
+        Entry entry = {};
+        if (!reader.ReadArray(name) || !reader.Read(type) || !reader.Read(blob_type) || !reader.Read(blob_offset) ||
+            !reader.Read(blob_size) || !reader.ReadSpan(entry.reflection) || blob_offset > blob_data.size() ||
+            blob_size > blob_data.size() - blob_offset) {
+            return false;
+        }
+        entry.type = static_cast<ShaderType>(type);
+        entry.blob = blob_data.subspan(blob_offset, blob_size);
+        entries_[{ name, static_cast<ShaderBlobType>(blob_type) }] = entry;
+    }
+    return true;
+}
+
+std::optional<ShaderBundleShader> ShaderBundle::GetShader(const std::string& name, ShaderBlobType blob_type) const
+{
+    auto it = entries_.find({ name, blob_type });
+    if (it == entries_.end()) {
+        return {};
+    }
+    auto reflection = SerializedReflection::Deserialize(it->second.reflection);
+    if (!reflection) {
+        return {};
+    }
+    return ShaderBundleShader{
+        .type = it->second.type,
+        .blob_type = blob_type,
+        .blob = it->second.blob,
+        .reflection = std::move(reflection),
+        .owner = owner_,
+    };
+}
+
+std::vector<std::string> ShaderBundle::GetShaderNames(ShaderBlobType blob_type) const
+{
+    std::vector<std::string> names;
+    for (const auto& [key, entry] : entries_) {
+        if (key.second == blob_type) {
+            names.push_back(key.first);
+        }
+    }
+    return names;
+}
+
+void ShaderBundleWriter::AddShader(const std::string& name,
+                                   ShaderType type,
+                                   ShaderBlobType blob_type,
+                                   const std::vector<uint8_t>& blob)
+{
+    auto reflection = CreateShaderReflection(blob_type, blob.data(), blob.size());
+    entries_[{ name, blob_type }] = { type, blob, SerializeShaderReflection(*reflection) };
+}
+
+std::vector<uint8_t> ShaderBundleWriter::Serialize() const
+{
+    BinaryWriter index;
+    uint64_t blob_offset = 0;
+    for (const auto& [key, entry] : entries_) {
+        index.WriteArray(key.first);
+        index.Write(static_cast<uint32_t>(entry.type));
+        index.Write(static_cast<uint32_t>(key.second));
+        index.Write(blob_offset);
+        index.Write<uint64_t>(entry.blob.size());
+        index.WriteArray(entry.reflection);
+        blob_offset = AlignBlobOffset(blob_offset + entry.blob.size());
+    }
+
+    uint64_t data_offset = AlignBlobOffset(kShaderBundleHeaderSize + index.GetData().size());
+    std::vector<uint8_t> data;
+    data.reserve(data_offset + blob_offset);
+    BinaryWriter header;
+    header.Write(kShaderBundleMagic);
+    header.Write(kShaderBundleVersion);
+    header.Write(data_offset);
+    header.Write<uint64_t>(entries_.size());
+    data.insert(data.end(), header.GetData().begin(), header.GetData().end());
+    data.insert(data.end(), index.GetData().begin(), index.GetData().end());
+    for (const auto& [key, entry] : entries_) {
+        data.resize(AlignBlobOffset(data.size()));
+        data.insert(data.end(), entry.blob.begin(), entry.blob.end());
+    }
+    return data;
+}
+
+bool ShaderBundleWriter::Save(const std::string& path) const
+{
+    std::vector<uint8_t> data = Serialize();
+    nowide::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return !!file;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "ShaderReflection/ShaderReflection.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ShaderBundleShader {
+    ShaderType type = ShaderType::kUnknown;
+    ShaderBlobType blob_type = ShaderBlobType::kDXIL;
+    std::span<const uint8_t> blob;
+    std::shared_ptr<ShaderReflection> reflection;
+    // Keeps the memory behind blob alive independently of the bundle.
+    std::shared_ptr<const void> owner;
+};
+
+// Many precompiled shaders with their reflection behind a name index, see ShaderCompilerCLI --bundle.
+class ShaderBundle {
+public:
+    static std::shared_ptr<ShaderBundle> Open(const std::string& path);
+    static std::shared_ptr<ShaderBundle> Create(std::vector<uint8_t> data);
+
+    std::optional<ShaderBundleShader> GetShader(const std::string& name, ShaderBlobType blob_type) const;
+    std::vector<std::string> GetShaderNames(ShaderBlobType blob_type) const;
+
+private:
+    struct Entry {
+        ShaderType type;
+        std::span<const uint8_t> blob;
+        std::span<const uint8_t> reflection;
+    };
+
+    ShaderBundle(std::shared_ptr<const void> owner, std::span<const uint8_t> data);
+    bool ParseIndex();
+
+    std::shared_ptr<const void> owner_;
+    std::span<const uint8_t> data_;
+    std::map<std::pair<std::string, ShaderBlobType>, Entry> entries_;
+};
+
+class ShaderBundleWriter {
+public:
+    void AddShader(const std::string& name,
+                   ShaderType type,
+                   ShaderBlobType blob_type,
+                   const std::vector<uint8_t>& blob);
+    std::vector<uint8_t> Serialize() const;
+    bool Save(const std::string& path) const;
+
+private:
+    struct Entry {
+        ShaderType type;
+        std::vector<uint8_t> blob;
+        std::vector<uint8_t> reflection;
+    };
+
+    std::map<std::pair<std::string, ShaderBlobType>, Entry> entries_;
+};
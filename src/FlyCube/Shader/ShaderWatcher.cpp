@@ -0,0 +1,375 @@
+#include "Shader/ShaderWatcher.h"
+
+#include "Device/Device.h"
+#include "HLSLCompiler/Compiler.h"
+#include "Utilities/Logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr auto kPollInterval = std::chrono::milliseconds(100);
+// Editors often save in several steps, wait for the writes to settle before recompiling.
+constexpr auto kDebounceInterval = std::chrono::milliseconds(50);
+
+std::string NormalizePath(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    return (ec ? path : absolute).lexically_normal().string();
+}
+
+template <typename T>
+std::vector<std::shared_ptr<T>> Lock(std::vector<std::weak_ptr<T>>& items)
+{
+    std::vector<std::shared_ptr<T>> locked;
+    std::erase_if(items, [&](const std::weak_ptr<T>& item) {
+        auto ptr = item.lock();
+        if (!ptr) {
+            return true;
+        }
+        locked.push_back(std::move(ptr));
+        return false;
+    });
+    return locked;
+}
+
+} // namespace
+
+const std::shared_ptr<Shader>& WatchedShader::Get() const
+{
+    return shader_;
+}
+
+const std::shared_ptr<Pipeline>& WatchedPipeline::Get() const
+{
+    return pipeline_;
+}
+
+ShaderWatcher::ShaderWatcher(Device& device, uint32_t frame_count, ShaderWatcherBackend backend)
+    : device_(device)
+    , blob_type_(device.GetSupportedShaderBlobType())
+    , frame_count_(frame_count)
+    , backend_(backend)
+{
+#if defined(__linux__)
+    if (backend_ == ShaderWatcherBackend::kNative) {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd_ == -1) {
+            Logging::Println("ShaderWatcher: inotify_init1 failed, hot-reload is disabled");
+            return;
+        }
+    }
+#endif
+    thread_ = std::thread(&ShaderWatcher::WatchLoop, this);
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+#if defined(__linux__)
+    if (inotify_fd_ != -1) {
+        close(inotify_fd_);
+    }
+#endif
+}
+
+std::shared_ptr<WatchedShader> ShaderWatcher::CompileShader(const ShaderDesc& desc)
+{
+    auto watched_shader = std::make_shared<WatchedShader>();
+    watched_shader->desc_ = desc;
+    watched_shader->shader_ = Compile(desc, watched_shader->dependencies_);
+    watched_shader->latest_ = watched_shader->shader_;
+    if (watched_shader->dependencies_.empty()) {
+        watched_shader->dependencies_.push_back(NormalizePath(desc.shader_path));
+    }
+
+    std::lock_guard lock(mutex_);
+    Watch(watched_shader->dependencies_);
+    shaders_.push_back(watched_shader);
+    return watched_shader;
+}
+
+std::shared_ptr<WatchedPipeline> ShaderWatcher::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
+{
+    return AddPipeline(desc, desc.shaders);
+}
+
+std::shared_ptr<WatchedPipeline> ShaderWatcher::CreateComputePipeline(const ComputePipelineDesc& desc)
+{
+    return AddPipeline(desc, { desc.shader });
+}
+
+bool ShaderWatcher::ApplyUpdates()
+{
+    std::lock_guard lock(mutex_);
+    ++frame_;
+    while (!retired_objects_.empty() && retired_objects_.front().frame + frame_count_ <= frame_) {
+        retired_objects_.pop_front();
+    }
+
+    bool updated = !pending_shaders_.empty() || !pending_pipelines_.empty();
+    if (!updated) {
+        return false;
+    }
+    RetiredObjects& retired = retired_objects_.emplace_back();
+    retired.frame = frame_;
+    for (auto& [watched_shader, shader] : pending_shaders_) {
+        retired.shaders.push_back(std::exchange(watched_shader->shader_, std::move(shader)));
+    }
+    for (auto& [watched_pipeline, pipeline] : pending_pipelines_) {
+        retired.pipelines.push_back(std::exchange(watched_pipeline->pipeline_, std::move(pipeline)));
+    }
+    pending_shaders_.clear();
+    pending_pipelines_.clear();
+    return true;
+}
+
+std::shared_ptr<Shader> ShaderWatcher::Compile(const ShaderDesc& desc, std::vector<std::string>& dependencies)
+{
+    // ::Compile treats a missing source as fatal, but here it is usually an editor replacing the file.
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(desc.shader_path, ec)) {
+        Logging::Println("ShaderWatcher: {} does not exist", desc.shader_path);
+        return nullptr;
+    }
+    CompileReport report;
+    std::vector<uint8_t> blob = ::Compile(desc, blob_type_, &report);
+    if (blob.empty()) {
+        Logging::Println("{}", report.errors);
+        return nullptr;
+    }
+    dependencies.clear();
+    for (const auto& dependency : report.dependencies) {
+        dependencies.push_back(NormalizePath(dependency));
+    }
+    return device_.CreateShader(blob, blob_type_, desc.type);
+}
+
+std::shared_ptr<WatchedPipeline> ShaderWatcher::AddPipeline(
+    std::variant<GraphicsPipelineDesc, ComputePipelineDesc> desc,
+    const std::vector<std::shared_ptr<Shader>>& shaders)
+{
+    auto watched_pipeline = std::make_shared<WatchedPipeline>();
+    watched_pipeline->desc_ = std::move(desc);
+
+    std::lock_guard lock(mutex_);
+    std::vector<std::shared_ptr<WatchedShader>> watched_shaders = Lock(shaders_);
+    for (const auto& shader : shaders) {
+        auto it = std::find_if(watched_shaders.begin(), watched_shaders.end(),
+                               [&](const auto& watched_shader) { return shader && watched_shader->shader_ == shader; });
+        watched_pipeline->shaders_.push_back(it != watched_shaders.end() ? *it : nullptr);
+    }
+    watched_pipeline->pipeline_ = CreatePipeline(*watched_pipeline);
+    pipelines_.push_back(watched_pipeline);
+    return watched_pipeline;
+}
+
+std::shared_ptr<Pipeline> ShaderWatcher::CreatePipeline(
+    const WatchedPipeline& pipeline,
+    const std::map<std::shared_ptr<WatchedShader>, std::shared_ptr<Shader>>& rebuilt_shaders)
+{
+    auto get_shader = [&](size_t index, const std::shared_ptr<Shader>& shader) {
+        const auto& watched_shader = pipeline.shaders_[index];
+        if (!watched_shader) {
+            return shader;
+        }
+        auto it = rebuilt_shaders.find(watched_shader);
+        return it != rebuilt_shaders.end() ? it->second : watched_shader->latest_;
+    };
+    if (auto* graphics_desc = std::get_if<GraphicsPipelineDesc>(&pipeline.desc_)) {
+        GraphicsPipelineDesc desc = *graphics_desc;
+        for (size_t i = 0; i < desc.shaders.size(); ++i) {
+            desc.shaders[i] = get_shader(i, desc.shaders[i]);
+            if (!desc.shaders[i]) {
+                return nullptr;
+            }
+        }
+        return device_.CreateGraphicsPipeline(desc);
+    }
+    ComputePipelineDesc desc = std::get<ComputePipelineDesc>(pipeline.desc_);
+    desc.shader = get_shader(0, desc.shader);
+    if (!desc.shader) {
+        return nullptr;
+    }
+    return device_.CreateComputePipeline(desc);
+}
+
+void ShaderWatcher::Watch(const std::vector<std::string>& paths)
+{
+#if defined(__linux__)
+    if (backend_ == ShaderWatcherBackend::kNative) {
+        for (const auto& path : paths) {
+            std::filesystem::path dir = std::filesystem::path(path).parent_path();
+            int wd = inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (wd == -1) {
+                Logging::Println("ShaderWatcher: failed to watch {}", dir.string());
+                continue;
+            }
+            watch_dirs_[wd] = dir;
+        }
+        return;
+    }
+#endif
+    for (const auto& path : paths) {
+        std::error_code ec;
+        last_write_times_.try_emplace(path, std::filesystem::last_write_time(path, ec));
+    }
+}
+
+std::set<std::string> ShaderWatcher::WaitForChanges()
+{
+    std::set<std::string> changed_paths;
+#if defined(__linux__)
+    if (backend_ == ShaderWatcherBackend::kNative) {
+        pollfd fd = { inotify_fd_, POLLIN, 0 };
+        auto timeout = kPollInterval;
+        while (poll(&fd, 1, timeout.count()) > 0) {
+            alignas(inotify_event) char buffer[4096];
+            ssize_t size = 0;
+            while ((size = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                std::lock_guard lock(mutex_);
+                for (char* ptr = buffer; ptr < buffer + size;) {
+                    auto* event = reinterpret_cast<inotify_event*>(ptr);
+                    auto it = watch_dirs_.find(event->wd);
+                    if (it != watch_dirs_.end() && event->len) {
+                        changed_paths.insert(NormalizePath(it->second / event->name));
+                    }
+                    ptr += sizeof(inotify_event) + event->len;
+                }
+            }
+            timeout = kDebounceInterval;
+        }
+        return changed_paths;
+    }
+#endif
+    std::this_thread::sleep_for(kPollInterval);
+    std::lock_guard lock(mutex_);
+    for (auto& [path, last_write_time] : last_write_times_) {
+        std::error_code ec;
+        auto write_time = std::filesystem::last_write_time(path, ec);
+        if (!ec && write_time != last_write_time) {
+            last_write_time = write_time;
+            changed_paths.insert(path);
+        }
+    }
+    if (!changed_paths.empty()) {
+        std::this_thread::sleep_for(kDebounceInterval);
+    }
+    return changed_paths;
+}
+
+void ShaderWatcher::Rebuild(const std::set<std::string>& changed_paths)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<WatchedShader>> watched_shaders;
+    std::vector<std::shared_ptr<WatchedPipeline>> watched_pipelines;
+    {
+        std::lock_guard lock(mutex_);
+        watched_shaders = Lock(shaders_);
+        watched_pipelines = Lock(pipelines_);
+    }
+
+    std::map<std::shared_ptr<WatchedShader>, std::shared_ptr<Shader>> rebuilt_shaders;
+    for (const auto& watched_shader : watched_shaders) {
+        bool affected = std::any_of(watched_shader->dependencies_.begin(), watched_shader->dependencies_.end(),
+                                    [&](const std::string& path) { return changed_paths.contains(path); });
+        if (!affected) {
+            continue;
+        }
+
+        std::vector<std::string> dependencies;
+        std::shared_ptr<Shader> shader = Compile(watched_shader->desc_, dependencies);
+        if (!shader) {
+            Logging::Println("ShaderWatcher: failed to recompile {}, keeping the previous version",
+                             watched_shader->desc_.shader_path);
+            continue;
+        }
+        rebuilt_shaders[watched_shader] = std::move(shader);
+
+        std::lock_guard lock(mutex_);
+        watched_shader->dependencies_ = std::move(dependencies);
+        Watch(watched_shader->dependencies_);
+    }
+    if (rebuilt_shaders.empty()) {
+        return;
+    }
+
+    auto uses_any = [](const WatchedPipeline& watched_pipeline, const auto& shaders) {
+        return std::any_of(watched_pipeline.shaders_.begin(), watched_pipeline.shaders_.end(),
+                           [&](const auto& shader) { return shaders.contains(shader); });
+    };
+    std::vector<std::shared_ptr<WatchedPipeline>> affected_pipelines;
+    std::map<std::shared_ptr<WatchedPipeline>, std::shared_ptr<Pipeline>> rebuilt_pipelines;
+    for (const auto& watched_pipeline : watched_pipelines) {
+        if (!uses_any(*watched_pipeline, rebuilt_shaders)) {
+            continue;
+        }
+        affected_pipelines.push_back(watched_pipeline);
+        if (std::shared_ptr<Pipeline> pipeline = CreatePipeline(*watched_pipeline, rebuilt_shaders)) {
+            rebuilt_pipelines[watched_pipeline] = std::move(pipeline);
+        }
+    }
+
+    // A pipeline that failed to build keeps the previous versions of all its shaders, which in turn holds back the
+    // other pipelines built from the new versions of those shaders.
+    std::set<std::shared_ptr<WatchedShader>> rejected_shaders;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& watched_pipeline : affected_pipelines) {
+            if (rebuilt_pipelines.contains(watched_pipeline) && !uses_any(*watched_pipeline, rejected_shaders)) {
+                continue;
+            }
+            rebuilt_pipelines.erase(watched_pipeline);
+            for (const auto& shader : watched_pipeline->shaders_) {
+                if (rebuilt_shaders.contains(shader) && rejected_shaders.insert(shader).second) {
+                    changed = true;
+                }
+            }
+        }
+    }
+    for (const auto& watched_shader : rejected_shaders) {
+        Logging::Println("ShaderWatcher: failed to rebuild pipelines for {}, keeping the previous version",
+                         watched_shader->desc_.shader_path);
+        rebuilt_shaders.erase(watched_shader);
+    }
+    if (rebuilt_shaders.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        for (auto& [watched_shader, shader] : rebuilt_shaders) {
+            watched_shader->latest_ = shader;
+            pending_shaders_[watched_shader] = std::move(shader);
+        }
+        for (auto& [watched_pipeline, pipeline] : rebuilt_pipelines) {
+            pending_pipelines_[watched_pipeline] = std::move(pipeline);
+        }
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    Logging::Println("ShaderWatcher: reloaded {} shaders and {} pipelines in {:.2f} ms", rebuilt_shaders.size(),
+                     rebuilt_pipelines.size(), elapsed.count());
+}
+
+void ShaderWatcher::WatchLoop()
+{
+    while (!stop_) {
+        std::set<std::string> changed_paths = WaitForChanges();
+        if (!changed_paths.empty()) {
+            Rebuild(changed_paths);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Pipeline/Pipeline.h"
+#include "Shader/Shader.h"
+
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+class Device;
+
+class WatchedShader {
+public:
+    const std::shared_ptr<Shader>& Get() const;
+
+private:
+    friend class ShaderWatcher;
+
+    ShaderDesc desc_;
+    std::shared_ptr<Shader> shader_;
+    std::shared_ptr<Shader> latest_;
+    std::vector<std::string> dependencies_;
+};
+
+class WatchedPipeline {
+public:
+    const std::shared_ptr<Pipeline>& Get() const;
+
+private:
+    friend class ShaderWatcher;
+
+    std::variant<GraphicsPipelineDesc, ComputePipelineDesc> desc_;
+    std::vector<std::shared_ptr<WatchedShader>> shaders_;
+    std::shared_ptr<Pipeline> pipeline_;
+};
+
+enum class ShaderWatcherBackend {
+    // inotify on Linux, modification time polling elsewhere.
+    kNative,
+    kPolling,
+};
+
+// Recompiles shaders on a background thread when their sources or includes change. Get() on the returned handles
+// keeps returning the previous objects until ApplyUpdates() is called, which must happen on the same thread.
+// ApplyUpdates() is expected once per frame: replaced objects stay alive for frame_count more calls so that
+// command lists still in flight can finish with them. A rebuilt shader is only handed out together with every
+// pipeline that uses it, if one of those pipelines fails to build the previous shader and pipelines stay in place.
+class ShaderWatcher {
+public:
+    explicit ShaderWatcher(Device& device,
+                           uint32_t frame_count = 3,
+                           ShaderWatcherBackend backend = ShaderWatcherBackend::kNative);
+    ~ShaderWatcher();
+
+    std::shared_ptr<WatchedShader> CompileShader(const ShaderDesc& desc);
+    std::shared_ptr<WatchedPipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc);
+    std::shared_ptr<WatchedPipeline> CreateComputePipeline(const ComputePipelineDesc& desc);
+
+    // Swaps in everything rebuilt since the last call, returns true if any shader or pipeline changed.
+    bool ApplyUpdates();
+
+private:
+    struct RetiredObjects {
+        uint64_t frame = 0;
+        std::vector<std::shared_ptr<Shader>> shaders;
+        std::vector<std::shared_ptr<Pipeline>> pipelines;
+    };
+
+    std::shared_ptr<Shader> Compile(const ShaderDesc& desc, std::vector<std::string>& dependencies);
+    std::shared_ptr<WatchedPipeline> AddPipeline(std::variant<GraphicsPipelineDesc, ComputePipelineDesc> desc,
+                                                 const std::vector<std::shared_ptr<Shader>>& shaders);
+    std::shared_ptr<Pipeline> CreatePipeline(
+        const WatchedPipeline& pipeline,
+        const std::map<std::shared_ptr<WatchedShader>, std::shared_ptr<Shader>>& rebuilt_shaders = {});
+    void Watch(const std::vector<std::string>& paths);
+    std::set<std::string> WaitForChanges();
+    void Rebuild(const std::set<std::string>& changed_paths);
+    void WatchLoop();
+
+    Device& device_;
+    ShaderBlobType blob_type_;
+    std::mutex mutex_;
+    std::vector<std::weak_ptr<WatchedShader>> shaders_;
+    std::vector<std::weak_ptr<WatchedPipeline>> pipelines_;
+    std::map<std::shared_ptr<WatchedShader>, std::shared_ptr<Shader>> pending_shaders_;
+    std::map<std::shared_ptr<WatchedPipeline>, std::shared_ptr<Pipeline>> pending_pipelines_;
+    uint32_t frame_count_;
+    uint64_t frame_ = 0;
+    std::deque<RetiredObjects> retired_objects_;
+    ShaderWatcherBackend backend_;
+#if defined(__linux__)
+    int inotify_fd_ = -1;
+    std::map<int, std::filesystem::path> watch_dirs_;
+#endif
+    std::map<std::string, std::filesystem::file_time_type> last_write_times_;
+    std::atomic<bool> stop_ = false;
+    std::thread thread_;
+};
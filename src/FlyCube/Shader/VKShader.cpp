@@ -0,0 +1,21 @@
+#include "Shader/VKShader.h"
+
+#include "Device/VKDevice.h"
+
+VKShader::VKShader(VKDevice& device, const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type)
+    : ShaderBase(blob, blob_type, shader_type)
+    , device_(device)
+{
+}
+
+VKShader::VKShader(VKDevice& device, const ShaderBundleShader& shader)
+    : ShaderBase(shader)
+    , device_(device)
+{
+}
+
+vk::ShaderModule VKShader::GetShaderModule()
+{
+    std::call_once(shader_module_once_, [&] { shader_module_ = device_.CreateShaderModule(blob_); });
+    return shader_module_.get();
+}
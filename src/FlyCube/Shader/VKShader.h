@@ -0,0 +1,24 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Shader/ShaderBase.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <mutex>
+#include <vector>
+
+class VKDevice;
+
+class VKShader : public ShaderBase {
+public:
+    VKShader(VKDevice& device, const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type);
+    VKShader(VKDevice& device, const ShaderBundleShader& shader);
+
+    // Created on first use and shared by every pipeline built from this shader.
+    vk::ShaderModule GetShaderModule();
+
+private:
+    VKDevice& device_;
+    std::once_flag shader_module_once_;
+    vk::UniqueShaderModule shader_module_;
+};
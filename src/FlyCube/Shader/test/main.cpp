@@ -0,0 +1,444 @@
+#include "Device/Device.h"
+#include "Shader/ShaderWatcher.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+class TestShader : public Shader {
+public:
+    TestShader(std::vector<uint8_t> blob, ShaderType type)
+        : blob_(std::move(blob))
+        , type_(type)
+    {
+    }
+
+    ShaderType GetType() const override
+    {
+        return type_;
+    }
+
+    std::span<const uint8_t> GetBlob() const override
+    {
+        return blob_;
+    }
+
+    uint64_t GetId(const std::string& entry_point) const override
+    {
+        return 0;
+    }
+
+    const BindKey& GetBindKey(const std::string& name) const override
+    {
+        return bind_key_;
+    }
+
+    uint32_t GetInputLayoutLocation(const std::string& semantic_name) const override
+    {
+        return 0;
+    }
+
+    const BindKey& GetBindKey(InternedName name) const override
+    {
+        return bind_key_;
+    }
+
+    uint32_t GetInputLayoutLocation(InternedName semantic_name) const override
+    {
+        return 0;
+    }
+
+    const std::shared_ptr<ShaderReflection>& GetReflection() const override
+    {
+        return reflection_;
+    }
+
+private:
+    std::vector<uint8_t> blob_;
+    ShaderType type_;
+    BindKey bind_key_;
+    std::shared_ptr<ShaderReflection> reflection_;
+};
+
+class TestPipeline : public Pipeline {
+public:
+    explicit TestPipeline(std::shared_ptr<Shader> shader)
+        : shader_(std::move(shader))
+    {
+    }
+
+    PipelineType GetPipelineType() const override
+    {
+        return PipelineType::kCompute;
+    }
+
+    std::vector<uint8_t> GetRayTracingShaderGroupHandles(uint32_t first_group, uint32_t group_count) const override
+    {
+        return {};
+    }
+
+    const std::shared_ptr<Shader>& GetShader() const
+    {
+        return shader_;
+    }
+
+private:
+    std::shared_ptr<Shader> shader_;
+};
+
+// Only shader and compute pipeline creation are used by ShaderWatcher.
+class TestDevice : public Device {
+public:
+    std::atomic<bool> fail_pipelines = false;
+    std::atomic<uint32_t> pipeline_requests = 0;
+
+    std::shared_ptr<Memory> AllocateMemory(uint64_t size, MemoryType memory_type, uint32_t memory_type_bits) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<CommandQueue> GetCommandQueue(CommandListType type) override
+    {
+        return nullptr;
+    }
+
+    uint32_t GetTextureDataPitchAlignment() const override
+    {
+        return 0;
+    }
+
+    std::shared_ptr<Swapchain> CreateSwapchain(const NativeSurface& surface,
+                                               uint32_t width,
+                                               uint32_t height,
+                                               uint32_t frame_count,
+                                               bool vsync) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<CommandList> CreateCommandList(CommandListType type) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Fence> CreateFence(uint64_t initial_value) override
+    {
+        return nullptr;
+    }
+
+    MemoryRequirements GetTextureMemoryRequirements(const TextureDesc& desc) override
+    {
+        return {};
+    }
+
+    MemoryRequirements GetMemoryBufferRequirements(const BufferDesc& desc) override
+    {
+        return {};
+    }
+
+    std::shared_ptr<Resource> CreatePlacedTexture(const std::shared_ptr<Memory>& memory,
+                                                  uint64_t offset,
+                                                  const TextureDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Resource> CreatePlacedBuffer(const std::shared_ptr<Memory>& memory,
+                                                 uint64_t offset,
+                                                 const BufferDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Resource> CreateTexture(MemoryType memory_type, const TextureDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Resource> CreateBuffer(MemoryType memory_type, const BufferDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Resource> CreateSampler(const SamplerDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<View> CreateView(const std::shared_ptr<Resource>& resource, const ViewDesc& view_desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<BindlessTypedViewPool> CreateBindlessTypedViewPool(ViewType view_type,
+                                                                       uint32_t view_count) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<BindingSetLayout> CreateBindingSetLayout(const BindingSetLayoutDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<BindingSet> CreateBindingSet(const std::shared_ptr<BindingSetLayout>& layout) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Shader> CreateShader(const std::vector<uint8_t>& blob,
+                                         ShaderBlobType blob_type,
+                                         ShaderType shader_type) override
+    {
+        return std::make_shared<TestShader>(blob, shader_type);
+    }
+
+    std::shared_ptr<Shader> CreateShaderFromBundle(const ShaderBundle& bundle, const std::string& name) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Shader> CompileShader(const ShaderDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override
+    {
+        ++pipeline_requests;
+        if (fail_pipelines) {
+            return nullptr;
+        }
+        return std::make_shared<TestPipeline>(desc.shader);
+    }
+
+    std::shared_ptr<Pipeline> CreateRayTracingPipeline(const RayTracingPipelineDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Resource> CreateAccelerationStructure(const AccelerationStructureDesc& desc) override
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<QueryHeap> CreateQueryHeap(QueryHeapType type, uint32_t count) override
+    {
+        return nullptr;
+    }
+
+    bool IsDxrSupported() const override
+    {
+        return false;
+    }
+
+    bool IsRayQuerySupported() const override
+    {
+        return false;
+    }
+
+    bool IsVariableRateShadingSupported() const override
+    {
+        return false;
+    }
+
+    bool IsMeshShadingSupported() const override
+    {
+        return false;
+    }
+
+    bool IsDrawIndirectCountSupported() const override
+    {
+        return false;
+    }
+
+    bool IsGeometryShaderSupported() const override
+    {
+        return false;
+    }
+
+    bool IsBindlessSupported() const override
+    {
+        return false;
+    }
+
+    bool IsSamplerFilterMinmaxSupported() const override
+    {
+        return false;
+    }
+
+    bool IsConditionalRenderingSupported() const override
+    {
+        return false;
+    }
+
+    DynamicStateFlags GetSupportedDynamicStates() const override
+    {
+        return DynamicStateFlags::kNone;
+    }
+
+    uint32_t GetShadingRateImageTileSize() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetMinSubgroupSize() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetMaxSubgroupSize() const override
+    {
+        return 0;
+    }
+
+    MemoryBudget GetMemoryBudget() const override
+    {
+        return {};
+    }
+
+    uint32_t GetShaderGroupHandleSize() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetShaderRecordAlignment() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetShaderTableAlignment() const override
+    {
+        return 0;
+    }
+
+    RaytracingASPrebuildInfo GetBLASPrebuildInfo(const std::vector<RaytracingGeometryDesc>& descs,
+                                                 BuildAccelerationStructureFlags flags) const override
+    {
+        return {};
+    }
+
+    RaytracingASPrebuildInfo GetTLASPrebuildInfo(uint32_t instance_count,
+                                                 BuildAccelerationStructureFlags flags) const override
+    {
+        return {};
+    }
+
+    ShaderBlobType GetSupportedShaderBlobType() const override
+    {
+        return ShaderBlobType::kSPIRV;
+    }
+
+    uint64_t GetConstantBufferOffsetAlignment() const override
+    {
+        return 0;
+    }
+
+    double GetTimestampPeriod() const override
+    {
+        return 0;
+    }
+
+    PipelineDescCacheStats GetPipelineDescCacheStats() const override
+    {
+        return {};
+    }
+};
+
+constexpr auto kTimeout = std::chrono::seconds(10);
+// Several poll intervals of the polling backend, long enough for a pending rebuild to show up.
+constexpr auto kSettleInterval = std::chrono::milliseconds(500);
+
+void WriteShader(const std::filesystem::path& path, uint32_t value)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "RWBuffer<uint> result : register(u0);\n"
+         << "[numthreads(1, 1, 1)]\n"
+         << "void main()\n"
+         << "{\n"
+         << "    result[0] = " << value << ";\n"
+         << "}\n";
+}
+
+template <typename Predicate>
+bool WaitFor(Predicate&& predicate)
+{
+    auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("ShaderWatcher applies a shader only together with its rebuilt pipeline")
+{
+    auto dir = std::filesystem::temp_directory_path() / "FlyCubeShaderWatcherTest";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    auto path = dir / "ComputeShader.hlsl";
+    WriteShader(path, 1);
+
+    TestDevice device;
+    ShaderWatcher watcher(device, 3, ShaderWatcherBackend::kPolling);
+    auto shader = watcher.CompileShader({ path.string(), "main", ShaderType::kCompute, "6_0" });
+    REQUIRE(shader->Get());
+    ComputePipelineDesc pipeline_desc = {};
+    pipeline_desc.shader = shader->Get();
+    auto pipeline = watcher.CreateComputePipeline(pipeline_desc);
+    REQUIRE(pipeline->Get());
+
+    auto get_pipeline_shader = [&] { return std::static_pointer_cast<TestPipeline>(pipeline->Get())->GetShader(); };
+    REQUIRE(get_pipeline_shader() == shader->Get());
+
+    SECTION("Edit")
+    {
+        auto old_shader = shader->Get();
+        auto old_pipeline = pipeline->Get();
+        WriteShader(path, 2);
+        REQUIRE(WaitFor([&] { return watcher.ApplyUpdates(); }));
+        CHECK(shader->Get() != old_shader);
+        CHECK(pipeline->Get() != old_pipeline);
+        CHECK(get_pipeline_shader() == shader->Get());
+
+        std::this_thread::sleep_for(kSettleInterval);
+        CHECK(!watcher.ApplyUpdates());
+        CHECK(device.pipeline_requests == 2);
+    }
+
+    SECTION("FailedPipeline")
+    {
+        auto old_shader = shader->Get();
+        auto old_pipeline = pipeline->Get();
+        device.fail_pipelines = true;
+        WriteShader(path, 2);
+        REQUIRE(WaitFor([&] { return device.pipeline_requests == 2; }));
+        std::this_thread::sleep_for(kSettleInterval);
+        CHECK(!watcher.ApplyUpdates());
+        CHECK(shader->Get() == old_shader);
+        CHECK(pipeline->Get() == old_pipeline);
+
+        device.fail_pipelines = false;
+        WriteShader(path, 3);
+        REQUIRE(WaitFor([&] { return watcher.ApplyUpdates(); }));
+        CHECK(shader->Get() != old_shader);
+        CHECK(get_pipeline_shader() == shader->Get());
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,215 @@
+#include "ShaderReflection/BindingHeader.h"
+
+#include "Utilities/NotReached.h"
+
+#include <cctype>
+#include <format>
+#include <optional>
+#include <set>
+
+namespace {
+
+std::string ToIdentifier(const std::string& name)
+{
+    std::string identifier;
+    for (char c : name) {
+        identifier += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (identifier.empty() || std::isdigit(static_cast<unsigned char>(identifier.front()))) {
+        identifier = "_" + identifier;
+    }
+    return identifier;
+}
+
+std::string GetShaderTypeName(ShaderType shader_type)
+{
+    switch (shader_type) {
+    case ShaderType::kUnknown:
+        return "ShaderType::kUnknown";
+    case ShaderType::kVertex:
+        return "ShaderType::kVertex";
+    case ShaderType::kPixel:
+        return "ShaderType::kPixel";
+    case ShaderType::kCompute:
+        return "ShaderType::kCompute";
+    case ShaderType::kGeometry:
+        return "ShaderType::kGeometry";
+    case ShaderType::kAmplification:
+        return "ShaderType::kAmplification";
+    case ShaderType::kMesh:
+        return "ShaderType::kMesh";
+    case ShaderType::kLibrary:
+        return "ShaderType::kLibrary";
+    default:
+        NOTREACHED();
+    }
+}
+
+std::string GetViewTypeName(ViewType view_type)
+{
+    switch (view_type) {
+    case ViewType::kUnknown:
+        return "ViewType::kUnknown";
+    case ViewType::kConstantBuffer:
+        return "ViewType::kConstantBuffer";
+    case ViewType::kSampler:
+        return "ViewType::kSampler";
+    case ViewType::kTexture:
+        return "ViewType::kTexture";
+    case ViewType::kRWTexture:
+        return "ViewType::kRWTexture";
+    case ViewType::kBuffer:
+        return "ViewType::kBuffer";
+    case ViewType::kRWBuffer:
+        return "ViewType::kRWBuffer";
+    case ViewType::kStructuredBuffer:
+        return "ViewType::kStructuredBuffer";
+    case ViewType::kRWStructuredBuffer:
+        return "ViewType::kRWStructuredBuffer";
+    case ViewType::kByteAddressBuffer:
+        return "ViewType::kByteAddressBuffer";
+    case ViewType::kRWByteAddressBuffer:
+        return "ViewType::kRWByteAddressBuffer";
+    case ViewType::kAccelerationStructure:
+        return "ViewType::kAccelerationStructure";
+    case ViewType::kShadingRateSource:
+        return "ViewType::kShadingRateSource";
+    case ViewType::kRenderTarget:
+        return "ViewType::kRenderTarget";
+    case ViewType::kDepthStencil:
+        return "ViewType::kDepthStencil";
+    default:
+        NOTREACHED();
+    }
+}
+
+struct MemberType {
+    std::string name;
+    uint32_t size;
+};
+
+std::optional<MemberType> GetMemberType(const VariableLayout& layout)
+{
+    std::string scalar;
+    std::string vector;
+    switch (layout.type) {
+    case VariableType::kFloat:
+        scalar = "float";
+        vector = "glm::vec";
+        break;
+    case VariableType::kInt:
+        scalar = "int32_t";
+        vector = "glm::ivec";
+        break;
+    case VariableType::kUint:
+    case VariableType::kBool:
+        scalar = "uint32_t";
+        vector = "glm::uvec";
+        break;
+    default:
+        return {};
+    }
+
+    if (layout.rows <= 1 && layout.columns <= 1) {
+        return MemberType{ scalar, 4 };
+    } else if (layout.rows <= 1 && layout.columns <= 4) {
+        return MemberType{ vector + std::to_string(layout.columns), 4 * layout.columns };
+    } else if (layout.type == VariableType::kFloat && layout.rows == 4 && layout.columns == 4) {
+        return MemberType{ "glm::mat4", 64 };
+    }
+    return {};
+}
+
+// Falls back to raw bytes whenever the HLSL packing cannot be expressed with plain glm types.
+std::string GetMemberDeclaration(const VariableLayout& member, const std::string& member_name)
+{
+    auto type = GetMemberType(member);
+    if (type && member.elements == 0 && type->size == member.size) {
+        return std::format("{} {};", type->name, member_name);
+    }
+    // Every array element is 16-byte aligned in a constant buffer.
+    if (type && member.elements > 0 && type->size % 16 == 0 && type->size * member.elements == member.size) {
+        return std::format("{} {}[{}];", type->name, member_name, member.elements);
+    }
+    return std::format("uint8_t {}[{}];", member_name, member.size);
+}
+
+void GenerateLayout(const VariableLayout& layout, std::string& header)
+{
+    std::string struct_name = ToIdentifier(layout.name);
+    std::string asserts;
+    header += std::format("struct {} {{\n", struct_name);
+    uint32_t offset = 0;
+    for (const auto& member : layout.members) {
+        if (member.offset < offset) {
+            continue;
+        }
+        if (member.offset > offset) {
+            header += std::format("    uint8_t padding_{}[{}];\n", offset, member.offset - offset);
+        }
+        std::string member_name = ToIdentifier(member.name);
+        header += std::format("    {}\n", GetMemberDeclaration(member, member_name));
+        asserts += std::format("static_assert(offsetof({}, {}) == {});\n", struct_name, member_name, member.offset);
+        offset = member.offset + member.size;
+    }
+    if (layout.size > offset) {
+        header += std::format("    uint8_t padding_{}[{}];\n", offset, layout.size - offset);
+    }
+    header += "};\n";
+    header += asserts;
+    header += std::format("static_assert(sizeof({}) == {});\n", struct_name, layout.size);
+}
+
+} // namespace
+
+std::string GenerateBindingHeader(const std::string& shader_name,
+                                  ShaderType shader_type,
+                                  const ShaderReflection& reflection)
+{
+    std::string header = std::format("// Generated by ShaderCompilerCLI from {}, do not edit.\n", shader_name);
+    header += "#pragma once\n";
+    header += "#include \"Instance/BaseTypes.h\"\n\n";
+    header += "#include <glm/glm.hpp>\n\n";
+    header += "#include <cstddef>\n";
+    header += "#include <cstdint>\n\n";
+    std::string namespace_name = "Shaders::" + ToIdentifier(shader_name);
+    header += std::format("namespace {} {{\n\n", namespace_name);
+    header += std::format("inline constexpr ShaderType kShaderType = {};\n\n", GetShaderTypeName(shader_type));
+
+    header += "namespace BindKeys {\n";
+    std::set<std::string> names;
+    for (const auto& binding : reflection.GetBindings()) {
+        std::string name = ToIdentifier(binding.name);
+        if (!names.insert(name).second) {
+            continue;
+        }
+        std::string count = binding.count == kBindlessCount ? "kBindlessCount" : std::to_string(binding.count);
+        header += std::format("inline constexpr BindKey {} = {{ {}, {}, {}, {}, {} }};\n", name,
+                              GetShaderTypeName(shader_type), GetViewTypeName(binding.type), binding.slot,
+                              binding.space, count);
+    }
+    header += "} // namespace BindKeys\n\n";
+
+    header += "namespace InputLocations {\n";
+    names.clear();
+    for (const auto& input_parameter : reflection.GetInputParameters()) {
+        std::string name = ToIdentifier(input_parameter.semantic_name);
+        if (names.insert(name).second) {
+            header += std::format("inline constexpr uint32_t {} = {};\n", name, input_parameter.location);
+        }
+    }
+    header += "} // namespace InputLocations\n\n";
+
+    header += "namespace Layouts {\n";
+    names.clear();
+    for (const auto& layout : reflection.GetVariableLayouts()) {
+        if (layout.name.empty() || layout.members.empty() || !names.insert(ToIdentifier(layout.name)).second) {
+            continue;
+        }
+        GenerateLayout(layout, header);
+    }
+    header += "} // namespace Layouts\n\n";
+
+    header += std::format("}} // namespace {}\n", namespace_name);
+    return header;
+}
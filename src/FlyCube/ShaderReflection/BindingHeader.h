@@ -0,0 +1,11 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "ShaderReflection/ShaderReflection.h"
+
+#include <string>
+
+// C++ header with constexpr BindKeys, input locations and static_assert-checked constant buffer structs.
+// Everything is placed in namespace Shaders::<shader_name as identifier>.
+std::string GenerateBindingHeader(const std::string& shader_name,
+                                  ShaderType shader_type,
+                                  const ShaderReflection& reflection);
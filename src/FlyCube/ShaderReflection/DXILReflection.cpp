@@ -145,6 +145,11 @@ const ShaderFeatureInfo& DXILReflection::GetShaderFeatureInfo() const
     return shader_feature_info_;
 }
 
+const std::vector<SpecializationConstantDesc>& DXILReflection::GetSpecializationConstants() const
+{
+    return specialization_constants_;
+}
+
 void DXILReflection::ParseRuntimeData(CComPtr<IDxcContainerReflection> reflection, uint32_t idx)
 {
     CComPtr<IDxcBlob> part_blob;
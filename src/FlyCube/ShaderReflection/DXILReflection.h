@@ -11,6 +11,7 @@ public:
     const std::vector<InputParameterDesc>& GetInputParameters() const override;
     const std::vector<OutputParameterDesc>& GetOutputParameters() const override;
     const ShaderFeatureInfo& GetShaderFeatureInfo() const override;
+    const std::vector<SpecializationConstantDesc>& GetSpecializationConstants() const override;
 
 private:
     void ParseRuntimeData(CComPtr<IDxcContainerReflection> reflection, uint32_t idx);
@@ -20,4 +20,5 @@ protected:
     std::vector<InputParameterDesc> input_parameters_;
     std::vector<OutputParameterDesc> output_parameters_;
     ShaderFeatureInfo shader_feature_info_ = {};
+    std::vector<SpecializationConstantDesc> specialization_constants_;
 };
@@ -55,9 +55,9 @@ std::string FixSemanticName(std::string semantic_name)
     return semantic_name;
 }
 
-std::vector<InputParameterDesc> ParseInputParameters(const spirv_cross::Compiler& compiler)
+std::vector<InputParameterDesc> ParseInputParameters(const spirv_cross::Compiler& compiler,
+                                                     const spirv_cross::ShaderResources& resources)
 {
-    spirv_cross::ShaderResources resources = compiler.get_shader_resources();
     std::vector<InputParameterDesc> input_parameters;
     for (const auto& resource : resources.stage_inputs) {
         decltype(auto) input = input_parameters.emplace_back();
@@ -100,9 +100,9 @@ std::vector<InputParameterDesc> ParseInputParameters(const spirv_cross::Compiler
     return input_parameters;
 }
 
-std::vector<OutputParameterDesc> ParseOutputParameters(const spirv_cross::Compiler& compiler)
+std::vector<OutputParameterDesc> ParseOutputParameters(const spirv_cross::Compiler& compiler,
+                                                       const spirv_cross::ShaderResources& resources)
 {
-    spirv_cross::ShaderResources resources = compiler.get_shader_resources();
     std::vector<OutputParameterDesc> output_parameters;
     for (const auto& resource : resources.stage_outputs) {
         decltype(auto) output = output_parameters.emplace_back();
@@ -111,6 +111,45 @@ std::vector<OutputParameterDesc> ParseOutputParameters(const spirv_cross::Compil
     return output_parameters;
 }
 
+VariableType GetVariableType(const spirv_cross::SPIRType& type)
+{
+    switch (type.basetype) {
+    case spirv_cross::SPIRType::BaseType::Float:
+        return VariableType::kFloat;
+    case spirv_cross::SPIRType::BaseType::Int:
+        return VariableType::kInt;
+    case spirv_cross::SPIRType::BaseType::UInt:
+        return VariableType::kUint;
+    case spirv_cross::SPIRType::BaseType::Boolean:
+        return VariableType::kBool;
+    default:
+        NOTREACHED();
+    }
+}
+
+std::vector<SpecializationConstantDesc> ParseSpecializationConstants(const spirv_cross::Compiler& compiler)
+{
+    std::vector<SpecializationConstantDesc> specialization_constants;
+    for (const auto& constant : compiler.get_specialization_constants()) {
+        decltype(auto) value = compiler.get_constant(constant.id);
+        decltype(auto) type = compiler.get_type(value.constant_type);
+        // SpecializationConstant::value is 32 bits wide, half and 64-bit constants keep their default value.
+        bool is_32_bit_scalar = type.basetype == spirv_cross::SPIRType::BaseType::Float ||
+                                type.basetype == spirv_cross::SPIRType::BaseType::Int ||
+                                type.basetype == spirv_cross::SPIRType::BaseType::UInt;
+        if (type.vecsize != 1 || type.columns != 1 ||
+            (type.basetype != spirv_cross::SPIRType::BaseType::Boolean && !(is_32_bit_scalar && type.width == 32))) {
+            continue;
+        }
+        decltype(auto) specialization_constant = specialization_constants.emplace_back();
+        specialization_constant.name = compiler.get_name(constant.id);
+        specialization_constant.id = constant.constant_id;
+        specialization_constant.type = GetVariableType(type);
+        specialization_constant.default_value = value.scalar();
+    }
+    return specialization_constants;
+}
+
 bool IsBufferDimension(spv::Dim dimension)
 {
     switch (dimension) {
@@ -297,22 +336,7 @@ VariableLayout GetBufferMemberLayout(const spirv_cross::CompilerHLSL& compiler,
         assert(type.array.size() == 1);
         layout.elements = type.array.front();
     }
-    switch (type.basetype) {
-    case spirv_cross::SPIRType::BaseType::Float:
-        layout.type = VariableType::kFloat;
-        break;
-    case spirv_cross::SPIRType::BaseType::Int:
-        layout.type = VariableType::kInt;
-        break;
-    case spirv_cross::SPIRType::BaseType::UInt:
-        layout.type = VariableType::kUint;
-        break;
-    case spirv_cross::SPIRType::BaseType::Boolean:
-        layout.type = VariableType::kBool;
-        break;
-    default:
-        NOTREACHED();
-    }
+    layout.type = GetVariableType(type);
     return layout;
 }
 
@@ -339,14 +363,14 @@ VariableLayout GetBufferLayout(ViewType view_type,
 }
 
 void ParseBindings(const spirv_cross::CompilerHLSL& compiler,
+                   const spirv_cross::ShaderResources& resources,
                    std::vector<ResourceBindingDesc>& bindings,
-                   std::vector<VariableLayout>& layouts)
+                   std::vector<spirv_cross::Resource>& binding_resources)
 {
-    spirv_cross::ShaderResources resources = compiler.get_shader_resources();
     auto enumerate_resources = [&](const spirv_cross::SmallVector<spirv_cross::Resource>& resources) {
         for (const auto& resource : resources) {
             bindings.emplace_back(GetBindingDesc(compiler, resource));
-            layouts.emplace_back(GetBufferLayout(bindings.back().type, compiler, resource));
+            binding_resources.emplace_back(resource);
         }
     };
     enumerate_resources(resources.uniform_buffers);
@@ -380,19 +404,21 @@ BindKey GetBindKey(ShaderType shader_type, const spirv_cross::Compiler& compiler
 }
 
 SPIRVReflection::SPIRVReflection(const void* data, size_t size)
-    : blob_((const uint32_t*)data, (const uint32_t*)data + size / sizeof(uint32_t))
+    : compiler_(std::make_unique<spirv_cross::CompilerHLSL>(
+          std::vector<uint32_t>((const uint32_t*)data, (const uint32_t*)data + size / sizeof(uint32_t))))
 {
-    spirv_cross::CompilerHLSL compiler(blob_);
-    auto entry_points = compiler.get_entry_points_and_stages();
+    auto entry_points = compiler_->get_entry_points_and_stages();
     for (const auto& entry_point : entry_points) {
         entry_points_.push_back({ entry_point.name.c_str(), ConvertShaderKind(entry_point.execution_model) });
     }
-    ParseBindings(compiler, bindings_, layouts_);
-    input_parameters_ = ParseInputParameters(compiler);
-    output_parameters_ = ParseOutputParameters(compiler);
-
+    // get_shader_resources() walks every variable in the module, so it is only done once.
+    spirv_cross::ShaderResources resources = compiler_->get_shader_resources();
+    ParseBindings(*compiler_, resources, bindings_, binding_resources_);
+    input_parameters_ = ParseInputParameters(*compiler_, resources);
+    output_parameters_ = ParseOutputParameters(*compiler_, resources);
+    specialization_constants_ = ParseSpecializationConstants(*compiler_);
     for (uint32_t i = 0; i < shader_feature_info_.numthreads.size(); ++i) {
-        shader_feature_info_.numthreads[i] = compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, i);
+        shader_feature_info_.numthreads[i] = compiler_->get_execution_mode_argument(spv::ExecutionModeLocalSize, i);
     }
 }
 
@@ -408,6 +434,15 @@ const std::vector<ResourceBindingDesc>& SPIRVReflection::GetBindings() const
 
 const std::vector<VariableLayout>& SPIRVReflection::GetVariableLayouts() const
 {
+    std::call_once(layouts_once_, [&] {
+        layouts_.reserve(bindings_.size());
+        for (size_t i = 0; i < bindings_.size(); ++i) {
+            layouts_.emplace_back(GetBufferLayout(bindings_[i].type, *compiler_, binding_resources_[i]));
+        }
+        // Nothing else needs the parsed module, so do not keep it for the lifetime of the shader.
+        compiler_.reset();
+        binding_resources_ = {};
+    });
     return layouts_;
 }
 
@@ -425,3 +460,8 @@ const ShaderFeatureInfo& SPIRVReflection::GetShaderFeatureInfo() const
 {
     return shader_feature_info_;
 }
+
+const std::vector<SpecializationConstantDesc>& SPIRVReflection::GetSpecializationConstants() const
+{
+    return specialization_constants_;
+}
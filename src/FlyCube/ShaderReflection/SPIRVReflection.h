@@ -3,6 +3,8 @@
 
 #include <spirv_hlsl.hpp>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -19,13 +21,18 @@ public:
     const std::vector<InputParameterDesc>& GetInputParameters() const override;
     const std::vector<OutputParameterDesc>& GetOutputParameters() const override;
     const ShaderFeatureInfo& GetShaderFeatureInfo() const override;
+    const std::vector<SpecializationConstantDesc>& GetSpecializationConstants() const override;
 
 private:
-    std::vector<uint32_t> blob_;
+    // Kept alive only until the variable layouts are computed on first access.
+    mutable std::unique_ptr<spirv_cross::CompilerHLSL> compiler_;
     std::vector<EntryPoint> entry_points_;
     std::vector<ResourceBindingDesc> bindings_;
-    std::vector<VariableLayout> layouts_;
+    mutable std::vector<spirv_cross::Resource> binding_resources_;
     std::vector<InputParameterDesc> input_parameters_;
     std::vector<OutputParameterDesc> output_parameters_;
+    std::vector<SpecializationConstantDesc> specialization_constants_;
+    mutable std::once_flag layouts_once_;
+    mutable std::vector<VariableLayout> layouts_;
     ShaderFeatureInfo shader_feature_info_ = {};
 };
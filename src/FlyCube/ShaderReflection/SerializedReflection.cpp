@@ -0,0 +1,228 @@
+#include "ShaderReflection/SerializedReflection.h"
+
+#include "Utilities/BinaryStream.h"
+
+namespace {
+
+constexpr uint32_t kReflectionMagic = 0x52534346; // "FCSR"
+constexpr uint32_t kReflectionVersion = 2;
+// Guards against unbounded recursion on corrupted data.
+constexpr uint32_t kMaxVariableLayoutDepth = 64;
+
+template <typename T>
+bool ReadEnum(BinaryReader& reader, T& value)
+{
+    uint32_t raw = 0;
+    if (!reader.Read(raw)) {
+        return false;
+    }
+    value = static_cast<T>(raw);
+    return true;
+}
+
+template <typename T>
+void WriteEnum(BinaryWriter& writer, T value)
+{
+    writer.Write(static_cast<uint32_t>(value));
+}
+
+void WriteVariableLayouts(BinaryWriter& writer, const std::vector<VariableLayout>& layouts)
+{
+    writer.Write<uint64_t>(layouts.size());
+    for (const auto& layout : layouts) {
+        writer.WriteArray(layout.name);
+        WriteEnum(writer, layout.type);
+        writer.Write(layout.offset);
+        writer.Write(layout.size);
+        writer.Write(layout.rows);
+        writer.Write(layout.columns);
+        writer.Write(layout.elements);
+        WriteVariableLayouts(writer, layout.members);
+    }
+}
+
+bool ReadVariableLayouts(BinaryReader& reader, std::vector<VariableLayout>& layouts, uint32_t depth)
+{
+    uint64_t count = 0;
+    if (depth > kMaxVariableLayoutDepth || !reader.Read(count)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        VariableLayout& layout = layouts.emplace_back();
+        if (!reader.ReadArray(layout.name) || !ReadEnum(reader, layout.type) || !reader.Read(layout.offset) ||
+            !reader.Read(layout.size) || !reader.Read(layout.rows) || !reader.Read(layout.columns) ||
+            !reader.Read(layout.elements) || !ReadVariableLayouts(reader, layout.members, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::shared_ptr<SerializedReflection> SerializedReflection::Deserialize(std::span<const uint8_t> data)
+{
+    BinaryReader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!reader.Read(magic) || magic != kReflectionMagic || !reader.Read(version) || version != kReflectionVersion) {
+        return {};
+    }
+
+    std::shared_ptr<SerializedReflection> reflection(new SerializedReflection());
+    uint64_t count = 0;
+    if (!reader.Read(count)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        EntryPoint& entry_point = reflection->entry_points_.emplace_back();
+        if (!reader.ReadArray(entry_point.name) || !ReadEnum(reader, entry_point.kind) ||
+            !reader.Read(entry_point.payload_size) || !reader.Read(entry_point.attribute_size)) {
+            return {};
+        }
+    }
+
+    if (!reader.Read(count)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        ResourceBindingDesc& binding = reflection->bindings_.emplace_back();
+        if (!reader.ReadArray(binding.name) || !ReadEnum(reader, binding.type) || !reader.Read(binding.slot) ||
+            !reader.Read(binding.space) || !reader.Read(binding.count) || !ReadEnum(reader, binding.dimension) ||
+            !ReadEnum(reader, binding.return_type) || !reader.Read(binding.structure_stride)) {
+            return {};
+        }
+    }
+
+    if (!ReadVariableLayouts(reader, reflection->layouts_, 0) || !reader.Read(count)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        InputParameterDesc& input_parameter = reflection->input_parameters_.emplace_back();
+        if (!reader.Read(input_parameter.location) || !reader.ReadArray(input_parameter.semantic_name) ||
+            !ReadEnum(reader, input_parameter.format)) {
+            return {};
+        }
+    }
+
+    if (!reader.Read(count)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!reader.Read(reflection->output_parameters_.emplace_back().slot)) {
+            return {};
+        }
+    }
+
+    ShaderFeatureInfo& info = reflection->shader_feature_info_;
+    uint8_t resource_descriptor_heap_indexing = 0;
+    uint8_t sampler_descriptor_heap_indexing = 0;
+    if (!reader.Read(resource_descriptor_heap_indexing) || !reader.Read(sampler_descriptor_heap_indexing) ||
+        !reader.Read(info.numthreads)) {
+        return {};
+    }
+    info.resource_descriptor_heap_indexing = resource_descriptor_heap_indexing;
+    info.sampler_descriptor_heap_indexing = sampler_descriptor_heap_indexing;
+
+    if (!reader.Read(count)) {
+        return {};
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        SpecializationConstantDesc& specialization_constant = reflection->specialization_constants_.emplace_back();
+        if (!reader.ReadArray(specialization_constant.name) || !reader.Read(specialization_constant.id) ||
+            !ReadEnum(reader, specialization_constant.type) || !reader.Read(specialization_constant.default_value)) {
+            return {};
+        }
+    }
+    return reflection;
+}
+
+const std::vector<EntryPoint>& SerializedReflection::GetEntryPoints() const
+{
+    return entry_points_;
+}
+
+const std::vector<ResourceBindingDesc>& SerializedReflection::GetBindings() const
+{
+    return bindings_;
+}
+
+const std::vector<VariableLayout>& SerializedReflection::GetVariableLayouts() const
+{
+    return layouts_;
+}
+
+const std::vector<InputParameterDesc>& SerializedReflection::GetInputParameters() const
+{
+    return input_parameters_;
+}
+
+const std::vector<OutputParameterDesc>& SerializedReflection::GetOutputParameters() const
+{
+    return output_parameters_;
+}
+
+const ShaderFeatureInfo& SerializedReflection::GetShaderFeatureInfo() const
+{
+    return shader_feature_info_;
+}
+
+const std::vector<SpecializationConstantDesc>& SerializedReflection::GetSpecializationConstants() const
+{
+    return specialization_constants_;
+}
+
+std::vector<uint8_t> SerializeShaderReflection(const ShaderReflection& reflection)
+{
+    BinaryWriter writer;
+    writer.Write(kReflectionMagic);
+    writer.Write(kReflectionVersion);
+
+    writer.Write<uint64_t>(reflection.GetEntryPoints().size());
+    for (const auto& entry_point : reflection.GetEntryPoints()) {
+        writer.WriteArray(entry_point.name);
+        WriteEnum(writer, entry_point.kind);
+        writer.Write(entry_point.payload_size);
+        writer.Write(entry_point.attribute_size);
+    }
+
+    writer.Write<uint64_t>(reflection.GetBindings().size());
+    for (const auto& binding : reflection.GetBindings()) {
+        writer.WriteArray(binding.name);
+        WriteEnum(writer, binding.type);
+        writer.Write(binding.slot);
+        writer.Write(binding.space);
+        writer.Write(binding.count);
+        WriteEnum(writer, binding.dimension);
+        WriteEnum(writer, binding.return_type);
+        writer.Write(binding.structure_stride);
+    }
+
+    WriteVariableLayouts(writer, reflection.GetVariableLayouts());
+
+    writer.Write<uint64_t>(reflection.GetInputParameters().size());
+    for (const auto& input_parameter : reflection.GetInputParameters()) {
+        writer.Write(input_parameter.location);
+        writer.WriteArray(input_parameter.semantic_name);
+        WriteEnum(writer, input_parameter.format);
+    }
+
+    writer.Write<uint64_t>(reflection.GetOutputParameters().size());
+    for (const auto& output_parameter : reflection.GetOutputParameters()) {
+        writer.Write(output_parameter.slot);
+    }
+
+    const ShaderFeatureInfo& info = reflection.GetShaderFeatureInfo();
+    writer.Write<uint8_t>(info.resource_descriptor_heap_indexing);
+    writer.Write<uint8_t>(info.sampler_descriptor_heap_indexing);
+    writer.Write(info.numthreads);
+
+    writer.Write<uint64_t>(reflection.GetSpecializationConstants().size());
+    for (const auto& specialization_constant : reflection.GetSpecializationConstants()) {
+        writer.WriteArray(specialization_constant.name);
+        writer.Write(specialization_constant.id);
+        WriteEnum(writer, specialization_constant.type);
+        writer.Write(specialization_constant.default_value);
+    }
+    return writer.GetData();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "ShaderReflection/ShaderReflection.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Reflection restored from SerializeShaderReflection output, used for precompiled shader bundles.
+class SerializedReflection : public ShaderReflection {
+public:
+    static std::shared_ptr<SerializedReflection> Deserialize(std::span<const uint8_t> data);
+
+    const std::vector<EntryPoint>& GetEntryPoints() const override;
+    const std::vector<ResourceBindingDesc>& GetBindings() const override;
+    const std::vector<VariableLayout>& GetVariableLayouts() const override;
+    const std::vector<InputParameterDesc>& GetInputParameters() const override;
+    const std::vector<OutputParameterDesc>& GetOutputParameters() const override;
+    const ShaderFeatureInfo& GetShaderFeatureInfo() const override;
+    const std::vector<SpecializationConstantDesc>& GetSpecializationConstants() const override;
+
+private:
+    std::vector<EntryPoint> entry_points_;
+    std::vector<ResourceBindingDesc> bindings_;
+    std::vector<VariableLayout> layouts_;
+    std::vector<InputParameterDesc> input_parameters_;
+    std::vector<OutputParameterDesc> output_parameters_;
+    ShaderFeatureInfo shader_feature_info_ = {};
+    std::vector<SpecializationConstantDesc> specialization_constants_;
+};
+
+std::vector<uint8_t> SerializeShaderReflection(const ShaderReflection& reflection);
@@ -3,9 +3,11 @@
 #include "ShaderReflection/DXILReflection.h"
 #include "ShaderReflection/SPIRVReflection.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/Trace.h"
 
 std::shared_ptr<ShaderReflection> CreateShaderReflection(ShaderBlobType type, const void* data, size_t size)
 {
+    TRACE_SCOPE("CreateShaderReflection");
     switch (type) {
     case ShaderBlobType::kDXIL:
         return std::make_shared<DXILReflection>(data, size);
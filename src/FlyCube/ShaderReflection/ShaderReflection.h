@@ -59,6 +59,13 @@ struct VariableLayout {
     std::vector<VariableLayout> members;
 };
 
+struct SpecializationConstantDesc {
+    std::string name;
+    uint32_t id;
+    VariableType type;
+    uint32_t default_value;
+};
+
 struct ShaderFeatureInfo {
     bool resource_descriptor_heap_indexing = false;
     bool sampler_descriptor_heap_indexing = false;
@@ -74,6 +81,8 @@ public:
     virtual const std::vector<InputParameterDesc>& GetInputParameters() const = 0;
     virtual const std::vector<OutputParameterDesc>& GetOutputParameters() const = 0;
     virtual const ShaderFeatureInfo& GetShaderFeatureInfo() const = 0;
+    // Declared with [[vk::constant_id]], only SPIR-V has them.
+    virtual const std::vector<SpecializationConstantDesc>& GetSpecializationConstants() const = 0;
 };
 
 std::shared_ptr<ShaderReflection> CreateShaderReflection(ShaderBlobType type, const void* data, size_t size);
@@ -0,0 +1,29 @@
+#include "GeneratedBindingHeader.h"
+
+#include "DepthStencilRead/VertexShader.hlsl.h"
+
+namespace GeneratedShader = Shaders::DepthStencilRead_VertexShader_hlsl;
+
+static_assert(GeneratedShader::kShaderType == ShaderType::kVertex);
+static_assert(GeneratedShader::BindKeys::constant_buffer ==
+              BindKey{ ShaderType::kVertex, ViewType::kConstantBuffer, 0, 0, 1 });
+static_assert(sizeof(GeneratedShader::Layouts::constant_buffer) == sizeof(glm::mat4));
+static_assert(offsetof(GeneratedShader::Layouts::constant_buffer, mvp) == 0);
+
+BindKey GetGeneratedConstantBufferBindKey()
+{
+    return GeneratedShader::BindKeys::constant_buffer;
+}
+
+std::map<std::string, uint32_t> GetGeneratedInputLocations()
+{
+    return {
+        { "POSITION", GeneratedShader::InputLocations::POSITION },
+        { "TEXCOORD", GeneratedShader::InputLocations::TEXCOORD },
+    };
+}
+
+size_t GetGeneratedConstantBufferSize()
+{
+    return sizeof(GeneratedShader::Layouts::constant_buffer);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Values taken from the header ShaderCompilerCLI --header generated for DepthStencilRead/VertexShader.hlsl during the
+// build, compared against the runtime reflection by BindingHeaderTest.
+BindKey GetGeneratedConstantBufferBindKey();
+std::map<std::string, uint32_t> GetGeneratedInputLocations();
+size_t GetGeneratedConstantBufferSize();
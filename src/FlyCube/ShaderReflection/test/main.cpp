@@ -1,8 +1,19 @@
+#include "GeneratedBindingHeader.h"
 #include "HLSLCompiler/Compiler.h"
+#include "Shader/ShaderBundle.h"
+#include "ShaderReflection/BindingHeader.h"
+#include "ShaderReflection/SerializedReflection.h"
 #include "ShaderReflection/ShaderReflection.h"
+#include "Utilities/Logging.h"
 
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <filesystem>
+
 namespace {
 
 std::shared_ptr<ShaderReflection> CompileAndCreateShaderReflection(const ShaderDesc& desc,
@@ -21,6 +32,31 @@ inline auto MakePartialTie(const EntryPoint& self)
     return std::tie(self.name, self.kind);
 }
 
+inline auto MakeTie(const ResourceBindingDesc& self)
+{
+    return std::tie(self.name, self.type, self.slot, self.space, self.count, self.dimension, self.return_type,
+                    self.structure_stride);
+}
+
+inline auto MakeTie(const InputParameterDesc& self)
+{
+    return std::tie(self.location, self.semantic_name, self.format);
+}
+
+inline auto MakeTie(const VariableLayout& self)
+{
+    return std::tie(self.name, self.type, self.offset, self.size, self.rows, self.columns, self.elements);
+}
+
+void RequireEqualLayouts(const std::vector<VariableLayout>& lhs, const std::vector<VariableLayout>& rhs)
+{
+    REQUIRE(lhs.size() == rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        REQUIRE(MakeTie(lhs[i]) == MakeTie(rhs[i]));
+        RequireEqualLayouts(lhs[i].members, rhs[i].members);
+    }
+}
+
 } // namespace
 
 inline bool operator==(const EntryPoint& lhs, const EntryPoint& rhs)
@@ -65,7 +101,7 @@ TEST_CASE("Triangle/PixelShader.hlsl")
     auto entry_points = reflection->GetEntryPoints();
     REQUIRE(entry_points == expect);
 
-    auto bindings = reflection->GetBindings();
+    const auto& bindings = reflection->GetBindings();
     REQUIRE(bindings.size() == 1);
     REQUIRE(bindings.front().name == "constant_buffer");
 }
@@ -105,3 +141,235 @@ TEST_CASE("BasicShaderReflectionTest")
         }
     }
 }
+
+TEST_CASE("ShaderCompileProfileReflectionTest")
+{
+    std::vector<ShaderDesc> shader_descs = {
+        { ASSETS_PATH "shaders/BindlessTriangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { ASSETS_PATH "shaders/BindlessTriangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/RayTracingTriangle/RayTracing.hlsl", "", ShaderType::kLibrary, "6_3" },
+        { ASSETS_PATH "shaders/MeshTriangle/MeshShader.hlsl", "main", ShaderType::kMesh, "6_5" },
+        { ASSETS_PATH "shaders/Triangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/DispatchIndirect/ComputeShader.hlsl", "main", ShaderType::kCompute, "6_0" },
+    };
+    for (const auto& shader_desc : shader_descs) {
+        auto test_name = shader_desc.shader_path.substr(std::string_view{ ASSETS_PATH "shaders/" }.size());
+        DYNAMIC_SECTION(test_name)
+        {
+            auto blob_type = GENERATE(ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV);
+            auto profile = GENERATE(ShaderCompileProfile::kRelease, ShaderCompileProfile::kSize);
+            auto debug_reflection = CompileAndCreateShaderReflection(shader_desc, blob_type);
+            ShaderDesc profile_desc = shader_desc;
+            profile_desc.profile = profile;
+            auto reflection = CompileAndCreateShaderReflection(profile_desc, blob_type);
+
+            const auto& debug_bindings = debug_reflection->GetBindings();
+            const auto& bindings = reflection->GetBindings();
+            REQUIRE(bindings.size() == debug_bindings.size());
+            for (size_t i = 0; i < bindings.size(); ++i) {
+                REQUIRE(MakeTie(bindings[i]) == MakeTie(debug_bindings[i]));
+            }
+
+            const auto& debug_inputs = debug_reflection->GetInputParameters();
+            const auto& inputs = reflection->GetInputParameters();
+            REQUIRE(inputs.size() == debug_inputs.size());
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                REQUIRE(MakeTie(inputs[i]) == MakeTie(debug_inputs[i]));
+            }
+            REQUIRE(reflection->GetEntryPoints() == debug_reflection->GetEntryPoints());
+        }
+    }
+}
+
+TEST_CASE("ShaderBundleReflectionTest")
+{
+    std::vector<ShaderDesc> shader_descs = {
+        { ASSETS_PATH "shaders/BindlessTriangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { ASSETS_PATH "shaders/RayTracingTriangle/RayTracing.hlsl", "", ShaderType::kLibrary, "6_3" },
+        { ASSETS_PATH "shaders/MeshTriangle/MeshShader.hlsl", "main", ShaderType::kMesh, "6_5" },
+        { ASSETS_PATH "shaders/Triangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/DispatchIndirect/ComputeShader.hlsl", "main", ShaderType::kCompute, "6_0" },
+    };
+    const auto blob_types = { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV };
+    ShaderBundleWriter writer;
+    for (const auto& shader_desc : shader_descs) {
+        for (auto blob_type : blob_types) {
+            auto blob = Compile(shader_desc, blob_type);
+            REQUIRE(!blob.empty());
+            writer.AddShader(shader_desc.shader_path, shader_desc.type, blob_type, blob);
+        }
+    }
+    auto path = (std::filesystem::temp_directory_path() / "FlyCubeShaderBundleTest.bin").string();
+    REQUIRE(writer.Save(path));
+    auto bundle = ShaderBundle::Open(path);
+    REQUIRE(bundle);
+
+    for (const auto& shader_desc : shader_descs) {
+        for (auto blob_type : blob_types) {
+            CAPTURE(shader_desc.shader_path, blob_type);
+            auto shader = bundle->GetShader(shader_desc.shader_path, blob_type);
+            REQUIRE(shader);
+            REQUIRE(shader->type == shader_desc.type);
+            REQUIRE(reinterpret_cast<uintptr_t>(shader->blob.data()) % sizeof(uint32_t) == 0);
+            auto reflection = CreateShaderReflection(blob_type, shader->blob.data(), shader->blob.size());
+
+            REQUIRE(shader->reflection->GetEntryPoints() == reflection->GetEntryPoints());
+            const auto& bindings = shader->reflection->GetBindings();
+            REQUIRE(bindings.size() == reflection->GetBindings().size());
+            for (size_t i = 0; i < bindings.size(); ++i) {
+                REQUIRE(MakeTie(bindings[i]) == MakeTie(reflection->GetBindings()[i]));
+            }
+            const auto& inputs = shader->reflection->GetInputParameters();
+            REQUIRE(inputs.size() == reflection->GetInputParameters().size());
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                REQUIRE(MakeTie(inputs[i]) == MakeTie(reflection->GetInputParameters()[i]));
+            }
+            RequireEqualLayouts(shader->reflection->GetVariableLayouts(), reflection->GetVariableLayouts());
+            REQUIRE(shader->reflection->GetOutputParameters().size() == reflection->GetOutputParameters().size());
+            REQUIRE(shader->reflection->GetShaderFeatureInfo().numthreads ==
+                    reflection->GetShaderFeatureInfo().numthreads);
+        }
+    }
+    REQUIRE(!bundle->GetShader("missing", ShaderBlobType::kSPIRV));
+    bundle.reset();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("BindingHeaderTest")
+{
+    ShaderDesc desc = { ASSETS_PATH "shaders/DepthStencilRead/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" };
+    auto reflection = CompileAndCreateShaderReflection(desc, ShaderBlobType::kSPIRV);
+    auto header = GenerateBindingHeader("DepthStencilRead/VertexShader.hlsl", desc.type, *reflection);
+    CAPTURE(header);
+
+    auto contains = [&](std::string_view str) { return header.find(str) != std::string::npos; };
+    REQUIRE(contains("namespace Shaders::DepthStencilRead_VertexShader_hlsl {"));
+    REQUIRE(contains("inline constexpr BindKey constant_buffer = "
+                     "{ ShaderType::kVertex, ViewType::kConstantBuffer, 0, 0, 1 };"));
+    for (const auto& input_parameter : reflection->GetInputParameters()) {
+        REQUIRE(contains(std::format("inline constexpr uint32_t {} = {};", input_parameter.semantic_name,
+                                     input_parameter.location)));
+    }
+    REQUIRE(contains("    glm::mat4 mvp;\n"));
+    REQUIRE(contains("static_assert(offsetof(constant_buffer, mvp) == 0);"));
+    REQUIRE(contains("static_assert(sizeof(constant_buffer) == 64);"));
+}
+
+TEST_CASE("GeneratedBindingHeaderTest")
+{
+    // GeneratedBindingHeader.cpp includes the header ShaderCompilerCLI generated during the build.
+    ShaderDesc desc = { ASSETS_PATH "shaders/DepthStencilRead/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" };
+    auto reflection = CompileAndCreateShaderReflection(desc, ShaderBlobType::kSPIRV);
+    const auto& bindings = reflection->GetBindings();
+    REQUIRE(bindings.size() == 1);
+    const auto& binding = bindings.front();
+    BindKey bind_key = { ShaderType::kVertex, binding.type, binding.slot, binding.space, binding.count };
+    REQUIRE(GetGeneratedConstantBufferBindKey() == bind_key);
+
+    auto input_locations = GetGeneratedInputLocations();
+    for (const auto& input_parameter : reflection->GetInputParameters()) {
+        REQUIRE(input_locations[input_parameter.semantic_name] == input_parameter.location);
+    }
+
+    const auto& layouts = reflection->GetVariableLayouts();
+    auto layout = std::find_if(layouts.begin(), layouts.end(),
+                               [](const VariableLayout& variable) { return variable.name == "constant_buffer"; });
+    REQUIRE(layout != layouts.end());
+    REQUIRE(GetGeneratedConstantBufferSize() == layout->size);
+}
+
+TEST_CASE("SpecializationConstantReflectionTest")
+{
+    ShaderDesc desc = {
+        ASSETS_PATH "shaders/SpecializationConstants/ComputeShader.hlsl", "main", ShaderType::kCompute, "6_0"
+    };
+    auto reflection = CompileAndCreateShaderReflection(desc, ShaderBlobType::kSPIRV);
+    auto specialization_constants = reflection->GetSpecializationConstants();
+    std::sort(specialization_constants.begin(), specialization_constants.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.id < rhs.id; });
+    // The 64-bit constant is skipped.
+    REQUIRE(specialization_constants.size() == 3);
+    REQUIRE(specialization_constants[0].name == "tile_size");
+    REQUIRE(specialization_constants[0].type == VariableType::kUint);
+    REQUIRE(specialization_constants[0].default_value == 8);
+    REQUIRE(specialization_constants[1].name == "use_scale");
+    REQUIRE(specialization_constants[1].type == VariableType::kBool);
+    REQUIRE(specialization_constants[1].default_value == 0);
+    REQUIRE(specialization_constants[2].name == "scale");
+    REQUIRE(specialization_constants[2].type == VariableType::kFloat);
+    REQUIRE(specialization_constants[2].default_value == std::bit_cast<uint32_t>(2.0f));
+
+    auto serialized = SerializedReflection::Deserialize(SerializeShaderReflection(*reflection));
+    REQUIRE(serialized);
+    const auto& serialized_constants = serialized->GetSpecializationConstants();
+    REQUIRE(serialized_constants.size() == reflection->GetSpecializationConstants().size());
+    for (size_t i = 0; i < serialized_constants.size(); ++i) {
+        const auto& expect = reflection->GetSpecializationConstants()[i];
+        REQUIRE(serialized_constants[i].name == expect.name);
+        REQUIRE(serialized_constants[i].id == expect.id);
+        REQUIRE(serialized_constants[i].type == expect.type);
+        REQUIRE(serialized_constants[i].default_value == expect.default_value);
+    }
+}
+
+TEST_CASE("ShaderReflectionBenchmark", "[.benchmark]")
+{
+    constexpr size_t kIterations = 200;
+    std::vector<ShaderDesc> shader_descs = {
+        { ASSETS_PATH "shaders/BindlessTriangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { ASSETS_PATH "shaders/BindlessTriangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/RayTracingTriangle/RayTracing.hlsl", "", ShaderType::kLibrary, "6_3" },
+        { ASSETS_PATH "shaders/RayTracingTriangle/RayTracingCallable.hlsl", "", ShaderType::kLibrary, "6_3" },
+        { ASSETS_PATH "shaders/RayTracingTriangle/RayTracingHit.hlsl", "", ShaderType::kLibrary, "6_3" },
+        { ASSETS_PATH "shaders/MeshTriangle/MeshShader.hlsl", "main", ShaderType::kMesh, "6_5" },
+        { ASSETS_PATH "shaders/MeshTriangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_5" },
+        { ASSETS_PATH "shaders/Triangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { ASSETS_PATH "shaders/Triangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/DispatchIndirect/ComputeShader.hlsl", "main", ShaderType::kCompute, "6_0" },
+    };
+
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        std::vector<std::vector<uint8_t>> blobs;
+        std::vector<std::vector<uint8_t>> serialized;
+        for (const auto& desc : shader_descs) {
+            blobs.push_back(Compile(desc, blob_type));
+            REQUIRE(!blobs.back().empty());
+            auto reflection = CreateShaderReflection(blob_type, blobs.back().data(), blobs.back().size());
+            serialized.push_back(SerializeShaderReflection(*reflection));
+        }
+
+        // Shader creation only needs entry points, bindings and input parameters.
+        auto measure = [&](bool full) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < kIterations; ++i) {
+                for (const auto& blob : blobs) {
+                    auto reflection = CreateShaderReflection(blob_type, blob.data(), blob.size());
+                    REQUIRE(!reflection->GetEntryPoints().empty());
+                    reflection->GetBindings();
+                    reflection->GetInputParameters();
+                    if (full) {
+                        reflection->GetVariableLayouts();
+                        reflection->GetShaderFeatureInfo();
+                    }
+                }
+            }
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count() / (kIterations * blobs.size());
+        };
+        double creation_time = measure(false);
+        double full_time = measure(true);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kIterations; ++i) {
+            for (const auto& data : serialized) {
+                REQUIRE(SerializedReflection::Deserialize(data));
+            }
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        double serialized_time = elapsed.count() / (kIterations * serialized.size());
+
+        Logging::Println("{}: shader creation {:.3f} ms, full reflection {:.3f} ms, serialized {:.3f} ms per shader",
+                         blob_type == ShaderBlobType::kDXIL ? "DXIL" : "SPIR-V", creation_time, full_time,
+                         serialized_time);
+    }
+}
@@ -1,5 +1,8 @@
 #include "Utilities/Asset.h"
 
+#if defined(__APPLE__) && !defined(USE_METAL_SHADER_CONVERTER)
+#include "HLSLCompiler/MSLConverter.h"
+#endif
 #include "Utilities/NotReached.h"
 #include "Utilities/SystemUtils.h"
 
@@ -99,9 +102,26 @@ std::vector<uint8_t> AssetLoadBinaryFile(const std::string& filepath)
 
 std::vector<uint8_t> AssetLoadShaderBlob(const std::string& filepath, ShaderBlobType blob_type)
 {
+#if defined(__APPLE__) && !defined(USE_METAL_SHADER_CONVERTER)
+    // Offline MSL generated by ShaderCompilerCLI lets MTShader skip spirv-cross for this blob.
+    if (blob_type == ShaderBlobType::kSPIRV && AssetFileExists(filepath + ".msl")) {
+        auto blob = AssetLoadBinaryFile(filepath + GetShaderBlobExt(blob_type));
+        RegisterMSLShader(AssetLoadBinaryFile(filepath + ".msl"), blob);
+        return blob;
+    }
+#endif
     return AssetLoadBinaryFile(filepath + GetShaderBlobExt(blob_type));
 }
 
+std::shared_ptr<ShaderBundle> AssetLoadShaderBundle(const std::string& filepath)
+{
+#if defined(__ANDROID__)
+    return ShaderBundle::Create(AssetLoadBinaryFile(filepath));
+#else
+    return ShaderBundle::Open(GetAssetPath(filepath));
+#endif
+}
+
 #if defined(__ANDROID__)
 void SetAAssetManager(AAssetManager* mgr)
 {
@@ -1,14 +1,17 @@
 #pragma once
 
 #include "Instance/BaseTypes.h"
+#include "Shader/ShaderBundle.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 bool AssetFileExists(const std::string& filepath);
 std::vector<uint8_t> AssetLoadBinaryFile(const std::string& filepath);
 std::vector<uint8_t> AssetLoadShaderBlob(const std::string& filepath, ShaderBlobType blob_type);
+std::shared_ptr<ShaderBundle> AssetLoadShaderBundle(const std::string& filepath);
 
 #if defined(__ANDROID__)
 struct AAssetManager;
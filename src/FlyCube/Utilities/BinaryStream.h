@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::span<const uint8_t> data)
+        : data_(data)
+    {
+    }
+
+    template <typename T>
+    bool Read(T& value)
+    {
+        if (sizeof(T) > data_.size() - offset_) {
+            return false;
+        }
+        std::memcpy(&value, data_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+
+    template <typename Container>
+    bool ReadArray(Container& container)
+    {
+        uint64_t size = 0;
+        if (!Read(size) || size > data_.size() - offset_) {
+            return false;
+        }
+        container.assign(data_.begin() + offset_, data_.begin() + offset_ + size);
+        offset_ += size;
+        return true;
+    }
+
+    // Returns a view into the underlying data instead of copying it.
+    bool ReadSpan(std::span<const uint8_t>& span)
+    {
+        uint64_t size = 0;
+        if (!Read(size) || size > data_.size() - offset_) {
+            return false;
+        }
+        span = data_.subspan(offset_, size);
+        offset_ += size;
+        return true;
+    }
+
+private:
+    std::span<const uint8_t> data_;
+    size_t offset_ = 0;
+};
+
+class BinaryWriter {
+public:
+    template <typename T>
+    void Write(const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        data_.insert(data_.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename Container>
+    void WriteArray(const Container& container)
+    {
+        Write<uint64_t>(container.size());
+        data_.insert(data_.end(), container.begin(), container.end());
+    }
+
+    const std::vector<uint8_t>& GetData() const
+    {
+        return data_;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+};
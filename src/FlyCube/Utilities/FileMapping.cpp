@@ -0,0 +1,87 @@
+#include "Utilities/FileMapping.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <nowide/convert.hpp>
+
+std::shared_ptr<FileMapping> FileMapping::Open(const std::string& path)
+{
+    std::shared_ptr<FileMapping> mapping(new FileMapping());
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(nowide::widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return {};
+    }
+    mapping->file_ = file;
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size)) {
+        return {};
+    }
+    mapping->size_ = size.QuadPart;
+    if (mapping->size_ == 0) {
+        return mapping;
+    }
+    mapping->mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping->mapping_) {
+        return {};
+    }
+    mapping->data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping->mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!mapping->data_) {
+        return {};
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return {};
+    }
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) == -1) {
+        close(fd);
+        return {};
+    }
+    mapping->size_ = file_stat.st_size;
+    if (mapping->size_ == 0) {
+        close(fd);
+        return mapping;
+    }
+    void* data = mmap(nullptr, mapping->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return {};
+    }
+    mapping->data_ = static_cast<const uint8_t*>(data);
+#endif
+    return mapping;
+}
+
+FileMapping::~FileMapping()
+{
+#if defined(_WIN32)
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+    }
+    if (file_) {
+        CloseHandle(file_);
+    }
+#else
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+}
+
+std::span<const uint8_t> FileMapping::GetData() const
+{
+    return { data_, size_ };
+}
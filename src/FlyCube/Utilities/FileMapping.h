@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+// Read-only view of a whole file, backed by mmap/MapViewOfFile.
+class FileMapping {
+public:
+    static std::shared_ptr<FileMapping> Open(const std::string& path);
+    ~FileMapping();
+
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator=(const FileMapping&) = delete;
+
+    std::span<const uint8_t> GetData() const;
+
+private:
+    FileMapping() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
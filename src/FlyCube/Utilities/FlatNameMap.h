@@ -0,0 +1,102 @@
+#pragma once
+#include "Utilities/Check.h"
+#include "Utilities/InternedName.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Open addressing hash map keyed by InternedName, entries are stored contiguously in insertion order.
+template <typename T>
+class FlatNameMap {
+public:
+    void Insert(InternedName name, T value)
+    {
+        if (T* existing = Find(name)) {
+            *existing = std::move(value);
+            return;
+        }
+        entries_.emplace_back(name, std::move(value));
+        if ((entries_.size() + 1) * 4 > slots_.size() * 3) {
+            Rehash(std::max<size_t>(slots_.size() * 2, 8));
+        } else {
+            Place(entries_.size() - 1);
+        }
+    }
+
+    T* Find(InternedName name)
+    {
+        return const_cast<T*>(std::as_const(*this).Find(name));
+    }
+
+    const T* Find(InternedName name) const
+    {
+        if (slots_.empty()) {
+            return nullptr;
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = name.GetHash() & mask;; slot = (slot + 1) & mask) {
+            uint32_t index = slots_[slot];
+            if (index == kEmptySlot) {
+                return nullptr;
+            }
+            if (entries_[index].first == name) {
+                return &entries_[index].second;
+            }
+        }
+    }
+
+    const T* Find(std::string_view name) const
+    {
+        auto interned_name = InternedName::Find(name);
+        if (!interned_name) {
+            return nullptr;
+        }
+        return Find(*interned_name);
+    }
+
+    const T& At(InternedName name) const
+    {
+        const T* value = Find(name);
+        CHECK(value, "{} is not found", name.GetString());
+        return *value;
+    }
+
+    const T& At(std::string_view name) const
+    {
+        const T* value = Find(name);
+        CHECK(value, "{} is not found", name);
+        return *value;
+    }
+
+    const std::vector<std::pair<InternedName, T>>& GetEntries() const
+    {
+        return entries_;
+    }
+
+private:
+    static constexpr uint32_t kEmptySlot = ~0u;
+
+    void Place(size_t index)
+    {
+        size_t mask = slots_.size() - 1;
+        size_t slot = entries_[index].first.GetHash() & mask;
+        while (slots_[slot] != kEmptySlot) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = static_cast<uint32_t>(index);
+    }
+
+    void Rehash(size_t slot_count)
+    {
+        slots_.assign(slot_count, kEmptySlot);
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            Place(i);
+        }
+    }
+
+    std::vector<std::pair<InternedName, T>> entries_;
+    std::vector<uint32_t> slots_;
+};
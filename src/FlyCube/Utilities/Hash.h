@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+constexpr uint64_t kFnv1aOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnv1aPrime = 1099511628211ull;
+
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = kFnv1aOffsetBasis)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= kFnv1aPrime;
+    }
+    return hash;
+}
+
+inline uint64_t HashString(std::string_view str, uint64_t seed = kFnv1aOffsetBasis)
+{
+    return HashBytes(str.data(), str.size(), seed);
+}
+
+inline uint64_t HashCombine(uint64_t seed, uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
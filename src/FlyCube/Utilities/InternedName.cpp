@@ -0,0 +1,77 @@
+#include "Utilities/InternedName.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace {
+
+struct NameHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view name) const
+    {
+        return std::hash<std::string_view>{}(name);
+    }
+};
+
+struct InternTable {
+    std::shared_mutex mutex;
+    // Node-based so that element addresses stay stable on rehash.
+    std::unordered_set<std::string, NameHash, std::equal_to<>> names;
+};
+
+InternTable& GetInternTable()
+{
+    static InternTable* table = new InternTable();
+    return *table;
+}
+
+} // namespace
+
+InternedName::InternedName(std::string_view name)
+{
+    InternTable& table = GetInternTable();
+    {
+        std::shared_lock lock(table.mutex);
+        auto it = table.names.find(name);
+        if (it != table.names.end()) {
+            name_ = &*it;
+            return;
+        }
+    }
+    std::unique_lock lock(table.mutex);
+    name_ = &*table.names.emplace(name).first;
+}
+
+InternedName::InternedName(const std::string* name)
+    : name_(name)
+{
+}
+
+std::optional<InternedName> InternedName::Find(std::string_view name)
+{
+    InternTable& table = GetInternTable();
+    std::shared_lock lock(table.mutex);
+    auto it = table.names.find(name);
+    if (it == table.names.end()) {
+        return {};
+    }
+    return InternedName(&*it);
+}
+
+const std::string& InternedName::GetString() const
+{
+    static const std::string empty;
+    return name_ ? *name_ : empty;
+}
+
+uint64_t InternedName::GetHash() const
+{
+    uint64_t value = reinterpret_cast<uintptr_t>(name_);
+    // Mixes the pointer bits, the low bits are always zero because of alignment.
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    return value;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Process-wide interned string, equal names share one instance so comparison and hashing are pointer based.
+class InternedName {
+public:
+    InternedName() = default;
+    explicit InternedName(std::string_view name);
+
+    // Does not intern, a name that was never interned cannot be a key of anything.
+    static std::optional<InternedName> Find(std::string_view name);
+
+    const std::string& GetString() const;
+    uint64_t GetHash() const;
+
+    bool operator==(const InternedName& other) const = default;
+
+private:
+    explicit InternedName(const std::string* name);
+
+    const std::string* name_ = nullptr;
+};
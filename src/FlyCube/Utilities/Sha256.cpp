@@ -0,0 +1,95 @@
+#include "Utilities/Sha256.h"
+
+#include <bit>
+#include <cstring>
+
+namespace {
+
+constexpr std::array<uint32_t, 64> kRoundConstants = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+void ProcessBlock(std::array<uint32_t, 8>& state, const uint8_t* block)
+{
+    std::array<uint32_t, 64> w = {};
+    for (size_t i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) | (uint32_t(block[i * 4 + 2]) << 8) |
+               uint32_t(block[i * 4 + 3]);
+    }
+    for (size_t i = 16; i < 64; ++i) {
+        uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state;
+    for (size_t i = 0; i < 64; ++i) {
+        uint32_t s1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + s1 + ch + kRoundConstants[i] + w[i];
+        uint32_t s0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+} // namespace
+
+Sha256Digest Sha256(std::span<const uint8_t> data)
+{
+    std::array<uint32_t, 8> state = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    size_t full_blocks = data.size() / 64;
+    for (size_t i = 0; i < full_blocks; ++i) {
+        ProcessBlock(state, data.data() + i * 64);
+    }
+
+    // The tail is padded with 0x80, zeros and the message length in bits, which may spill into a second block.
+    std::array<uint8_t, 128> tail = {};
+    size_t tail_size = data.size() - full_blocks * 64;
+    if (tail_size) {
+        std::memcpy(tail.data(), data.data() + full_blocks * 64, tail_size);
+    }
+    tail[tail_size] = 0x80;
+    size_t padded_size = tail_size < 56 ? 64 : 128;
+    uint64_t bit_count = uint64_t(data.size()) * 8;
+    for (size_t i = 0; i < 8; ++i) {
+        tail[padded_size - 1 - i] = static_cast<uint8_t>(bit_count >> (i * 8));
+    }
+    for (size_t offset = 0; offset < padded_size; offset += 64) {
+        ProcessBlock(state, tail.data() + offset);
+    }
+
+    Sha256Digest digest = {};
+    for (size_t i = 0; i < state.size(); ++i) {
+        digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
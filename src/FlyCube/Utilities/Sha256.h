@@ -0,0 +1,9 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+
+using Sha256Digest = std::array<uint8_t, 32>;
+
+// FIPS 180-4 SHA-256, for identifying data where a 64-bit hash collision must not go unnoticed.
+Sha256Digest Sha256(std::span<const uint8_t> data);
@@ -4,6 +4,7 @@
 #include <Windows.h>
 #elif defined(__APPLE__)
 #include <mach-o/dyld.h>
+#include <unistd.h>
 #else
 #include <linux/limits.h>
 #include <stdlib.h>
@@ -12,6 +13,9 @@
 
 #include <nowide/convert.hpp>
 
+#include <atomic>
+#include <format>
+#include <random>
 #include <vector>
 
 std::string GetExecutablePath()
@@ -65,3 +69,19 @@ std::string GetEnvironmentVar(const std::string& name)
     return res ? res : "";
 #endif
 }
+
+uint32_t GetCurrentProcessIdentifier()
+{
+#if defined(_WIN32)
+    return GetCurrentProcessId();
+#else
+    return getpid();
+#endif
+}
+
+std::string GetTempFilePath(const std::string& path)
+{
+    static const uint32_t seed = std::random_device{}();
+    static std::atomic<uint32_t> counter = 0;
+    return std::format("{}.{}.{:08x}.{}.tmp", path, GetCurrentProcessIdentifier(), seed, counter++);
+}
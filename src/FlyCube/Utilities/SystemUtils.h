@@ -1,6 +1,10 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 std::string GetExecutablePath();
 std::string GetExecutableDir();
 std::string GetEnvironmentVar(const std::string& name);
+uint32_t GetCurrentProcessIdentifier();
+// Sibling of path that is unique per process and call, for writing a file before renaming it over path.
+std::string GetTempFilePath(const std::string& path);
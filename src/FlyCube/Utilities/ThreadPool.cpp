@@ -0,0 +1,73 @@
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t thread_count)
+{
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads_.reserve(thread_count);
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    task_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    task_cv_.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock lock(mutex_);
+    idle_cv_.wait(lock, [&] { return tasks_.empty() && active_tasks_ == 0; });
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+    return threads_.size();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            task_cv_.wait(lock, [&] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++active_tasks_;
+        }
+
+        task();
+
+        {
+            std::lock_guard lock(mutex_);
+            --active_tasks_;
+            if (tasks_.empty() && active_tasks_ == 0) {
+                idle_cv_.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(uint32_t thread_count = 0);
+    ~ThreadPool();
+
+    void Enqueue(std::function<void()> task);
+    void WaitIdle();
+    uint32_t GetThreadCount() const;
+
+    template <typename Fn>
+    std::future<std::invoke_result_t<Fn>> Submit(Fn&& fn)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::forward<Fn>(fn));
+        auto future = task->get_future();
+        Enqueue([task] { (*task)(); });
+        return future;
+    }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable idle_cv_;
+    uint32_t active_tasks_ = 0;
+    bool stop_ = false;
+};
@@ -0,0 +1,142 @@
+#include "Utilities/Trace.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr size_t kRingBufferSize = 1 << 16;
+
+struct Record {
+    std::atomic<const char*> name = nullptr;
+    std::atomic<uint64_t> start = 0;
+    std::atomic<uint64_t> duration = 0;
+};
+
+struct ThreadRingBuffer {
+    uint32_t thread_id = 0;
+    std::atomic<uint64_t> head = 0;
+    std::array<Record, kRingBufferSize> records;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRingBuffer>> buffers;
+};
+
+Registry& GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+ThreadRingBuffer& GetThreadRingBuffer()
+{
+    thread_local std::shared_ptr<ThreadRingBuffer> buffer = [] {
+        auto buffer = std::make_shared<ThreadRingBuffer>();
+        auto& registry = GetRegistry();
+        std::lock_guard lock(registry.mutex);
+        buffer->thread_id = registry.buffers.size();
+        registry.buffers.push_back(buffer);
+        return buffer;
+    }();
+    return *buffer;
+}
+
+std::string EscapeJson(const char* str)
+{
+    std::string res;
+    for (; *str; ++str) {
+        switch (*str) {
+        case '"':
+            res += "\\\"";
+            break;
+        case '\\':
+            res += "\\\\";
+            break;
+        default:
+            res += *str;
+            break;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+namespace Trace {
+
+uint64_t GetTimestamp()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void AddEvent(const char* name, uint64_t start, uint64_t duration)
+{
+    auto& buffer = GetThreadRingBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    auto& record = buffer.records[head % kRingBufferSize];
+    record.name.store(name, std::memory_order_relaxed);
+    record.start.store(start, std::memory_order_relaxed);
+    record.duration.store(duration, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+std::string GetChromeTraceJson()
+{
+    std::vector<std::shared_ptr<ThreadRingBuffer>> buffers;
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+
+    std::string json = "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = head > kRingBufferSize ? head - kRingBufferSize : 0;
+        std::vector<std::tuple<const char*, uint64_t, uint64_t>> records;
+        records.reserve(head - begin);
+        for (uint64_t i = begin; i < head; ++i) {
+            const auto& record = buffer->records[i % kRingBufferSize];
+            records.emplace_back(record.name.load(std::memory_order_relaxed),
+                                 record.start.load(std::memory_order_relaxed),
+                                 record.duration.load(std::memory_order_relaxed));
+        }
+        // Records that the owning thread may have overwritten while they were being copied are dropped.
+        uint64_t new_head = buffer->head.load(std::memory_order_acquire) + 1;
+        size_t skip = new_head > begin + kRingBufferSize ? new_head - begin - kRingBufferSize : 0;
+        for (size_t i = skip; i < records.size(); ++i) {
+            const auto& [name, start, duration] = records[i];
+            if (!first) {
+                json += ",";
+            }
+            first = false;
+            json += std::format(R"({{"name":"{}","ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                                EscapeJson(name), buffer->thread_id, start / 1000.0, duration / 1000.0);
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+bool WriteChromeTrace(const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file << GetChromeTraceJson();
+    return file.good();
+}
+
+} // namespace Trace
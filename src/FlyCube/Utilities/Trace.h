@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Trace {
+
+uint64_t GetTimestamp();
+void AddEvent(const char* name, uint64_t start, uint64_t duration);
+std::string GetChromeTraceJson();
+bool WriteChromeTrace(const std::string& path);
+
+class ScopedEvent {
+public:
+    explicit ScopedEvent(const char* name)
+        : name_(name)
+        , start_(GetTimestamp())
+    {
+    }
+
+    ~ScopedEvent()
+    {
+        AddEvent(name_, start_, GetTimestamp() - start_);
+    }
+
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#if defined(ENABLE_TRACING)
+#define TRACE_SCOPE(name) Trace::ScopedEvent TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
@@ -0,0 +1,49 @@
+#include "Utilities/ThreadPool.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+
+TEST_CASE("ThreadPool uses at least one thread")
+{
+    ThreadPool thread_pool;
+    CHECK(thread_pool.GetThreadCount() >= 1);
+    CHECK(ThreadPool(3).GetThreadCount() == 3);
+}
+
+TEST_CASE("ThreadPool::Submit returns the task result")
+{
+    ThreadPool thread_pool(2);
+    auto future = thread_pool.Submit([] { return 42; });
+    CHECK(future.get() == 42);
+}
+
+TEST_CASE("ThreadPool::WaitIdle waits for every task")
+{
+    constexpr size_t kTaskCount = 1000;
+    std::atomic<size_t> done = 0;
+    ThreadPool thread_pool(4);
+    for (size_t i = 0; i < kTaskCount; ++i) {
+        thread_pool.Enqueue([&] { ++done; });
+    }
+    thread_pool.WaitIdle();
+    CHECK(done == kTaskCount);
+
+    // The pool is reusable after it went idle.
+    thread_pool.Enqueue([&] { ++done; });
+    thread_pool.WaitIdle();
+    CHECK(done == kTaskCount + 1);
+}
+
+TEST_CASE("ThreadPool runs the queued tasks before it is destroyed")
+{
+    constexpr size_t kTaskCount = 100;
+    std::atomic<size_t> done = 0;
+    {
+        ThreadPool thread_pool(1);
+        for (size_t i = 0; i < kTaskCount; ++i) {
+            thread_pool.Enqueue([&] { ++done; });
+        }
+    }
+    CHECK(done == kTaskCount);
+}
@@ -1,13 +1,28 @@
 #include "HLSLCompiler/Compiler.h"
+#include "HLSLCompiler/MSLConverter.h"
+#include "HLSLCompiler/ShaderCache.h"
+#include "HLSLCompiler/ShaderPermutations.h"
 #include "Instance/BaseTypes.h"
+#include "Shader/ShaderBundle.h"
+#include "ShaderReflection/BindingHeader.h"
+#include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/ThreadPool.h"
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <map>
+#include <optional>
+#include <set>
+#include <string_view>
 
 namespace {
 
-ShaderType GetShaderType(const std::string& target)
+std::optional<ShaderType> GetShaderType(const std::string& target)
 {
     if (target == "Pixel") {
         return ShaderType::kPixel;
@@ -24,37 +39,357 @@ ShaderType GetShaderType(const std::string& target)
     } else if (target == "Library") {
         return ShaderType::kLibrary;
     }
-    NOTREACHED();
+    return {};
 }
 
-std::string GetShaderExtension(ShaderBlobType shader_type)
+std::optional<ShaderCompileProfile> GetShaderCompileProfile(std::string_view profile)
 {
-    switch (shader_type) {
-    case ShaderBlobType::kDXIL:
+    if (profile == "debug") {
+        return ShaderCompileProfile::kDebug;
+    } else if (profile == "release") {
+        return ShaderCompileProfile::kRelease;
+    } else if (profile == "size") {
+        return ShaderCompileProfile::kSize;
+    }
+    return {};
+}
+
+enum class OutputTarget {
+    kDXIL,
+    kSPIRV,
+    // MSL source with its binding mapping, generated from the SPIR-V blob.
+    kMSL,
+};
+
+std::optional<OutputTarget> GetOutputTarget(const std::string& target)
+{
+    if (target == "dxil") {
+        return OutputTarget::kDXIL;
+    } else if (target == "spirv") {
+        return OutputTarget::kSPIRV;
+    } else if (target == "msl") {
+        return OutputTarget::kMSL;
+    }
+    return {};
+}
+
+std::optional<uint32_t> ParseThreadCount(std::string_view value)
+{
+    uint32_t thread_count = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), thread_count);
+    if (ec != std::errc() || ptr != value.data() + value.size() || thread_count == 0) {
+        return {};
+    }
+    return thread_count;
+}
+
+ShaderBlobType GetShaderBlobType(OutputTarget target)
+{
+    return target == OutputTarget::kDXIL ? ShaderBlobType::kDXIL : ShaderBlobType::kSPIRV;
+}
+
+std::string GetShaderExtension(OutputTarget target)
+{
+    switch (target) {
+    case OutputTarget::kDXIL:
         return ".dxil";
-    case ShaderBlobType::kSPIRV:
+    case OutputTarget::kSPIRV:
         return ".spirv";
+    case OutputTarget::kMSL:
+        return ".msl";
     default:
         NOTREACHED();
     }
 }
 
-void CompileShader(const std::string& shader_name,
-                   const ShaderDesc& desc,
-                   const std::string& output_path,
-                   ShaderBlobType shader_type)
+struct ShaderEntry {
+    std::string name;
+    ShaderDesc desc;
+    std::vector<OutputTarget> targets;
+    std::vector<std::string> keywords;
+};
+
+std::vector<std::string> Tokenize(const std::string& line)
+{
+    std::vector<std::string> tokens;
+    std::optional<std::string> token;
+    bool quoted = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            token = token.value_or("");
+        } else if (!quoted && (c == ' ' || c == '\t' || c == '\r')) {
+            if (token) {
+                tokens.push_back(std::move(*token));
+                token.reset();
+            }
+        } else {
+            token = token.value_or("") + c;
+        }
+    }
+    if (token) {
+        tokens.push_back(std::move(*token));
+    }
+    return tokens;
+}
+
+// Each non-empty line not starting with '#' describes one shader:
+// <name> <path> <entrypoint> <type> <model> [targets=dxil,spirv,msl] [keywords=A,B] [profile=debug|release|size]
+// [-D<define>[=<value>]...]
+// Relative paths are resolved against the manifest directory. Use "" for an empty entrypoint.
+// Shaders with keywords are written as a permutation table <name>.perm.<target> covering every combination.
+std::optional<std::vector<ShaderEntry>> ParseManifest(const std::string& manifest_path, ShaderCompileProfile profile)
 {
-    std::string path = output_path + "/" + shader_name + GetShaderExtension(shader_type);
-    std::vector<uint8_t> blob = Compile(desc, shader_type);
-    if (blob.empty()) {
-        exit(~0);
+    std::ifstream file(manifest_path);
+    if (!file) {
+        Logging::Println("{}: failed to open manifest", manifest_path);
+        return {};
+    }
+
+    std::filesystem::path manifest_dir = std::filesystem::path(manifest_path).parent_path();
+    std::vector<ShaderEntry> entries;
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number) {
+        std::vector<std::string> tokens = Tokenize(line);
+        if (tokens.empty() || tokens.front().starts_with("#")) {
+            continue;
+        }
+
+        auto report_error = [&](std::string_view message) {
+            Logging::Println("{}:{}: {}", manifest_path, line_number, message);
+        };
+        if (tokens.size() < 5) {
+            report_error("expected <name> <path> <entrypoint> <type> <model>");
+            return {};
+        }
+
+        ShaderEntry& entry = entries.emplace_back();
+        entry.name = tokens[0];
+        entry.desc.shader_path = (manifest_dir / tokens[1]).lexically_normal().string();
+        entry.desc.entrypoint = tokens[2];
+        auto shader_type = GetShaderType(tokens[3]);
+        if (!shader_type) {
+            report_error("unknown shader type " + tokens[3]);
+            return {};
+        }
+        entry.desc.type = *shader_type;
+        entry.desc.model = tokens[4];
+        entry.desc.profile = profile;
+
+        for (size_t i = 5; i < tokens.size(); ++i) {
+            std::string_view token = tokens[i];
+            if (token.starts_with("targets=")) {
+                token.remove_prefix(std::string_view("targets=").size());
+                while (!token.empty()) {
+                    size_t pos = std::min(token.find(','), token.size());
+                    auto target = GetOutputTarget(std::string(token.substr(0, pos)));
+                    if (!target) {
+                        report_error("unknown target " + std::string(token.substr(0, pos)));
+                        return {};
+                    }
+                    entry.targets.push_back(*target);
+                    token.remove_prefix(std::min(pos + 1, token.size()));
+                }
+            } else if (token.starts_with("keywords=")) {
+                token.remove_prefix(std::string_view("keywords=").size());
+                while (!token.empty()) {
+                    size_t pos = std::min(token.find(','), token.size());
+                    entry.keywords.emplace_back(token.substr(0, pos));
+                    token.remove_prefix(std::min(pos + 1, token.size()));
+                }
+            } else if (token.starts_with("profile=")) {
+                auto entry_profile = GetShaderCompileProfile(token.substr(std::string_view("profile=").size()));
+                if (!entry_profile) {
+                    report_error("unknown profile " + tokens[i]);
+                    return {};
+                }
+                entry.desc.profile = *entry_profile;
+            } else if (token.starts_with("-D")) {
+                token.remove_prefix(2);
+                size_t pos = token.find('=');
+                if (pos == std::string_view::npos) {
+                    entry.desc.define[std::string(token)] = "";
+                } else {
+                    entry.desc.define[std::string(token.substr(0, pos))] = token.substr(pos + 1);
+                }
+            } else {
+                report_error("unexpected argument " + tokens[i]);
+                return {};
+            }
+        }
+        if (entry.targets.empty()) {
+            entry.targets = { OutputTarget::kDXIL, OutputTarget::kSPIRV };
+        }
+        bool has_msl_target =
+            std::find(entry.targets.begin(), entry.targets.end(), OutputTarget::kMSL) != entry.targets.end();
+        if (has_msl_target && (entry.desc.type == ShaderType::kLibrary || !entry.keywords.empty())) {
+            report_error("msl target does not support Library shaders or keywords");
+            return {};
+        }
     }
-    std::fstream file(path, std::ios::out | std::ios::binary);
-    file.write(reinterpret_cast<char*>(blob.data()), blob.size());
+    return entries;
+}
+
+struct CompileJob {
+    const ShaderEntry* entry;
+    OutputTarget target;
+    std::string output_path;
+    bool succeeded;
+    CompileReport report;
+    // Kept for the bundle and binding headers, permutation tables and MSL are not bundled.
+    std::vector<uint8_t> blob;
+};
+
+bool CompileShaders(const std::vector<ShaderEntry>& entries,
+                    const std::string& output_dir,
+                    const std::string& depfile_path,
+                    const std::string& bundle_path,
+                    bool generate_headers,
+                    uint32_t thread_count,
+                    bool print_summary)
+{
+    std::vector<CompileJob> jobs;
+    for (const auto& entry : entries) {
+        for (auto target : entry.targets) {
+            std::string output_path =
+                output_dir + "/" + entry.name + (entry.keywords.empty() ? "" : ".perm") + GetShaderExtension(target);
+            jobs.push_back({ &entry, target, output_path, false, {}, {} });
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t pool_size = std::max<size_t>(std::min<size_t>(thread_count, jobs.size()), 1);
+    {
+        // Permutation tables compile on their own pool, split the threads so the total stays at thread_count.
+        uint32_t permutation_thread_count = std::max(thread_count / pool_size, 1u);
+        ThreadPool thread_pool(pool_size);
+        for (auto& job : jobs) {
+            thread_pool.Enqueue([&job, permutation_thread_count, keep_blob = !bundle_path.empty() || generate_headers] {
+                std::error_code ec;
+                ShaderBlobType blob_type = GetShaderBlobType(job.target);
+                if (!job.entry->keywords.empty()) {
+                    auto table = CompilePermutations({ job.entry->desc, job.entry->keywords }, blob_type, {},
+                                                     permutation_thread_count, &job.report);
+                    if (!table) {
+                        return;
+                    }
+                    std::filesystem::create_directories(std::filesystem::path(job.output_path).parent_path(), ec);
+                    job.succeeded = table->Save(job.output_path);
+                    if (!job.succeeded) {
+                        job.report.errors = "failed to write " + job.output_path;
+                    }
+                    return;
+                }
+
+                std::vector<uint8_t> blob = Compile(job.entry->desc, blob_type, &job.report);
+                if (blob.empty()) {
+                    return;
+                }
+                if (job.target == OutputTarget::kMSL) {
+                    blob = GenerateOfflineMSLShader(job.entry->desc.type, blob);
+                } else if (keep_blob) {
+                    job.blob = blob;
+                }
+                std::filesystem::create_directories(std::filesystem::path(job.output_path).parent_path(), ec);
+                std::fstream file(job.output_path, std::ios::out | std::ios::binary);
+                file.write(reinterpret_cast<char*>(blob.data()), blob.size());
+                job.succeeded = !!file;
+                if (!job.succeeded) {
+                    job.report.errors = "failed to write " + job.output_path;
+                    return;
+                }
+
+                if (!job.report.debug_info.empty()) {
+                    std::string debug_info_name = job.report.debug_info_name;
+                    if (debug_info_name.empty()) {
+                        debug_info_name = job.entry->name + ".pdb";
+                    }
+                    std::string debug_info_path =
+                        (std::filesystem::path(job.output_path).parent_path() / debug_info_name).string();
+                    std::fstream debug_info_file(debug_info_path, std::ios::out | std::ios::binary);
+                    debug_info_file.write(reinterpret_cast<char*>(job.report.debug_info.data()),
+                                          job.report.debug_info.size());
+                }
+            });
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::string> outputs;
+    std::set<std::string> dependencies;
+    size_t failed = 0;
+    for (const auto& job : jobs) {
+        if (!job.succeeded) {
+            ++failed;
+            Logging::Println("error: {} ({}): {}", job.entry->name, GetShaderExtension(job.target).substr(1),
+                             job.entry->desc.shader_path);
+            Logging::Println("{}", job.report.errors);
+            continue;
+        }
+        outputs.push_back(job.output_path);
+        dependencies.insert(job.report.dependencies.begin(), job.report.dependencies.end());
+    }
+
+    if (print_summary) {
+        Logging::Println("Compiled {} of {} shader blobs in {:.2f} s ({:.1f} shaders/sec, {} threads)",
+                         jobs.size() - failed, jobs.size(), elapsed.count(), jobs.size() / elapsed.count(),
+                         pool_size);
+    }
+    if (failed) {
+        Logging::Println("{} shader blobs failed to compile", failed);
+        return false;
+    }
+
+    if (!bundle_path.empty()) {
+        ShaderBundleWriter bundle;
+        for (const auto& job : jobs) {
+            if (!job.blob.empty()) {
+                bundle.AddShader(job.entry->name, job.entry->desc.type, GetShaderBlobType(job.target), job.blob);
+            }
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(bundle_path).parent_path(), ec);
+        if (!bundle.Save(bundle_path)) {
+            Logging::Println("error: failed to write {}", bundle_path);
+            return false;
+        }
+        outputs.push_back(bundle_path);
+    }
+
+    if (generate_headers) {
+        // SPIR-V reflection is preferred since it provides variable layouts on every host.
+        std::map<const ShaderEntry*, const CompileJob*> header_jobs;
+        for (const auto& job : jobs) {
+            if (!job.blob.empty() && (!header_jobs.contains(job.entry) || job.target == OutputTarget::kSPIRV)) {
+                header_jobs[job.entry] = &job;
+            }
+        }
+        for (const auto& [entry, job] : header_jobs) {
+            auto reflection =
+                CreateShaderReflection(GetShaderBlobType(job->target), job->blob.data(), job->blob.size());
+            std::string header_path = output_dir + "/" + entry->name + ".h";
+            std::ofstream file(header_path, std::ios::binary | std::ios::trunc);
+            file << GenerateBindingHeader(entry->name, entry->desc.type, *reflection);
+            if (!file) {
+                Logging::Println("error: failed to write {}", header_path);
+                return false;
+            }
+            outputs.push_back(header_path);
+        }
+    }
+
+    WriteDepfile(depfile_path, outputs, { dependencies.begin(), dependencies.end() });
+    return true;
 }
 
 } // namespace
 
+// Usage:
+//   ShaderCompilerCLI <name> <path> <entrypoint> <type> <model> <output_dir>
+//   ShaderCompilerCLI --manifest <file> [-j <threads>] [--depfile <file>] [--profile <profile>]
+//                     [--bundle <file>] [--header] <output_dir>
+// --bundle additionally packs every DXIL/SPIR-V blob with its reflection into one file for ShaderBundle.
+// --header writes <name>.h with constexpr BindKeys, input locations and constant buffer structs per shader.
 class ParseCmd {
 public:
     ParseCmd(int argc, char* argv[])
@@ -65,22 +400,84 @@ public:
             assert(arg_index < argc);
             return argv[arg_index];
         };
-        shader_name_ = get_next_arg();
-        desc_.shader_path = get_next_arg();
-        desc_.entrypoint = get_next_arg();
-        desc_.type = GetShaderType(get_next_arg());
-        desc_.model = get_next_arg();
+        auto report_error = [&](const std::string& message) {
+            Logging::Println("error: {}", message);
+            Logging::Println("usage: ShaderCompilerCLI <name> <path> <entrypoint> <type> <model> <output_dir>");
+            Logging::Println("       ShaderCompilerCLI --manifest <file> [-j <threads>] [--depfile <file>] "
+                             "[--profile debug|release|size] [--bundle <file>] [--header] <output_dir>");
+            valid_ = false;
+        };
+
+        if (argc > 1 && argv[1][0] == '-') {
+            while (arg_index + 1 < static_cast<size_t>(argc)) {
+                std::string_view arg = get_next_arg();
+                if (arg == "--manifest") {
+                    manifest_path_ = get_next_arg();
+                } else if (arg == "--depfile") {
+                    depfile_path_ = get_next_arg();
+                } else if (arg == "--bundle") {
+                    bundle_path_ = get_next_arg();
+                } else if (arg == "--header") {
+                    generate_headers_ = true;
+                } else if (arg == "--profile") {
+                    std::string value = get_next_arg();
+                    auto profile = GetShaderCompileProfile(value);
+                    if (!profile) {
+                        report_error("unknown profile " + value);
+                        return;
+                    }
+                    profile_ = *profile;
+                } else if (arg.starts_with("-j")) {
+                    std::string value = arg == "-j" ? get_next_arg() : std::string(arg.substr(2));
+                    auto thread_count = ParseThreadCount(value);
+                    if (!thread_count) {
+                        report_error("invalid thread count " + value);
+                        return;
+                    }
+                    thread_count_ = *thread_count;
+                } else {
+                    output_dir_ = arg;
+                }
+            }
+            if (depfile_path_.empty()) {
+                depfile_path_ = output_dir_ + "/" + std::filesystem::path(manifest_path_).stem().string() + ".d";
+            }
+            return;
+        }
+
+        ShaderEntry& entry = entries_.emplace_back();
+        entry.name = get_next_arg();
+        entry.desc.shader_path = get_next_arg();
+        entry.desc.entrypoint = get_next_arg();
+        auto shader_type = GetShaderType(get_next_arg());
+        if (!shader_type) {
+            NOTREACHED();
+        }
+        entry.desc.type = *shader_type;
+        entry.desc.model = get_next_arg();
+        entry.targets = { OutputTarget::kDXIL, OutputTarget::kSPIRV };
         output_dir_ = get_next_arg();
+        depfile_path_ = output_dir_ + "/" + entry.name + ".d";
+    }
+
+    bool IsValid() const
+    {
+        return valid_;
+    }
+
+    bool IsManifestMode() const
+    {
+        return !manifest_path_.empty();
     }
 
-    const std::string& GetShaderName() const
+    const std::string& GetManifestPath() const
     {
-        return shader_name_;
+        return manifest_path_;
     }
 
-    const ShaderDesc& GetShaderDesc() const
+    const std::vector<ShaderEntry>& GetEntries() const
     {
-        return desc_;
+        return entries_;
     }
 
     const std::string& GetOutputDir() const
@@ -88,16 +485,61 @@ public:
         return output_dir_;
     }
 
+    const std::string& GetDepfilePath() const
+    {
+        return depfile_path_;
+    }
+
+    const std::string& GetBundlePath() const
+    {
+        return bundle_path_;
+    }
+
+    bool GetGenerateHeaders() const
+    {
+        return generate_headers_;
+    }
+
+    uint32_t GetThreadCount() const
+    {
+        return thread_count_;
+    }
+
+    ShaderCompileProfile GetProfile() const
+    {
+        return profile_;
+    }
+
 private:
-    std::string shader_name_;
-    ShaderDesc desc_;
+    bool valid_ = true;
+    std::string manifest_path_;
+    std::vector<ShaderEntry> entries_;
     std::string output_dir_;
+    std::string depfile_path_;
+    std::string bundle_path_;
+    bool generate_headers_ = false;
+    uint32_t thread_count_ = std::max(std::thread::hardware_concurrency(), 1u);
+    ShaderCompileProfile profile_ = ShaderCompileProfile::kDebug;
 };
 
 int main(int argc, char* argv[])
 {
     ParseCmd cmd(argc, argv);
-    CompileShader(cmd.GetShaderName(), cmd.GetShaderDesc(), cmd.GetOutputDir(), ShaderBlobType::kDXIL);
-    CompileShader(cmd.GetShaderName(), cmd.GetShaderDesc(), cmd.GetOutputDir(), ShaderBlobType::kSPIRV);
+    if (!cmd.IsValid()) {
+        return ~0;
+    }
+    std::vector<ShaderEntry> entries = cmd.GetEntries();
+    if (cmd.IsManifestMode()) {
+        auto manifest_entries = ParseManifest(cmd.GetManifestPath(), cmd.GetProfile());
+        if (!manifest_entries) {
+            return ~0;
+        }
+        entries = std::move(*manifest_entries);
+    }
+
+    if (!CompileShaders(entries, cmd.GetOutputDir(), cmd.GetDepfilePath(), cmd.GetBundlePath(),
+                        cmd.GetGenerateHeaders(), cmd.GetThreadCount(), cmd.IsManifestMode())) {
+        return ~0;
+    }
     return 0;
 }
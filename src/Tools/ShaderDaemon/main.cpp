@@ -0,0 +1,63 @@
+#include "HLSLCompiler/ShaderServer.h"
+#include "Utilities/Logging.h"
+
+#include <atomic>
+#include <charconv>
+#include <csignal>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::atomic<bool> g_stop = false;
+
+void HandleSignal(int)
+{
+    g_stop = true;
+}
+
+std::optional<uint32_t> ParseThreadCount(std::string_view value)
+{
+    uint32_t thread_count = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), thread_count);
+    if (ec != std::errc() || ptr != value.data() + value.size() || thread_count == 0) {
+        return {};
+    }
+    return thread_count;
+}
+
+} // namespace
+
+// Usage:
+//   flycube-shaderd [--socket <path>] [-j <threads>]
+int main(int argc, char* argv[])
+{
+    std::string socket_path = GetShaderServerSocketPath();
+    uint32_t thread_count = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        std::optional<uint32_t> parsed_thread_count;
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+            continue;
+        } else if (arg == "-j" && i + 1 < argc) {
+            parsed_thread_count = ParseThreadCount(argv[++i]);
+        } else if (arg.starts_with("-j")) {
+            parsed_thread_count = ParseThreadCount(arg.substr(2));
+        }
+        if (!parsed_thread_count) {
+            Logging::Println("usage: flycube-shaderd [--socket <path>] [-j <threads>]");
+            return ~0;
+        }
+        thread_count = *parsed_thread_count;
+    }
+
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+    if (!RunShaderServer(socket_path, thread_count, g_stop)) {
+        return ~0;
+    }
+    return 0;
+}